@@ -0,0 +1,72 @@
+#include <random>
+#include <string>
+#include <vector>
+#include "market_data/binance_parser.hpp"
+#include "bench_util.hpp"
+
+using namespace arb;
+
+/**
+ * Binance bookTicker / trade parsing: the on-demand scanner versus the
+ * nlohmann DOM path it replaces, over a rotating set of realistic frames.
+ */
+
+namespace {
+
+std::vector<std::string> make_book_tickers(int n) {
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<int> cents(0, 99);
+    std::uniform_int_distribution<int> qty(1, 500000);
+    std::vector<std::string> msgs;
+    for (int i = 0; i < n; ++i) {
+        int bid = 4200000 + cents(gen);
+        std::string b = std::to_string(bid / 100) + "." + std::to_string(100 + bid % 100).substr(1) + "000000";
+        std::string a = std::to_string((bid + 1) / 100) + "." + std::to_string(100 + (bid + 1) % 100).substr(1) + "000000";
+        msgs.push_back("{\"u\":" + std::to_string(40090021700LL + i) + ",\"s\":\"BTCUSDT\",\"b\":\"" + b +
+                       "\",\"B\":\"" + std::to_string(qty(gen) / 100000.0) + "\",\"a\":\"" + a +
+                       "\",\"A\":\"" + std::to_string(qty(gen) / 100000.0) + "\"}");
+    }
+    return msgs;
+}
+
+std::vector<std::string> make_trades(int n) {
+    std::vector<std::string> msgs;
+    for (int i = 0; i < n; ++i) {
+        msgs.push_back("{\"e\":\"trade\",\"E\":1672515782136,\"s\":\"BTCUSDT\",\"t\":" +
+                       std::to_string(3000000000LL + i) + ",\"p\":\"42000.1" + std::to_string(i % 10) +
+                       "000000\",\"q\":\"0.00150000\",\"T\":1672515782136,\"m\":true,\"M\":true}");
+    }
+    return msgs;
+}
+
+template <typename Parse>
+void bench_parse(const std::string& name, const std::vector<std::string>& msgs, Parse parse) {
+    BinanceTick tick;
+    bench::run(name, 2'000'000, [&](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            parse(msgs[static_cast<size_t>(i) % msgs.size()], tick);
+            bench::do_not_optimize(tick.bid);
+            bench::do_not_optimize(tick.price);
+        }
+    });
+}
+
+} // namespace
+
+int main() {
+    std::printf("Binance message parse benchmark\n\n");
+    auto tickers = make_book_tickers(1024);
+    auto trades = make_trades(1024);
+    FixedScale scale = FixedScale::from_decimals(2);
+
+    auto fast = [](std::string_view m, BinanceTick& t) { return parse_binance_message(m, nullptr, t); };
+    auto fast_fixed = [&](std::string_view m, BinanceTick& t) { return parse_binance_message(m, &scale, t); };
+    auto dom = [](std::string_view m, BinanceTick& t) { return parse_binance_message_json(m, nullptr, t); };
+
+    bench_parse("bookTicker on-demand", tickers, fast);
+    bench_parse("bookTicker on-demand (fixed-point)", tickers, fast_fixed);
+    bench_parse("bookTicker nlohmann", tickers, dom);
+    bench_parse("trade on-demand", trades, fast);
+    bench_parse("trade nlohmann", trades, dom);
+    return 0;
+}
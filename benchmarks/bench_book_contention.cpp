@@ -0,0 +1,106 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "market_data/order_book.hpp"
+#include "bench_util.hpp"
+
+using namespace arb;
+
+/**
+ * One feed writer vs N strategy readers on a single OrderBook.
+ * The writer applies updates as fast as it can while readers run the
+ * per-iteration S2 query set, either through the mutex (best_bid, best_ask,
+ * spread, depth) or through one lock-free top_of_book() call.
+ */
+
+namespace {
+
+constexpr auto kRunTime = std::chrono::milliseconds(500);
+
+struct Result {
+    double writer_ops_per_sec;
+    double reader_ops_per_sec;  // Summed over all readers
+};
+
+template <typename ReadFn>
+Result run_contention(int readers, ReadFn&& read) {
+    OrderBook book("BENCH", 10, OrderBookImpl::TICK_ARRAY);
+    for (int t = 1; t <= 10; ++t) {
+        book.update_bid((50 - t) / 100.0, 100.0);
+        book.update_ask((50 + t) / 100.0, 100.0);
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<int64_t> reads{0};
+    int64_t writes = 0;
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&]() {
+            int64_t local = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                read(book);
+                ++local;
+            }
+            reads += local;
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread writer([&]() {
+        int i = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            int tick = 41 + (i % 9);
+            book.update_bid(tick / 100.0, static_cast<double>(1 + i % 500));
+            ++writes;
+            ++i;
+        }
+    });
+
+    std::this_thread::sleep_for(kRunTime);
+    stop = true;
+    writer.join();
+    for (auto& t : threads) t.join();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return {static_cast<double>(writes) / secs, static_cast<double>(reads.load()) / secs};
+}
+
+void locked_read(const OrderBook& book) {
+    auto bid = book.best_bid();
+    auto ask = book.best_ask();
+    Price spread = book.spread();
+    Size depth = book.ask_depth(10);
+    bench::do_not_optimize(bid);
+    bench::do_not_optimize(ask);
+    bench::do_not_optimize(spread);
+    bench::do_not_optimize(depth);
+}
+
+void seqlock_read(const OrderBook& book) {
+    TopOfBook top = book.top_of_book();
+    Price spread = top.spread();
+    bench::do_not_optimize(top);
+    bench::do_not_optimize(spread);
+}
+
+} // namespace
+
+int main() {
+    std::printf("OrderBook contention benchmark (1 writer, %lld ms per run)\n\n",
+                static_cast<long long>(kRunTime.count()));
+    std::printf("%-10s %8s %16s %16s\n", "path", "readers", "writer ops/s", "reader ops/s");
+
+    for (int readers : {1, 2, 4, 8}) {
+        Result locked = run_contention(readers, locked_read);
+        std::printf("%-10s %8d %16.0f %16.0f\n", "mutex", readers,
+                    locked.writer_ops_per_sec, locked.reader_ops_per_sec);
+
+        Result seqlock = run_contention(readers, seqlock_read);
+        std::printf("%-10s %8d %16.0f %16.0f\n", "seqlock", readers,
+                    seqlock.writer_ops_per_sec, seqlock.reader_ops_per_sec);
+    }
+    return 0;
+}
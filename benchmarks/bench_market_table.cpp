@@ -0,0 +1,93 @@
+#include <memory>
+#include <random>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include "common/symbol_registry.hpp"
+#include "market_data/market_table.hpp"
+#include "strategy/strategy_base.hpp"
+#include "bench_util.hpp"
+
+using namespace arb;
+
+/**
+ * S2 screen across N markets: one MarketTable::scan_underpriced() pass versus
+ * the per-market snapshot + UnderpricingStrategy::evaluate() loop it replaces.
+ * About 1% of markets are underpriced.
+ */
+
+namespace {
+
+constexpr int64_t kFeeRate = POLYMARKET_FEE_RATE_PPM;
+
+struct Universe {
+    MarketTable table;
+    std::vector<std::unique_ptr<BinaryMarketBook>> books;
+};
+
+std::unique_ptr<Universe> make_universe(int markets) {
+    auto u = std::make_unique<Universe>();
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int> tick_dist(10, 90);
+    std::uniform_int_distribution<int> pct(0, 99);
+
+    for (int i = 0; i < markets; ++i) {
+        std::string id = "bench-table-" + std::to_string(markets) + "-" + std::to_string(i);
+        auto book = std::make_unique<BinaryMarketBook>(id, OrderBookImpl::TICK_ARRAY);
+
+        int yes_tick = tick_dist(gen);
+        int no_tick = 100 - yes_tick + (pct(gen) == 0 ? -6 : 1);  // 1% cross by 6c
+        Price yes_ask = yes_tick / 100.0;
+        Price no_ask = no_tick / 100.0;
+        book->yes_book().apply_snapshot({{yes_ask - 0.01, 50.0}}, {{yes_ask, 50.0}});
+        book->no_book().apply_snapshot({{no_ask - 0.01, 50.0}}, {{no_ask, 50.0}});
+
+        u->table.update(book->market_handle(), true, book->yes_book().top_of_book());
+        u->table.update(book->market_handle(), false, book->no_book().top_of_book());
+        u->books.push_back(std::move(book));
+    }
+    return u;
+}
+
+void bench_scan(const Universe& u, int markets) {
+    std::vector<MarketHandle> hits;
+    bench::run("scan_underpriced " + std::to_string(markets) + " markets",
+               markets >= 10'000 ? 2'000 : 20'000, [&](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            hits.clear();
+            u.table.scan_underpriced(kFeeRate, 2.0, hits);
+            bench::do_not_optimize(hits.data());
+        }
+    });
+    std::printf("  -> %zu candidates\n", hits.size());
+}
+
+void bench_evaluate_loop(const Universe& u, int markets) {
+    StrategyConfig config;
+    config.min_edge_cents = 2.0;
+    config.max_spread_to_trade = 0.05;
+    UnderpricingStrategy strategy(config);
+    BtcPrice btc;
+
+    bench::run("evaluate() loop " + std::to_string(markets) + " markets",
+               markets >= 10'000 ? 20 : 200, [&](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            for (const auto& book : u.books) {
+                auto signals = strategy.evaluate(*book, btc, now());
+                bench::do_not_optimize(signals.data());
+            }
+        }
+    });
+}
+
+} // namespace
+
+int main() {
+    spdlog::set_level(spdlog::level::off);  // evaluate() logs every signal
+    std::printf("Market table S2 screen benchmark\n\n");
+    for (int markets : {1'000, 10'000, 50'000}) {
+        auto u = make_universe(markets);
+        bench_scan(*u, markets);
+        bench_evaluate_loop(*u, markets);
+    }
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "market_data/order_book.hpp"
+#include "bench_util.hpp"
+
+using namespace arb;
+
+/**
+ * Map-based vs tick-array OrderBook throughput on a Polymarket-like stream:
+ * prices on the 0.01 grid clustered around a drifting mid, ~20% deletes.
+ */
+
+namespace {
+
+struct Update {
+    bool bid;
+    Price price;
+    Size size;
+};
+
+std::vector<Update> make_stream(size_t n) {
+    std::mt19937 gen(42);
+    std::normal_distribution<double> offset(0.0, 3.0);
+    std::uniform_real_distribution<double> size_dist(1.0, 500.0);
+    std::uniform_int_distribution<int> coin(0, 99);
+
+    std::vector<Update> stream;
+    stream.reserve(n);
+    int mid_tick = 50;
+    for (size_t i = 0; i < n; ++i) {
+        if (i % 1000 == 0) mid_tick = std::clamp(mid_tick + coin(gen) % 3 - 1, 10, 90);
+        bool bid = coin(gen) < 50;
+        int away = 1 + static_cast<int>(std::abs(offset(gen)));
+        int tick = std::clamp(bid ? mid_tick - away : mid_tick + away, 1, 99);
+        Size size = coin(gen) < 20 ? 0.0 : size_dist(gen);
+        stream.push_back({bid, tick / 100.0, size});
+    }
+    return stream;
+}
+
+void bench_impl(OrderBookImpl impl, const std::vector<Update>& stream) {
+    const std::string tag = order_book_impl_to_string(impl);
+    OrderBook book("BENCH", 10, impl);
+
+    bench::run(tag + " update_bid/update_ask", static_cast<int64_t>(stream.size()),
+               [&](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            const auto& u = stream[static_cast<size_t>(i) % stream.size()];
+            if (u.bid) book.update_bid(u.price, u.size);
+            else book.update_ask(u.price, u.size);
+        }
+    });
+
+    bench::run(tag + " best_bid+best_ask", 2'000'000, [&](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            auto bid = book.best_bid();
+            auto ask = book.best_ask();
+            bench::do_not_optimize(bid);
+            bench::do_not_optimize(ask);
+        }
+    });
+
+    bench::run(tag + " top_asks(5)", 1'000'000, [&](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            auto levels = book.top_asks(5);
+            bench::do_not_optimize(levels.data());
+        }
+    });
+
+    bench::run(tag + " total_depth(10)", 1'000'000, [&](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            Size depth = book.total_depth(10);
+            bench::do_not_optimize(depth);
+        }
+    });
+
+    bench::run(tag + " sweep(BUY, 250)", 1'000'000, [&](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            SweepQuote q = book.sweep(Side::BUY, 250.0);
+            bench::do_not_optimize(q);
+        }
+    });
+
+    // Same stream, one apply_deltas() per 8-level message
+    constexpr size_t kBatch = 8;
+    std::vector<LevelDelta> batches;
+    batches.reserve(stream.size());
+    for (const auto& u : stream) {
+        batches.push_back({u.bid ? Side::BUY : Side::SELL, u.price, u.size});
+    }
+    bench::run(tag + " apply_deltas(8) per level", static_cast<int64_t>(stream.size()),
+               [&](int64_t n) {
+        for (int64_t i = 0; i + static_cast<int64_t>(kBatch) <= n; i += kBatch) {
+            size_t start = static_cast<size_t>(i) % (batches.size() - kBatch);
+            DeltaResult r = book.apply_deltas(std::span<const LevelDelta>(&batches[start], kBatch));
+            bench::do_not_optimize(r);
+        }
+    });
+
+    std::vector<PriceLevel> bids, asks;
+    for (int t = 1; t <= 10; ++t) {
+        bids.push_back({(50 - t) / 100.0, 100.0 * t});
+        asks.push_back({(50 + t) / 100.0, 100.0 * t});
+    }
+    bench::run(tag + " apply_snapshot(10x10)", 500'000, [&](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            book.apply_snapshot(bids, asks);
+        }
+    });
+}
+
+// Per-market read set S2 used to issue (has_liquidity + best asks + spreads,
+// each leg locked separately) vs one two-leg snapshot
+void bench_binary_reads() {
+    BinaryMarketBook book("BENCH", OrderBookImpl::TICK_ARRAY);
+    for (int t = 1; t <= 10; ++t) {
+        book.yes_book().update_bid((50 - t) / 100.0, 100.0);
+        book.yes_book().update_ask((50 + t) / 100.0, 100.0);
+        book.no_book().update_bid((50 - t) / 100.0, 100.0);
+        book.no_book().update_ask((50 + t) / 100.0, 100.0);
+    }
+
+    bench::run("binary locked reads (10 locks)", 1'000'000, [&](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            bool live = book.yes_book().best_bid().has_value() &&
+                        book.yes_book().best_ask().has_value() &&
+                        book.no_book().best_bid().has_value() &&
+                        book.no_book().best_ask().has_value();
+            auto yes_ask = book.yes_book().best_ask();
+            auto no_ask = book.no_book().best_ask();
+            Price spreads = book.yes_book().spread() + book.no_book().spread();
+            bench::do_not_optimize(live);
+            bench::do_not_optimize(yes_ask);
+            bench::do_not_optimize(no_ask);
+            bench::do_not_optimize(spreads);
+        }
+    });
+
+    bench::run("binary snapshot(1)", 1'000'000, [&](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            BinaryBookSnapshot snap = book.snapshot(1);
+            bench::do_not_optimize(snap);
+        }
+    });
+
+    bench::run("binary snapshot(5)", 1'000'000, [&](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            BinaryBookSnapshot snap = book.snapshot();
+            bench::do_not_optimize(snap);
+        }
+    });
+}
+
+} // namespace
+
+int main() {
+    auto stream = make_stream(2'000'000);
+    std::printf("OrderBook benchmark (%zu updates, max_levels=10)\n\n", stream.size());
+    bench_impl(OrderBookImpl::MAP, stream);
+    std::printf("\n");
+    bench_impl(OrderBookImpl::TICK_ARRAY, stream);
+    std::printf("\n");
+    bench_binary_reads();
+    return 0;
+}
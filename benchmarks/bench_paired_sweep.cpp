@@ -0,0 +1,73 @@
+#include <random>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include "market_data/order_book.hpp"
+#include "strategy/strategy_base.hpp"
+#include "bench_util.hpp"
+
+using namespace arb;
+
+/**
+ * S2 sizing kernel: sweep_paired_asks() over ladders of 1-10 levels, plus the
+ * whole UnderpricingStrategy::evaluate() on a book where the sweep goes deep.
+ */
+
+namespace {
+
+constexpr int64_t kFeeRate = POLYMARKET_FEE_RATE_PPM;
+
+// Underpriced ladders so the walk consumes every level
+std::vector<PriceLevel> make_ladder(int levels, int start_tick, std::mt19937& gen) {
+    std::uniform_real_distribution<double> size_dist(5.0, 50.0);
+    std::vector<PriceLevel> ladder;
+    for (int i = 0; i < levels; ++i) {
+        ladder.push_back({(start_tick + i) / 100.0, size_dist(gen)});
+    }
+    return ladder;
+}
+
+void bench_kernel(int levels) {
+    std::mt19937 gen(7);
+    auto yes = make_ladder(levels, 30, gen);
+    auto no = make_ladder(levels, 35, gen);
+
+    bench::run("sweep_paired_asks " + std::to_string(levels) + "x" + std::to_string(levels),
+               10'000'000, [&](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            PairedSweep s = sweep_paired_asks(yes, no, kFeeRate, 2.0);
+            bench::do_not_optimize(s);
+        }
+    });
+}
+
+void bench_evaluate() {
+    StrategyConfig config;
+    config.min_edge_cents = 2.0;
+    config.max_spread_to_trade = 0.05;
+    UnderpricingStrategy strategy(config);
+    BinaryMarketBook book("BENCH", OrderBookImpl::TICK_ARRAY);
+
+    std::mt19937 gen(11);
+    book.yes_book().apply_snapshot({{0.29, 100.0}}, make_ladder(10, 30, gen));
+    book.no_book().apply_snapshot({{0.34, 100.0}}, make_ladder(10, 35, gen));
+
+    BtcPrice btc;
+    bench::run("UnderpricingStrategy::evaluate (signal)", 200'000, [&](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            auto signals = strategy.evaluate(book, btc, now());
+            bench::do_not_optimize(signals.data());
+        }
+    });
+}
+
+} // namespace
+
+int main() {
+    spdlog::set_level(spdlog::level::off);  // evaluate() logs every signal
+    std::printf("Paired ask sweep benchmark\n\n");
+    for (int levels : {1, 3, 5, 10}) {
+        bench_kernel(levels);
+    }
+    bench_evaluate();
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <random>
+#include <string>
+#include <vector>
+#include "common/symbol_registry.hpp"
+#include "market_data/polymarket_parser.hpp"
+#include "bench_util.hpp"
+
+using namespace arb;
+
+/**
+ * Polymarket book / price_change parsing: the on-demand scanner versus the
+ * nlohmann DOM path it replaces. Book snapshots carry 20 levels a side,
+ * price_change batches four entries across both tokens of a market.
+ */
+
+namespace {
+
+const char* YES_TOKEN = "71321045679252212594626385532706912750332728571942532289631379312455583992563";
+const char* NO_TOKEN = "52114319501245915516055106046884209969926127482827954674443846427813813222426";
+
+std::string level(int ticks, int size) {
+    return "{\"price\":\"0." + std::to_string(100 + ticks).substr(1) + "\",\"size\":\"" +
+           std::to_string(size) + "." + std::to_string(size % 100) + "\"}";
+}
+
+std::vector<std::string> make_books(int n) {
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<int> size(1, 50000);
+    std::vector<std::string> msgs;
+    for (int i = 0; i < n; ++i) {
+        std::string bids;
+        std::string asks;
+        for (int k = 0; k < 20; ++k) {
+            bids += (k ? "," : "") + level(48 - k, size(gen));
+            asks += (k ? "," : "") + level(52 + k, size(gen));
+        }
+        msgs.push_back(std::string("{\"event_type\":\"book\",\"asset_id\":\"") + YES_TOKEN +
+                       "\",\"market\":\"0x5f65177b394277fd294cd75650044e32ba009a95022d88a0c1d565897d72f8f1\"," +
+                       "\"bids\":[" + bids + "],\"asks\":[" + asks + "],\"timestamp\":\"" +
+                       std::to_string(1700000000000LL + i) + "\",\"hash\":\"0x0d1b5b2a\"}");
+    }
+    return msgs;
+}
+
+std::vector<std::string> make_price_changes(int n) {
+    std::mt19937 gen(6);
+    std::uniform_int_distribution<int> ticks(40, 60);
+    std::uniform_int_distribution<int> size(0, 5000);
+    std::vector<std::string> msgs;
+    for (int i = 0; i < n; ++i) {
+        std::string entries;
+        for (int k = 0; k < 4; ++k) {
+            const char* token = k < 2 ? YES_TOKEN : NO_TOKEN;
+            entries += std::string(k ? "," : "") + "{\"asset_id\":\"" + token + "\",\"price\":\"0." +
+                       std::to_string(ticks(gen)) + "\",\"size\":\"" + std::to_string(size(gen)) +
+                       "\",\"side\":\"" + (k % 2 ? "SELL" : "BUY") +
+                       "\",\"hash\":\"0x1a2b\",\"best_bid\":\"0.48\",\"best_ask\":\"0.52\"}";
+        }
+        msgs.push_back("{\"market\":\"0x5f65177b394277fd294cd75650044e32ba009a95022d88a0c1d565897d72f8f1\"," +
+                       std::string("\"price_changes\":[") + entries + "],\"timestamp\":\"" +
+                       std::to_string(1700000000000LL + i) + "\",\"event_type\":\"price_change\"}");
+    }
+    return msgs;
+}
+
+template <typename Parse>
+void bench_parse(const std::string& name, const std::vector<std::string>& msgs, int64_t iterations, Parse parse) {
+    PolymarketMessage out;
+    bench::run(name, iterations, [&](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            parse(msgs[static_cast<size_t>(i) % msgs.size()], out);
+            bench::do_not_optimize(out.levels.data());
+            bench::do_not_optimize(out.timestamp_ms);
+        }
+    });
+}
+
+} // namespace
+
+int main() {
+    std::printf("Polymarket message parse benchmark\n\n");
+    SymbolRegistry::instance().intern_token(YES_TOKEN);
+    SymbolRegistry::instance().intern_token(NO_TOKEN);
+
+    auto books = make_books(256);
+    auto changes = make_price_changes(1024);
+
+    auto fast = [](std::string_view m, PolymarketMessage& out) {
+        return parse_polymarket_message(m, nullptr, nullptr, out);
+    };
+    auto fast_fixed = [](std::string_view m, PolymarketMessage& out) {
+        return parse_polymarket_message(m, &POLYMARKET_PRICE_SCALE, &POLYMARKET_SIZE_SCALE, out);
+    };
+    auto dom = [](std::string_view m, PolymarketMessage& out) {
+        return parse_polymarket_message_json(m, nullptr, nullptr, out);
+    };
+
+    bench_parse("book on-demand", books, 200'000, fast);
+    bench_parse("book on-demand (fixed-point)", books, 200'000, fast_fixed);
+    bench_parse("book nlohmann", books, 200'000, dom);
+    bench_parse("price_change on-demand", changes, 1'000'000, fast);
+    bench_parse("price_change on-demand (fixed-point)", changes, 1'000'000, fast_fixed);
+    bench_parse("price_change nlohmann", changes, 1'000'000, dom);
+    return 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <chrono>
+#include <string>
+
+namespace arb::bench {
+
+/**
+ * Minimal timing harness for the microbenchmarks.
+ * Runs fn(iterations) once to warm up, then once measured, and prints ns/op.
+ */
+template <typename Fn>
+double run(const std::string& name, int64_t iterations, Fn&& fn) {
+    fn(iterations / 10 + 1);
+
+    auto start = std::chrono::steady_clock::now();
+    fn(iterations);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    double ns = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    double ns_per_op = ns / static_cast<double>(iterations);
+    std::printf("%-44s %12lld ops %10.1f ns/op %12.0f ops/s\n",
+                name.c_str(), static_cast<long long>(iterations), ns_per_op,
+                ns_per_op > 0 ? 1e9 / ns_per_op : 0.0);
+    return ns_per_op;
+}
+
+// Keep the optimizer from discarding a computed value
+template <typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+} // namespace arb::bench
@@ -0,0 +1,38 @@
+# Fails unless GCC's -fopt-info-vec-optimized REPORT shows a vectorized loop
+# inside FUNCTION's definition in SOURCE.
+#
+#   cmake -DREPORT=<file> -DSOURCE=<file.cpp> -DFUNCTION=<name> -P CheckVectorized.cmake
+
+if(NOT EXISTS "${REPORT}")
+    message(FATAL_ERROR "No vectorizer report at ${REPORT}; rebuild with GCC")
+endif()
+
+# Line span of the definition: its signature through the first closing
+# brace in column 0
+file(STRINGS "${SOURCE}" lines)
+set(line_no 0)
+set(first 0)
+set(last 0)
+foreach(line IN LISTS lines)
+    math(EXPR line_no "${line_no} + 1")
+    if(first EQUAL 0 AND line MATCHES "^[A-Za-z].*[ *&]${FUNCTION}\\(")
+        set(first ${line_no})
+    elseif(first GREATER 0 AND last EQUAL 0 AND line MATCHES "^}")
+        set(last ${line_no})
+    endif()
+endforeach()
+if(first EQUAL 0 OR last EQUAL 0)
+    message(FATAL_ERROR "Could not find the definition of ${FUNCTION} in ${SOURCE}")
+endif()
+
+get_filename_component(source_name "${SOURCE}" NAME)
+file(STRINGS "${REPORT}" report REGEX "${source_name}:[0-9]+:[0-9]+: optimized: loop vectorized")
+foreach(entry IN LISTS report)
+    string(REGEX MATCH "${source_name}:([0-9]+):" unused "${entry}")
+    if(CMAKE_MATCH_1 GREATER_EQUAL first AND CMAKE_MATCH_1 LESS_EQUAL last)
+        message(STATUS "${FUNCTION}: ${entry}")
+        return()
+    endif()
+endforeach()
+
+message(FATAL_ERROR "${FUNCTION} (${source_name}:${first}-${last}) is not vectorized")
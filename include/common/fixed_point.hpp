@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+#include "common/types.hpp"
+
+namespace arb {
+
+/**
+ * Fixed-point prices and sizes: an integer count of 10^-decimals units.
+ *
+ * Feeds send decimal strings; parse_fixed() turns them into exact integers
+ * without going through strtod, and to_double() maps each integer to the
+ * one nearest double, so equal wire prices always give bit-identical Price
+ * values. Edge and fee math that must replay bit-for-bit runs on the
+ * integers (see fixed_pair_edge()).
+ */
+using Ticks = int64_t;
+
+struct FixedScale {
+    int decimals{0};
+    int64_t units{1};  // 10^decimals
+
+    static constexpr FixedScale from_decimals(int decimals) {
+        int64_t units = 1;
+        for (int i = 0; i < decimals; ++i) units *= 10;
+        return FixedScale{decimals, units};
+    }
+
+    Ticks to_ticks(double value) const { return std::llround(value * static_cast<double>(units)); }
+    double to_double(Ticks ticks) const { return static_cast<double>(ticks) / static_cast<double>(units); }
+
+    // Round a double onto the grid
+    double snap(double value) const { return to_double(to_ticks(value)); }
+};
+
+// Polymarket prices tick at 0.01 or 0.001; sizes carry up to 6 decimals
+constexpr FixedScale POLYMARKET_PRICE_SCALE = FixedScale::from_decimals(4);
+constexpr FixedScale POLYMARKET_SIZE_SCALE = FixedScale::from_decimals(6);
+
+// Resolution of OrderBook's map keys; fine enough for any venue's tick
+constexpr FixedScale BOOK_KEY_SCALE = FixedScale::from_decimals(8);
+
+/**
+ * Parse a plain decimal ("0.455", "-12", "42000.10") into ticks of scale.
+ * Digits beyond the scale are rounded half-up. Returns false on anything
+ * that is not [-]digits[.digits], or on overflow.
+ */
+inline bool parse_fixed(std::string_view text, const FixedScale& scale, Ticks& out) {
+    size_t i = 0;
+    bool negative = false;
+    if (i < text.size() && (text[i] == '-' || text[i] == '+')) {
+        negative = text[i] == '-';
+        ++i;
+    }
+
+    constexpr Ticks LIMIT = INT64_MAX / 10 - 10;
+    Ticks value = 0;
+    bool any_digit = false;
+    for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+        if (value > LIMIT) return false;
+        value = value * 10 + (text[i] - '0');
+        any_digit = true;
+    }
+
+    int frac_digits = 0;
+    bool round_up = false;
+    if (i < text.size() && text[i] == '.') {
+        ++i;
+        for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+            if (frac_digits < scale.decimals) {
+                if (value > LIMIT) return false;
+                value = value * 10 + (text[i] - '0');
+                ++frac_digits;
+            } else if (frac_digits == scale.decimals) {
+                round_up = text[i] >= '5';
+                ++frac_digits;  // Only the first dropped digit decides rounding
+            }
+            any_digit = true;
+        }
+    }
+    if (!any_digit || i != text.size()) return false;
+
+    for (int d = std::min(frac_digits, scale.decimals); d < scale.decimals; ++d) {
+        if (value > LIMIT) return false;
+        value *= 10;
+    }
+    if (round_up) ++value;
+
+    out = negative ? -value : value;
+    return true;
+}
+
+// Parse straight to the double nearest the decimal's value on the grid
+inline bool parse_fixed_price(std::string_view text, const FixedScale& scale, Price& out) {
+    Ticks ticks = 0;
+    if (!parse_fixed(text, scale, ticks)) return false;
+    out = scale.to_double(ticks);
+    return true;
+}
+
+/**
+ * Parse a plain decimal ([-]digits[.digits]) to the nearest double - the
+ * same value std::stod gives. Up to 15 significant digits (every feed
+ * price and size) take one integer pass and a single exact division;
+ * longer inputs fall back to strtod. Returns false on anything else.
+ */
+inline bool parse_decimal(std::string_view text, double& out) {
+    static constexpr double POW10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    size_t i = 0;
+    bool negative = false;
+    if (i < text.size() && (text[i] == '-' || text[i] == '+')) {
+        negative = text[i] == '-';
+        ++i;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;       // Significant digits accumulated (leading zeros skipped)
+    int frac_digits = 0;
+    bool any_digit = false;
+    for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(text[i] - '0');
+        if (mantissa != 0) ++digits;
+        any_digit = true;
+        if (digits > 15) break;
+    }
+    if (digits <= 15 && i < text.size() && text[i] == '.') {
+        ++i;
+        for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(text[i] - '0');
+            if (mantissa != 0) ++digits;
+            ++frac_digits;
+            any_digit = true;
+            if (digits > 15 || frac_digits > 22) break;
+        }
+    }
+
+    if (digits <= 15 && frac_digits <= 22) {
+        if (!any_digit || i != text.size()) return false;
+        // Both operands are exact doubles, so the quotient is correctly rounded
+        double value = static_cast<double>(mantissa) / POW10[frac_digits];
+        out = negative ? -value : value;
+        return true;
+    }
+
+    // Too many digits for the exact path: validate, then let strtod round
+    for (; i < text.size() && ((text[i] >= '0' && text[i] <= '9') || text[i] == '.'); ++i) {}
+    if (i != text.size() || text.size() >= 64 ||
+        std::count(text.begin(), text.end(), '.') > 1) {
+        return false;
+    }
+    char buf[64];
+    std::copy(text.begin(), text.end(), buf);
+    buf[text.size()] = '\0';
+    out = std::strtod(buf, nullptr);
+    return true;
+}
+
+// Polymarket's parabolic fee rate (6.24% at the p(1-p) peak), parts per million
+constexpr int64_t POLYMARKET_FEE_RATE_PPM = 62'400;
+
+// Parabolic fee price * (1 - price) * rate on one share, in units of
+// 1 / (units^2 * 1e6) dollars
+inline int64_t fixed_fee(Ticks price, const FixedScale& scale,
+                         int64_t fee_rate_ppm = POLYMARKET_FEE_RATE_PPM) {
+    return price * (scale.units - price) * fee_rate_ppm;
+}
+
+/**
+ * Per-pair S2 edge 1 - y - n - (y(1-y) + n(1-n)) * rate, exact in integers.
+ * Prices are ticks of scale; the result is in units of 1 / (units^2 * 1e6)
+ * dollars. At POLYMARKET_PRICE_SCALE every term stays below 1e15.
+ */
+inline int64_t fixed_pair_edge(Ticks yes, Ticks no, const FixedScale& scale,
+                               int64_t fee_rate_ppm = POLYMARKET_FEE_RATE_PPM) {
+    const int64_t one = scale.units;
+    const int64_t ppm = 1'000'000;
+    int64_t cost = (yes + no) * one * ppm;
+    int64_t fees = fixed_fee(yes, scale, fee_rate_ppm) + fixed_fee(no, scale, fee_rate_ppm);
+    return one * one * ppm - cost - fees;
+}
+
+// fixed_pair_edge() units per cent
+inline double fixed_edge_per_cent(const FixedScale& scale) {
+    return static_cast<double>(scale.units) * static_cast<double>(scale.units) * 1e4;
+}
+
+inline double fixed_pair_edge_cents(Ticks yes, Ticks no, const FixedScale& scale,
+                                    int64_t fee_rate_ppm = POLYMARKET_FEE_RATE_PPM) {
+    return static_cast<double>(fixed_pair_edge(yes, no, scale, fee_rate_ppm)) / fixed_edge_per_cent(scale);
+}
+
+// A cents threshold in fixed_pair_edge() units, converted once so edges
+// compare as integers
+inline int64_t fixed_edge_from_cents(double cents, const FixedScale& scale) {
+    return std::llround(cents * fixed_edge_per_cent(scale));
+}
+
+// Fee per share at price, computed on the grid (exact up to the final division)
+inline double fixed_fee_per_share(Price price, const FixedScale& scale,
+                                  int64_t fee_rate_ppm = POLYMARKET_FEE_RATE_PPM) {
+    int64_t fee = fixed_fee(scale.to_ticks(price), scale, fee_rate_ppm);
+    return static_cast<double>(fee) / (fixed_edge_per_cent(scale) * 100.0);
+}
+
+} // namespace arb
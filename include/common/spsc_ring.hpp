@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace arb {
+
+/**
+ * Bounded lock-free single-producer / single-consumer ring.
+ *
+ * Capacity is rounded up to a power of two. Producer and consumer indices
+ * sit on separate cache lines, and each side keeps a private copy of the
+ * other's index so it only reloads the shared one when the ring looks full
+ * (producer) or empty (consumer).
+ *
+ * push() from one thread and pop() from one other thread; size() from any.
+ */
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity)
+        : slots_(round_up(capacity))
+        , mask_(slots_.size() - 1)
+    {
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // False if the ring is full
+    bool push(const T& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ == slots_.size()) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ == slots_.size()) return false;
+        }
+        slots_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // False if the ring is empty
+    bool pop(T& out) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) return false;
+        }
+        out = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Head first: tail only grows, so the difference cannot wrap below zero.
+    // Pops and pushes between the two loads can overshoot, hence the clamp.
+    size_t size() const {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return std::min(tail - head, slots_.size());
+    }
+    size_t capacity() const { return slots_.size(); }
+
+private:
+    static size_t round_up(size_t n) {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    std::vector<T> slots_;
+    size_t mask_;
+
+    alignas(64) std::atomic<size_t> tail_{0};  // Producer
+    size_t head_cache_{0};
+    alignas(64) std::atomic<size_t> head_{0};  // Consumer
+    size_t tail_cache_{0};
+};
+
+} // namespace arb
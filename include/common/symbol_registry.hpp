@@ -0,0 +1,79 @@
+#pragma once
+
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "common/types.hpp"
+
+namespace arb {
+
+/**
+ * Interns Polymarket condition IDs and token IDs into dense integer handles.
+ *
+ * Symbols are interned once, when a market is registered for subscription;
+ * from then on feed handlers, strategies, execution, risk and positions key
+ * on the handle and only go back to the string at the REST/JSON edges and in
+ * logs. Handles are never reused, so a handle stays valid (and its name
+ * reference stable) for the life of the process. NO_SYMBOL (0) is never
+ * assigned and maps to an empty name.
+ */
+class SymbolRegistry {
+public:
+    static SymbolRegistry& instance();
+
+    // Get or assign a handle
+    MarketHandle intern_market(std::string_view market_id);
+    TokenHandle intern_token(std::string_view token_id);
+
+    // NO_SYMBOL if the ID was never interned
+    MarketHandle find_market(std::string_view market_id) const;
+    TokenHandle find_token(std::string_view token_id) const;
+
+    // Original string for a handle (empty for NO_SYMBOL or unknown handles)
+    const std::string& market_name(MarketHandle handle) const;
+    const std::string& token_name(TokenHandle handle) const;
+
+    size_t market_count() const;
+    size_t token_count() const;
+
+private:
+    SymbolRegistry();
+
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    struct Table {
+        std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> ids;
+        std::deque<std::string> names;  // Indexed by handle; deque keeps references stable
+    };
+
+    uint32_t intern(Table& table, std::string_view id);
+    uint32_t find(const Table& table, std::string_view id) const;
+    const std::string& name(const Table& table, uint32_t handle) const;
+
+    mutable std::shared_mutex mutex_;
+    Table markets_;
+    Table tokens_;
+};
+
+// Handle carried by a record, interning its string ID when the producer did
+// not set one (records built by tests or restored from the ledger)
+template <typename T>
+MarketHandle market_handle_of(const T& record) {
+    return record.market_handle != NO_SYMBOL
+        ? record.market_handle
+        : SymbolRegistry::instance().intern_market(record.market_id);
+}
+
+template <typename T>
+TokenHandle token_handle_of(const T& record) {
+    return record.token_handle != NO_SYMBOL
+        ? record.token_handle
+        : SymbolRegistry::instance().intern_token(record.token_id);
+}
+
+} // namespace arb
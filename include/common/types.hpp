@@ -32,6 +32,11 @@ using Price = double;
 using Size = double;
 using Notional = double;
 
+// Dense handles for interned market (condition) and token IDs, see SymbolRegistry
+using MarketHandle = uint32_t;
+using TokenHandle = uint32_t;
+constexpr uint32_t NO_SYMBOL = 0;
+
 // Side enum
 enum class Side {
     BUY,
@@ -155,6 +160,7 @@ struct Market {
     Outcome yes_outcome;
     Outcome no_outcome;
     bool active{true};
+    WallClock start_date;  // Trading window opens; epoch when already open
     WallClock end_date;
     double fee_rate_bps{0.0};  // Fee rate in basis points
 };
@@ -175,6 +181,8 @@ struct Fill {
     std::string trade_id;
     std::string market_id;
     std::string token_id;
+    MarketHandle market_handle{NO_SYMBOL};
+    TokenHandle token_handle{NO_SYMBOL};
     Side side;
     Price price;
     Size size;
@@ -189,6 +197,8 @@ struct Signal {
     std::string strategy_name;
     std::string market_id;
     std::string token_id;
+    MarketHandle market_handle{NO_SYMBOL};
+    TokenHandle token_handle{NO_SYMBOL};
     Side side;
     Price target_price;
     Size target_size;
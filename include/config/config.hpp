@@ -43,12 +43,39 @@ struct ConnectionConfig {
     // Binance
     std::string binance_ws_url{"wss://stream.binance.com:9443/ws"};
     std::string binance_symbol{"btcusdt"};
+    bool binance_trade_stream{true};         // Also subscribe to <symbol>@trade for the last price
 
     // Connection params
     int reconnect_delay_ms{1000};
     int max_reconnect_attempts{10};
+    int dns_refresh_ms{60000};               // Re-resolve cached feed hosts this often (0 = never)
+    int feed_connections{1};                 // Parallel WebSocket connections per feed; first arrival wins
+    bool feed_spread_addresses{true};        // Put redundant connections on different resolved IPs
+    bool kernel_rx_timestamps{true};         // Time feed messages by SO_TIMESTAMPNS, not after TLS decrypt
+    int polymarket_shards{1};                // Split market subscriptions over this many connection sets
+    std::string polymarket_shard_key{"market"};  // Shard unit: "market" (YES+NO together) or "token"
+    int subscribe_batch_size{500};           // Token IDs per Polymarket subscribe message
     int heartbeat_interval_ms{30000};
     int connection_timeout_ms{10000};
+    int http_timeout_ms{30000};              // Whole REST request, connect included
+    bool http2{false};                       // Offer HTTP/2 to REST endpoints
+    int bootstrap_concurrency{16};           // REST book snapshots in flight at once
+    double bootstrap_rate_limit{20.0};       // Snapshot requests started per second (0 = unlimited)
+    int discovery_interval_ms{30000};        // Re-list markets this often (0 = only at startup)
+    int discovery_page_size{500};            // Gamma /markets page size
+    int rollover_lead_ms{60000};             // Extra discovery pass before each 15-minute boundary (0 = off)
+
+    // Order book storage: "map" (any price) or "tick" (flat array on tick grid)
+    std::string order_book_impl{"map"};
+    double price_tick_size{0.01};            // Polymarket binary tick grid
+
+    // Parse wire prices/sizes as exact fixed-point decimals instead of strtod
+    bool fixed_point_prices{false};
+    int binance_price_decimals{2};           // Fixed-point scale for Binance prices
+
+    // All WebSocket feeds share one epoll thread; pin it to this CPU (-1 = unpinned).
+    // Polymarket shards past the first run on threads of their own.
+    int feed_thread_cpu{-1};
 };
 
 struct LoggingConfig {
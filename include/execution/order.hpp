@@ -20,6 +20,8 @@ struct Order {
     // Order details
     std::string market_id;
     std::string token_id;
+    MarketHandle market_handle{NO_SYMBOL};
+    TokenHandle token_handle{NO_SYMBOL};
     Side side;
     OrderType type;
     Price price;
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "common/types.hpp"
+#include "common/fixed_point.hpp"
+
+namespace arb {
+
+// One Binance bookTicker or trade event, flattened
+struct BinanceTick {
+    enum class Kind { NONE, BOOK_TICKER, TRADE };
+
+    Kind kind{Kind::NONE};     // NONE: a message we don't use (e.g. SUBSCRIBE ack)
+    int64_t update_id{0};      // "u" (bookTicker) or "t" trade id
+    Price bid{0.0};            // "b"
+    Size bid_qty{0.0};         // "B"
+    Price ask{0.0};            // "a"
+    Size ask_qty{0.0};         // "A"
+    Price price{0.0};          // "p" (trade)
+    Size qty{0.0};             // "q" (trade)
+    int64_t event_time_ms{0};  // "E"; 0 if absent
+
+    // "s", copied inline so the tick outlives the frame
+    static constexpr size_t MAX_SYMBOL = 31;
+    char symbol_buf[MAX_SYMBOL + 1]{};
+    size_t symbol_len{0};
+
+    std::string_view symbol() const { return std::string_view(symbol_buf, symbol_len); }
+    bool set_symbol(std::string_view s);
+};
+
+/**
+ * On-demand parser for Binance's flat bookTicker / trade objects.
+ *
+ * One forward scan over the frame: keys are matched by their single
+ * character, values are sliced in place, and decimals go straight to
+ * double (parse_decimal) or onto price_scale's grid when it is non-null.
+ * No DOM and no allocation. Returns false for anything outside that
+ * schema (nested values, escapes, exponents); callers then fall back to
+ * parse_binance_message_json(), which accepts any valid JSON.
+ */
+bool parse_binance_message(std::string_view msg, const FixedScale* price_scale, BinanceTick& out);
+
+// Reference nlohmann path with identical results on every message both accept
+bool parse_binance_message_json(std::string_view msg, const FixedScale* price_scale, BinanceTick& out);
+
+} // namespace arb
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "common/spsc_ring.hpp"
+#include "common/types.hpp"
+
+namespace arb {
+
+// Handoff counters since construction
+struct BookHandoffStats {
+    int64_t published{0};   // publish() calls
+    int64_t delivered{0};   // Market events that reached the strategy thread
+    int64_t full_passes{0}; // drain() calls that asked for every market
+    int64_t overflows{0};   // Events a full ring turned into a full pass
+    size_t depth{0};        // Events queued right now, across producers
+    size_t max_depth{0};    // Deepest any drain() found the queues
+
+    // Updates per event the strategy thread actually saw
+    double conflation_ratio() const {
+        return delivered > 0 ? static_cast<double>(published) / delivered : 0.0;
+    }
+};
+
+/**
+ * "Market X's top of book moved" events, from feed threads to the single
+ * strategy thread.
+ *
+ * Every producer thread gets its own SpscRing on first publish(), so no two
+ * threads ever share a ring or a lock on the hot path. A thread's ring is
+ * released when the thread exits and handed to the next new producer once
+ * drained, so short-lived threads (listing passes, resyncs) never run the
+ * handoff out of rings. Events conflate per
+ * market: a market already waiting in some ring is not queued again, and
+ * the strategy thread reads the book itself, so a burst collapses into one
+ * look at the latest state. publish_all() is the same for a change that
+ * touches every market (the reference price), and a full ring degrades to
+ * it rather than losing an event.
+ *
+ * The strategy thread sleeps in wait() and a publish() wakes it only when
+ * it is actually asleep, so an idle producer pays for an atomic load, not
+ * a syscall.
+ */
+class BookHandoff {
+public:
+    explicit BookHandoff(size_t ring_capacity = 4096);
+    ~BookHandoff();
+
+    BookHandoff(const BookHandoff&) = delete;
+    BookHandoff& operator=(const BookHandoff&) = delete;
+
+    // Producer threads
+    void publish(MarketHandle market);
+    void publish_all();
+
+    // Strategy thread: block until something is pending or timeout passes;
+    // false on timeout
+    bool wait(Duration timeout);
+    // Strategy thread: append every pending market to out (each once) and
+    // clear it. True if every market should be looked at instead.
+    bool drain(std::vector<MarketHandle>& out);
+
+    BookHandoffStats stats() const;
+
+private:
+    static constexpr size_t MAX_PRODUCERS = 64;
+    static constexpr size_t FLAG_CHUNK = 4096;
+    static constexpr size_t MAX_FLAG_CHUNKS = 1024;  // Handles below 4M
+
+    using Ring = SpscRing<MarketHandle>;
+
+    // One producer thread's ring; shared with that thread so it can let go
+    // of the slot on exit even after the handoff is gone
+    struct Producer {
+        explicit Producer(size_t capacity) : ring(capacity) {}
+
+        Ring ring;
+        std::atomic<bool> claimed{true};  // A live thread pushes to ring
+    };
+
+    const uint64_t id_;  // Tells instances apart in producers' thread-local cache
+    size_t ring_capacity_;
+
+    std::array<std::atomic<Producer*>, MAX_PRODUCERS> producers_{};
+    std::atomic<size_t> ring_count_{0};
+    std::vector<std::shared_ptr<Producer>> owned_;  // Guarded by register_mutex_
+    std::mutex register_mutex_;
+
+    // Per-market "queued and not yet drained", allocated a chunk at a time
+    std::array<std::atomic<std::atomic<uint8_t>*>, MAX_FLAG_CHUNKS> pending_{};
+
+    std::atomic<bool> all_pending_{false};
+    std::atomic<bool> sleeping_{false};
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+
+    std::atomic<int64_t> published_{0};
+    std::atomic<int64_t> delivered_{0};
+    std::atomic<int64_t> full_passes_{0};
+    std::atomic<int64_t> overflows_{0};
+    std::atomic<size_t> max_depth_{0};
+
+    Ring* producer_ring();
+    std::atomic<uint8_t>* pending_flag(MarketHandle market);
+    bool has_pending() const;
+    void wake();
+};
+
+} // namespace arb
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace arb {
+
+/**
+ * Single-threaded epoll reactor shared by every market data connection.
+ *
+ * One thread waits in epoll_wait and dispatches readiness to per-fd
+ * callbacks, so adding a venue or another socket adds a file descriptor,
+ * not a thread. Other threads talk to the loop only through post(), which
+ * queues a task and wakes the loop through an eventfd.
+ *
+ * add()/modify()/remove() and the timer calls must run on the loop thread
+ * (from a callback or a posted task); callbacks never run concurrently.
+ */
+class EventLoop {
+public:
+    using Task = std::function<void()>;
+    using IoCallback = std::function<void(uint32_t events)>;  // EPOLLIN / EPOLLOUT / EPOLLERR ...
+    using TimerId = uint64_t;
+    using Clock = std::chrono::steady_clock;
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // Loop shared by the feed clients
+    static EventLoop& instance();
+
+    // Start the loop thread, pinned to cpu when cpu >= 0. No-op if running.
+    void start(int cpu = -1);
+    // Stop and join; tasks still queued run on the calling thread
+    void stop();
+    bool running() const { return running_.load(); }
+    bool in_loop_thread() const;
+
+    // Thread-safe: run task on the loop thread
+    void post(Task task);
+    // Thread-safe: run task on the loop thread and wait for it. Runs inline
+    // when called from the loop thread or when the loop is not running,
+    // including when stop() wins a race with the call.
+    void run_sync(const Task& task);
+
+    // File descriptor registration (loop thread only)
+    bool add(int fd, uint32_t events, IoCallback cb);
+    bool modify(int fd, uint32_t events);
+    void remove(int fd);
+
+    // One-shot timers (loop thread only); ids are never reused
+    TimerId run_after(std::chrono::milliseconds delay, Task task);
+    void cancel_timer(TimerId id);
+
+    // Stats
+    int64_t wakeups() const { return wakeups_.load(); }
+    size_t fd_count() const { return fd_count_.load(); }
+
+private:
+    int epoll_fd_{-1};
+    int wake_fd_{-1};
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    std::atomic<std::thread::id> loop_thread_id_{};
+
+    std::vector<Task> pending_;
+    bool stopped_{false};  // Guarded by pending_mutex_; set before stop()'s last drain
+    std::mutex pending_mutex_;
+
+    // Loop-thread state
+    // shared_ptr so a callback may remove its own fd while it runs
+    std::unordered_map<int, std::shared_ptr<IoCallback>> handlers_;
+    std::map<std::pair<Clock::time_point, TimerId>, Task> timers_;
+    std::unordered_map<TimerId, Clock::time_point> timer_deadlines_;
+    TimerId next_timer_id_{1};
+
+    std::atomic<int64_t> wakeups_{0};
+    std::atomic<size_t> fd_count_{0};
+
+    void run(int cpu);
+    void run_pending();
+    void run_due_timers();
+    int next_timeout_ms() const;
+    void wake();
+};
+
+} // namespace arb
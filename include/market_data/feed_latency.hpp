@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "common/types.hpp"
+#include "utils/metrics.hpp"
+
+namespace arb {
+
+/**
+ * Offset of the local wall clock from an exchange's, as seen through its
+ * event timestamps.
+ *
+ * Each sample is local receive time minus exchange event time: the one-way
+ * latency plus clock skew. Queueing only ever adds to it, so the minimum
+ * over a sliding window is the best estimate of skew plus the fastest path,
+ * and a sample's excess over it is delay picked up on the way. The window
+ * is kept as a ring of per-interval minimums, so old samples age out
+ * without being stored.
+ *
+ * add() may be called from several threads; a sample racing the rollover
+ * of its interval can be lost.
+ */
+class ClockOffsetEstimator {
+public:
+    explicit ClockOffsetEstimator(Duration window = std::chrono::seconds(60), size_t intervals = 6);
+
+    void add(int64_t sample_ns, Timestamp at);
+
+    // Nullopt until a sample lands inside the window
+    std::optional<int64_t> offset_ns(Timestamp at = now()) const;
+
+private:
+    struct Interval {
+        std::atomic<int64_t> epoch{-1};
+        std::atomic<int64_t> min_ns{0};
+    };
+    int64_t interval_ns_;
+    std::vector<Interval> intervals_;
+};
+
+/**
+ * Where one feed's latency goes, per applied message:
+ *   wire_to_parse      receive stamp to decoded message (TLS, framing, parse)
+ *   parse_to_book      decoded message to book or price updated
+ *   exchange_to_local  exchange event time to receive stamp, wall clock;
+ *                      includes clock skew (see clock_offset_ns())
+ *
+ * Each instance owns its histograms and attaches them to MetricsRegistry
+ * for export as "<feed>.wire_to_parse" and so on while it lives.
+ * Thread-safe; record() takes no locks.
+ */
+class FeedLatency {
+public:
+    explicit FeedLatency(const std::string& feed);
+    ~FeedLatency();
+
+    FeedLatency(const FeedLatency&) = delete;
+    FeedLatency& operator=(const FeedLatency&) = delete;
+
+    // exchange_ms is the message's event time; 0 if it carries none
+    void record(Timestamp recv_time, Timestamp parsed, Timestamp applied, int64_t exchange_ms);
+
+    const LatencyHistogram& wire_to_parse() const { return wire_to_parse_; }
+    const LatencyHistogram& parse_to_book() const { return parse_to_book_; }
+    const LatencyHistogram& exchange_to_local() const { return exchange_to_local_; }
+    std::optional<int64_t> clock_offset_ns() const { return offset_.offset_ns(); }
+
+private:
+    LatencyHistogram wire_to_parse_;
+    LatencyHistogram parse_to_book_;
+    LatencyHistogram exchange_to_local_;
+    ClockOffsetEstimator offset_;
+};
+
+} // namespace arb
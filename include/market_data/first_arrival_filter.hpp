@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "common/types.hpp"
+
+namespace arb {
+
+// One connection's share of a redundant feed
+struct FeedPathStats {
+    int64_t messages{0};       // Delivered by this connection
+    int64_t wins{0};           // Arrived first and were applied
+    int64_t late{0};           // Copies of a message another connection delivered first
+    int64_t late_total_us{0};  // Sum of how far those copies trailed the first
+
+    double win_rate() const { return messages > 0 ? static_cast<double>(wins) / messages : 0.0; }
+    double mean_lag_us() const { return late > 0 ? static_cast<double>(late_total_us) / late : 0.0; }
+};
+
+/**
+ * First-arrival filter for one feed fanned in from redundant connections.
+ *
+ * Every connection carries the same exchange stream, so a message is keyed
+ * by a hash of its payload (which includes the exchange's own timestamp or
+ * update id). The first copy to arrive passes and later copies are
+ * dropped; a copy from another connection counts against that connection,
+ * along with how far it trailed. Repeats on one connection (e.g. replayed
+ * after a resubscribe) are dropped too: book levels carry absolute sizes,
+ * so a genuine repeat changes nothing, while a stale replay would.
+ *
+ * Keys sit in a fixed direct-mapped table, so accept() never allocates. A
+ * slot collision can only let a late copy through, never drop a new message
+ * (barring a 64-bit hash collision).
+ *
+ * accept() must be called from one thread; stats may be read from any.
+ */
+class FirstArrivalFilter {
+public:
+    explicit FirstArrivalFilter(size_t paths, size_t slots = 8192);
+
+    // True if this payload should be applied
+    bool accept(size_t path, std::string_view payload, Timestamp recv_time);
+
+    size_t paths() const { return paths_.size(); }
+    FeedPathStats path_stats(size_t path) const;
+    int64_t duplicates() const { return duplicates_.load(); }
+
+private:
+    struct Arrival {
+        uint64_t key{0};  // 0 = empty
+        Timestamp::rep recv_ns{0};
+        size_t path{0};
+    };
+    std::vector<Arrival> slots_;
+    uint64_t mask_;
+
+    struct PathCounters {
+        std::atomic<int64_t> messages{0};
+        std::atomic<int64_t> wins{0};
+        std::atomic<int64_t> late{0};
+        std::atomic<int64_t> late_total_us{0};
+    };
+    std::vector<std::unique_ptr<PathCounters>> paths_;
+    std::atomic<int64_t> duplicates_{0};
+};
+
+} // namespace arb
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <curl/curl.h>
+
+namespace arb {
+
+struct HttpClientOptions {
+    long timeout_ms{30000};           // Whole request, connect included
+    long connect_timeout_ms{10000};
+    bool http2{false};                // Offer h2 via ALPN; servers without it get HTTP/1.1
+    bool tcp_nodelay{true};
+    long keepalive_idle_s{30};        // TCP keepalive probes on idle pooled connections
+};
+
+struct HttpResponse {
+    long status{0};                   // HTTP status code
+    std::string body;
+};
+
+// Limits for one get_many() batch
+struct HttpBatchOptions {
+    int max_concurrency{16};          // Transfers in flight at once
+    double max_rate{0.0};             // Transfer starts per second; 0 = unlimited
+};
+
+// Cumulative counters across all handles
+struct HttpClientStats {
+    int64_t requests{0};
+    int64_t failures{0};              // Transport errors (no HTTP response)
+    int64_t connects{0};              // New TCP connections opened
+    int64_t handles{0};               // Easy handles created
+    int64_t total_time_us{0};         // Sum of request round-trips
+};
+
+/**
+ * Pooled libcurl client for REST calls.
+ *
+ * Each concurrent caller borrows an easy handle from the pool and returns it
+ * after the request, so a thread making repeated calls keeps reusing the
+ * same configured handle and the keep-alive connections it holds. All
+ * handles share one CURLSH holding the DNS cache and TLS sessions, so even
+ * a handle with no connection to a host yet resumes the TLS session
+ * instead of a full handshake. Connections themselves are never shared:
+ * libcurl does not support one connection cache across concurrent threads.
+ *
+ * get_many() runs a batch of GETs concurrently on the multi interface,
+ * drawing its easy handles from the same pool. Multi handles are pooled
+ * too, and the connections a batch opened stay with its multi handle for
+ * the next batch.
+ *
+ * All calls are thread-safe. get()/post() throw std::runtime_error on
+ * transport failure; any HTTP status, including errors, comes back in the
+ * response.
+ */
+class HttpClient {
+public:
+    explicit HttpClient(HttpClientOptions options = {});
+    ~HttpClient();
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    HttpResponse get(const std::string& url, const std::vector<std::string>& headers = {});
+    HttpResponse post(const std::string& url, std::string_view body,
+                      const std::vector<std::string>& headers = {});
+
+    // Result of one get_many() transfer; error is empty on success
+    using BatchCallback = std::function<void(size_t index, HttpResponse& response,
+                                             const std::string& error)>;
+
+    // GET every url on the curl multi interface, within the batch limits.
+    // on_done runs on the calling thread as each transfer finishes, in
+    // completion order, and must not throw. Blocks until all are done.
+    void get_many(const std::vector<std::string>& urls, const std::vector<std::string>& headers,
+                  const HttpBatchOptions& batch, const BatchCallback& on_done);
+
+    HttpClientStats stats() const;
+
+private:
+    HttpClientOptions options_;
+
+    CURLSH* share_{nullptr};
+    std::array<std::mutex, CURL_LOCK_DATA_LAST> share_locks_;
+
+    // Idle easy and multi handles, most recently used last
+    std::vector<CURL*> idle_;
+    std::vector<CURLM*> idle_multis_;
+    std::mutex idle_mutex_;
+
+    std::atomic<int64_t> requests_{0};
+    std::atomic<int64_t> failures_{0};
+    std::atomic<int64_t> connects_{0};
+    std::atomic<int64_t> handles_{0};
+    std::atomic<int64_t> total_time_us_{0};
+
+    CURL* acquire();
+    void release(CURL* curl);
+    CURL* create_handle();
+    CURLM* acquire_multi();
+    void release_multi(CURLM* multi);
+
+    HttpResponse perform(CURL* curl, const std::string& url,
+                         const std::vector<std::string>& headers);
+    void record_transfer(CURL* curl, bool ok);
+
+    static void lock_share(CURL* handle, curl_lock_data data, curl_lock_access access, void* user);
+    static void unlock_share(CURL* handle, curl_lock_data data, void* user);
+};
+
+} // namespace arb
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace arb {
+
+// One scalar value as it appeared on the wire
+struct JsonField {
+    std::string_view raw;   // String contents without quotes, or the bare token
+    bool present{false};
+    bool is_string{false};
+};
+
+/**
+ * Forward-only JSON scanner behind the venue parsers' fast paths.
+ *
+ * Works in place over the message: strings and numbers come back as views,
+ * nothing is decoded or allocated. Strings with escapes are refused, and
+ * the caller falls back to its nlohmann path for those, so a frame this
+ * declines is never misread.
+ */
+class JsonScanner {
+public:
+    static constexpr int MAX_DEPTH = 32;
+
+    explicit JsonScanner(std::string_view text) : p_(text.data()), end_(text.data() + text.size()) {}
+
+    void skip_ws() {
+        while (p_ < end_ && is_space(*p_)) ++p_;
+    }
+    bool consume(char c) {
+        skip_ws();
+        if (p_ < end_ && *p_ == c) {
+            ++p_;
+            return true;
+        }
+        return false;
+    }
+    bool at_end() {
+        skip_ws();
+        return p_ == end_;
+    }
+
+    // Opening quote already consumed; escapes are left to the DOM path
+    bool string(std::string_view& out) {
+        const char* start = p_;
+        while (p_ < end_ && *p_ != '"') {
+            if (*p_ == '\\') return false;
+            ++p_;
+        }
+        if (p_ == end_) return false;
+        out = std::string_view(start, static_cast<size_t>(p_ - start));
+        ++p_;
+        return true;
+    }
+
+    // "key": of an object member
+    bool key(std::string_view& out) {
+        return consume('"') && string(out) && consume(':');
+    }
+
+    // A string, number or literal; nested values are not scalars
+    bool scalar(JsonField& out) {
+        skip_ws();
+        if (p_ == end_) return false;
+        out.present = true;
+        if (*p_ == '"') {
+            ++p_;
+            out.is_string = true;
+            return string(out.raw);
+        }
+        out.is_string = false;
+        return bare(out.raw);
+    }
+
+    // Step over any value without decoding it
+    bool skip_value(int depth = 0) {
+        skip_ws();
+        if (p_ == end_ || depth > MAX_DEPTH) return false;
+        char c = *p_;
+        if (c == '"') {
+            ++p_;
+            for (; p_ < end_ && *p_ != '"'; ++p_) {
+                if (*p_ == '\\' && ++p_ == end_) return false;
+            }
+            if (p_ == end_) return false;
+            ++p_;
+            return true;
+        }
+        if (c == '{' || c == '[') {
+            const char close = c == '{' ? '}' : ']';
+            ++p_;
+            if (consume(close)) return true;
+            do {
+                std::string_view ignored;
+                if (c == '{' && !key(ignored)) return false;
+                if (!skip_value(depth + 1)) return false;
+            } while (consume(','));
+            return consume(close);
+        }
+        std::string_view ignored;
+        return bare(ignored);
+    }
+
+private:
+    const char* p_;
+    const char* end_;
+
+    static bool is_space(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    // Number token or true/false/null
+    bool bare(std::string_view& out) {
+        const char* start = p_;
+        if (*p_ == '-' || (*p_ >= '0' && *p_ <= '9')) {
+            while (p_ < end_ && ((*p_ >= '0' && *p_ <= '9') || *p_ == '-' || *p_ == '+' ||
+                                 *p_ == '.' || *p_ == 'e' || *p_ == 'E')) {
+                ++p_;
+            }
+            out = std::string_view(start, static_cast<size_t>(p_ - start));
+            return true;
+        }
+        for (std::string_view literal : {"true", "false", "null"}) {
+            if (static_cast<size_t>(end_ - p_) >= literal.size() &&
+                std::string_view(p_, literal.size()) == literal) {
+                p_ += literal.size();
+                out = literal;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+} // namespace arb
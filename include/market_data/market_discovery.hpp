@@ -0,0 +1,163 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/types.hpp"
+#include "config/config.hpp"
+#include "market_data/polymarket_client.hpp"
+
+namespace arb {
+
+// The markets being traded, as of one discovery pass. Immutable once published.
+struct MarketSet {
+    uint64_t version{0};
+    std::vector<Market> markets;
+    std::vector<BinaryMarketBook*> books;  // Parallel to markets; books are never erased
+};
+
+// Outcome of one MarketDiscovery::refresh()
+struct DiscoveryResult {
+    bool ok{false};       // False if the listing failed part-way; nothing was changed
+    size_t listed{0};     // Live markets matching the pattern
+    size_t added{0};
+    size_t pending{0};    // Of those added, markets subscribed ahead of their open
+    size_t removed{0};
+    PolymarketClient::BookBootstrapResult bootstrap;  // Books of the added markets
+};
+
+/**
+ * Keeps the traded market set in step with Gamma without a restart.
+ *
+ * Each pass pages through the active-market listing, keeps the markets whose
+ * question or slug matches the pattern (all when empty) and whose end date
+ * has not passed, and diffs them against the known set. New markets are
+ * registered, subscribed and bootstrapped from REST. Markets past their end
+ * date are unsubscribed; ones merely missing from the listing only after
+ * MISSED_PASSES_TO_DROP passes in a row, since offset paging can skip a
+ * market when the listing shifts mid-pass. A pass whose listing fails
+ * part-way changes nothing, so a Gamma outage never drops live markets.
+ *
+ * Markets listed before their start date (the next window of a rolling
+ * 15-minute series) are subscribed and bootstrapped straight away but held
+ * back until they open, so their books are warm at the boundary. The
+ * background thread wakes at each start and end date and swaps the opening
+ * market in and the ending one out in a single publish. An extra pass runs
+ * rollover_lead_ms before every 15-minute boundary so the next window is
+ * found in time even with a long discovery interval. Listing passes run on
+ * a helper thread and take the state lock only to merge, so a slow listing
+ * or bootstrap never delays an open or an expiry.
+ *
+ * Each change publishes a new MarketSet. Readers poll version(), a single
+ * atomic load, and only call current() when it moved.
+ */
+class MarketDiscovery {
+public:
+    MarketDiscovery(PolymarketClient& client, const std::string& pattern,
+                    const ConnectionConfig& config);
+    ~MarketDiscovery();
+
+    MarketDiscovery(const MarketDiscovery&) = delete;
+    MarketDiscovery& operator=(const MarketDiscovery&) = delete;
+
+    // Fired once per opened market, when its book first has liquidity on
+    // both legs; open_to_ready is measured from the market's start date.
+    // Runs on the discovery thread or a listing pass. Set before start().
+    using ReadyCallback = std::function<void(const Market& market, Duration open_to_ready)>;
+    void set_ready_callback(ReadyCallback cb) { on_ready_ = std::move(cb); }
+
+    // One pass on the calling thread (e.g. synchronously at startup)
+    DiscoveryResult refresh();
+
+    // Background thread: listing passes every discovery_interval_ms (none
+    // when 0) and before each 15-minute boundary, plus opens and expiries
+    void start();
+    void stop();
+
+    // Bumped whenever the published set changes
+    uint64_t version() const { return version_.load(std::memory_order_acquire); }
+    std::shared_ptr<const MarketSet> current() const;
+
+    // Stats
+    int64_t refreshes() const { return refreshes_.load(); }
+    int64_t failed_refreshes() const { return failed_refreshes_.load(); }
+    int64_t markets_added() const { return markets_added_.load(); }
+    int64_t markets_removed() const { return markets_removed_.load(); }
+    int64_t markets_opened() const { return markets_opened_.load(); }
+    int64_t last_open_to_ready_ms() const { return last_open_to_ready_ms_.load(); }  // -1 until one opens
+    size_t pending_markets() const;
+
+private:
+    PolymarketClient& client_;
+    std::string pattern_;
+    std::optional<std::regex> filter_;  // Unset: every market matches
+    std::chrono::milliseconds interval_;
+    std::chrono::milliseconds lead_;
+    size_t page_size_;
+
+    // Longest background sleep, and the readiness poll while an opened
+    // market's book is still empty: it starts tight at the open and doubles
+    // on every miss, so a book that stays one-sided isn't polled 500x/s
+    static constexpr auto MAX_IDLE = std::chrono::seconds(1);
+    static constexpr auto READY_POLL = std::chrono::milliseconds(2);
+    static constexpr auto MAX_READY_POLL = std::chrono::milliseconds(250);
+    // Consecutive listings a market must be missing from before it is dropped
+    static constexpr int MISSED_PASSES_TO_DROP = 2;
+
+    // By condition ID; guarded by refresh_mutex_
+    std::map<std::string, Market> known_;    // Open and traded
+    std::map<std::string, Market> pending_;  // Subscribed, waiting for their start date
+    struct AwaitingReady {
+        Market market;
+        BinaryMarketBook* book;
+    };
+    std::vector<AwaitingReady> awaiting_ready_;  // Opened, book not yet tradeable
+    std::chrono::milliseconds ready_poll_{READY_POLL};
+    std::map<std::string, int> missed_passes_;   // Known or pending, absent from the last listings
+    WallClock lead_boundary_{};                  // Boundary the last lead pass ran for
+    mutable std::mutex refresh_mutex_;
+    std::mutex pass_mutex_;  // Serializes refresh() calls, held across the listing
+
+    ReadyCallback on_ready_;
+
+    std::shared_ptr<const MarketSet> current_;
+    mutable std::mutex current_mutex_;
+    std::atomic<uint64_t> version_{0};
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cv_;
+    bool poked_{false};  // Guarded by wait_mutex_; a listing pass finished
+    std::thread refresh_thread_;  // Background listing pass
+    std::atomic<bool> refreshing_{false};
+
+    std::atomic<int64_t> refreshes_{0};
+    std::atomic<int64_t> failed_refreshes_{0};
+    std::atomic<int64_t> markets_added_{0};
+    std::atomic<int64_t> markets_removed_{0};
+    std::atomic<int64_t> markets_opened_{0};
+    std::atomic<int64_t> last_open_to_ready_ms_{-1};
+
+    bool matches(const Market& market) const;
+    void unsubscribe(const Market& market);
+
+    // Assume refresh_mutex_ is held
+    bool roll(WallClock wall);  // Open due pending markets, drop ended ones
+    void check_ready(WallClock wall);
+    WallClock next_wake(WallClock wall, WallClock next_refresh) const;
+    void publish();
+
+    void run();
+    void start_refresh();
+};
+
+} // namespace arb
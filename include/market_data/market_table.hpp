@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "common/types.hpp"
+#include "market_data/order_book.hpp"
+
+namespace arb {
+
+/**
+ * Top of book for every subscribed binary market, stored column-wise.
+ *
+ * Each field is its own array indexed by MarketHandle, so a cross-market
+ * scan streams through contiguous doubles instead of chasing one
+ * BinaryMarketBook per market. The trading loop owns the table: it refreshes
+ * the rows of the markets BookHandoff reports as moved, screens all markets
+ * in one pass and only evaluates the rows that come back. Feed threads never
+ * touch it, so it takes no lock. Not thread-safe.
+ *
+ * A leg with no asks stores NO_ASK (1.0): with fee(1.0) = 0 such a row can
+ * never show positive edge, so the kernel needs no validity mask. Asks are
+ * also kept as 32-bit ticks of PRICE_SCALE. The screen runs on those, and
+ * every row it passes is confirmed with fixed_pair_edge(), so the result
+ * agrees bit for bit with the strategy's own edge.
+ */
+class MarketTable {
+public:
+    static constexpr Price NO_ASK = 1.0;
+    static constexpr FixedScale PRICE_SCALE = POLYMARKET_PRICE_SCALE;
+
+    struct Row {
+        Price yes_bid{0.0};
+        Size yes_bid_size{0.0};
+        Price yes_ask{NO_ASK};
+        Size yes_ask_size{0.0};
+        Price no_bid{0.0};
+        Size no_bid_size{0.0};
+        Price no_ask{NO_ASK};
+        Size no_ask_size{0.0};
+    };
+
+    // Overwrite one leg of a market from its book's top
+    void update(MarketHandle market, bool is_yes, const TopOfBook& top);
+    // Overwrite both legs from one snapshot of the market's books
+    void update(const BinaryMarketBook& book);
+
+    // Copy of one row (default row for markets never updated)
+    Row row(MarketHandle market) const;
+
+    // Rows allocated (highest handle seen + 1)
+    size_t size() const;
+
+    // Markets whose best-ask S2 edge, after the parabolic fee on both legs,
+    // is >= min_edge_cents. Handles are appended to out in ascending order;
+    // returns the number appended.
+    size_t scan_underpriced(int64_t fee_rate_ppm, double min_edge_cents,
+                            std::vector<MarketHandle>& out) const;
+
+private:
+    std::vector<Price> yes_bid_;
+    std::vector<Size> yes_bid_size_;
+    std::vector<Price> yes_ask_;
+    std::vector<Size> yes_ask_size_;
+    std::vector<Price> no_bid_;
+    std::vector<Size> no_bid_size_;
+    std::vector<Price> no_ask_;
+    std::vector<Size> no_ask_size_;
+    std::vector<int32_t> yes_ask_ticks_;  // yes_ask_ and no_ask_ on PRICE_SCALE's grid
+    std::vector<int32_t> no_ask_ticks_;
+
+    // Scan scratch, reused across calls
+    mutable std::vector<double> edge_scratch_;
+
+    void grow(size_t rows);
+    void set_leg(MarketHandle market, bool is_yes, const std::optional<PriceLevel>& best_bid,
+                 const std::optional<PriceLevel>& best_ask);
+};
+
+// Kernel behind scan_underpriced: edge[i] = fixed_pair_edge(yes_ask[i], no_ask[i])
+// on scale's grid, evaluated in doubles. Every intermediate is an integer
+// below 2^53 at POLYMARKET_PRICE_SCALE, so the result is exact there.
+// Branch-free over plain 32-bit arrays so GCC vectorizes it at baseline
+// x86-64; the market_table_kernel_vectorized test fails if it stops doing so.
+void underpriced_edges(const int32_t* yes_ask, const int32_t* no_ask, size_t n,
+                       const FixedScale& scale, int64_t fee_rate_ppm, double* edge);
+
+} // namespace arb
@@ -1,20 +1,138 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <map>
 #include <vector>
 #include <mutex>
+#include <atomic>
 #include <optional>
+#include <span>
 #include "common/types.hpp"
+#include "common/fixed_point.hpp"
+#include "market_data/tick_ladder.hpp"
 
 namespace arb {
 
+/**
+ * Level storage used by an OrderBook.
+ * MAP works for any price; TICK_ARRAY requires prices on a fixed tick grid
+ * (Polymarket binaries) and trades generality for flat-array updates.
+ */
+enum class OrderBookImpl {
+    MAP,
+    TICK_ARRAY
+};
+
+// "map" or "tick" (config values); unknown strings fall back to MAP
+OrderBookImpl order_book_impl_from_string(const std::string& s);
+std::string order_book_impl_to_string(OrderBookImpl impl);
+
+/**
+ * One level change in a batch: BUY updates a bid, SELL an ask; size 0 removes.
+ */
+struct LevelDelta {
+    Side side{Side::BUY};
+    Price price{0.0};
+    Size size{0.0};
+};
+
+/**
+ * What a batch of deltas did to the top of book.
+ */
+struct DeltaResult {
+    bool bid_price_changed{false};
+    bool ask_price_changed{false};
+    bool top_size_changed{false};  // Best size moved at an unchanged best price
+    bool stale{false};             // Older than the book's sequence; nothing applied
+
+    bool top_changed() const { return bid_price_changed || ask_price_changed || top_size_changed; }
+};
+
+/**
+ * Result of sweeping one side of a book for a target size.
+ */
+struct SweepQuote {
+    Size filled{0.0};        // Less than requested when the side runs out
+    Notional cost{0.0};      // Sum of price * size over the filled quantity
+    Price worst_price{0.0};  // Deepest level touched
+    int levels{0};           // Number of levels touched
+
+    Price vwap() const { return filled > 0.0 ? cost / filled : 0.0; }
+    bool complete(Size requested) const { return filled >= requested; }
+};
+
+/**
+ * Consistent top-of-book view of one OrderBook.
+ * Produced by OrderBook::top_of_book() without taking the book mutex.
+ */
+struct TopOfBook {
+    std::optional<PriceLevel> best_bid;
+    std::optional<PriceLevel> best_ask;
+    Size bid_depth{0.0};  // Summed over the book's top max_levels levels
+    Size ask_depth{0.0};
+    Timestamp last_update;
+    uint64_t sequence{0};
+
+    bool has_liquidity() const { return best_bid.has_value() && best_ask.has_value(); }
+
+    Price spread() const {
+        if (!best_bid || !best_ask) return 0.0;
+        return best_ask->price - best_bid->price;
+    }
+
+    Price mid_price() const {
+        if (!best_bid || !best_ask) return 0.0;
+        return (best_bid->price + best_ask->price) / 2.0;
+    }
+};
+
+/**
+ * Value copy of the top levels of one OrderBook, taken without the book mutex.
+ */
+struct BookLevels {
+    // Levels published per side; BinaryMarketBook's legs keep views this
+    // deep, so a snapshot sees everything their aggregates do
+    static constexpr int MAX_LEVELS = 10;
+
+    std::array<PriceLevel, MAX_LEVELS> bids{};
+    std::array<PriceLevel, MAX_LEVELS> asks{};
+    int bid_count{0};
+    int ask_count{0};
+    Timestamp last_update;
+    uint64_t sequence{0};
+
+    std::optional<PriceLevel> best_bid() const {
+        if (bid_count == 0) return std::nullopt;
+        return bids[0];
+    }
+
+    std::optional<PriceLevel> best_ask() const {
+        if (ask_count == 0) return std::nullopt;
+        return asks[0];
+    }
+
+    bool has_liquidity() const { return bid_count > 0 && ask_count > 0; }
+
+    Price spread() const {
+        if (!has_liquidity()) return 0.0;
+        return asks[0].price - bids[0].price;
+    }
+};
+
 /**
  * Thread-safe order book implementation maintaining sorted price levels.
  * Supports both Polymarket (binary outcomes) and general use.
+ *
+ * The ladder keeps every level the feed sends, so levels below the top
+ * come back into view when better ones are pulled. max_levels caps only
+ * the derived views: depth, notional, sweep() and top_bids()/top_asks().
  */
 class OrderBook {
 public:
     explicit OrderBook(const std::string& symbol, int max_levels = 10);
+    OrderBook(const std::string& symbol, int max_levels, OrderBookImpl impl,
+              Price tick_size = 0.01);
 
     // Update methods
     void update_bid(Price price, Size size);
@@ -24,8 +142,22 @@ public:
     // Full snapshot update
     void apply_snapshot(const std::vector<PriceLevel>& bids,
                        const std::vector<PriceLevel>& asks);
+    // Same, from a feed's level list: BUY levels are bids, SELL levels asks
+    void apply_snapshot(std::span<const LevelDelta> levels);
+    // Same, stamped with sequence under the same lock. False, leaving the
+    // book alone, if it is already past sequence; 0 always applies.
+    bool apply_snapshot(std::span<const LevelDelta> levels, uint64_t sequence);
 
-    // Query methods (thread-safe)
+    // Apply a message's worth of level changes under one lock acquisition,
+    // rebuilding the views and publishing once. sequence 0 leaves the sequence unchanged;
+    // a non-zero sequence older than the book's drops the batch as stale.
+    DeltaResult apply_deltas(std::span<const LevelDelta> deltas, uint64_t sequence = 0);
+
+    // Lock-free top-of-book read for hot paths. Every mutation republishes
+    // the view under a seqlock; readers retry instead of blocking the writer.
+    TopOfBook top_of_book() const;
+
+    // Query methods (thread-safe, take the book mutex)
     std::optional<PriceLevel> best_bid() const;
     std::optional<PriceLevel> best_ask() const;
     Price mid_price() const;
@@ -36,10 +168,17 @@ public:
     std::vector<PriceLevel> top_bids(int n) const;
     std::vector<PriceLevel> top_asks(int n) const;
 
-    // Liquidity queries
+    // Liquidity queries, O(1) from running totals
     Size bid_depth(int levels) const;
     Size ask_depth(int levels) const;
     Size total_depth(int levels) const;
+    Notional bid_notional(int levels) const;
+    Notional ask_notional(int levels) const;
+
+    // Take `size` from the book: BUY sweeps asks, SELL sweeps bids.
+    // O(log levels) binary search over the running totals.
+    SweepQuote sweep(Side side, Size size) const;
+    Price vwap_to_size(Side side, Size size) const;  // 0.0 if the side is empty
 
     // Staleness check
     Timestamp last_update_time() const;
@@ -47,25 +186,162 @@ public:
 
     // Symbol accessor
     const std::string& symbol() const { return symbol_; }
+    OrderBookImpl impl() const { return impl_; }
+
+    // Updates dropped because the price was off the tick grid (TICK_ARRAY only)
+    int64_t rejected_updates() const { return rejected_updates_.load(std::memory_order_relaxed); }
 
     // Sequence number for ordering
-    void set_sequence(uint64_t seq) { sequence_ = seq; }
-    uint64_t sequence() const { return sequence_; }
+    void set_sequence(uint64_t seq);
+    uint64_t sequence() const { return top_sequence_.load(std::memory_order_acquire); }
 
 private:
     std::string symbol_;
     int max_levels_;
+    OrderBookImpl impl_{OrderBookImpl::MAP};
     uint64_t sequence_{0};
+    std::atomic<int64_t> rejected_updates_{0};  // Written under the book lock, read from anywhere
     Timestamp last_update_;
 
+    // MAP storage, keyed by integer price at BOOK_KEY_SCALE so equal prices
+    // always hit the same level and compares are integer compares
     // Bids sorted descending (highest first)
-    std::map<Price, Size, std::greater<Price>> bids_;
+    std::map<Ticks, Size, std::greater<Ticks>> bids_;
     // Asks sorted ascending (lowest first)
-    std::map<Price, Size> asks_;
+    std::map<Ticks, Size> asks_;
+
+    // TICK_ARRAY storage
+    TickLadder tick_bids_;
+    TickLadder tick_asks_;
+
+    // Top max_levels_ levels of one side, best first, with running size/notional
+    // totals so depth and sweep queries never walk the level storage.
+    // Rebuilt for the touched side on every mutation (at most max_levels_).
+    struct SideAggregates {
+        std::vector<PriceLevel> levels;
+        std::vector<Size> cum_size;          // cum_size[i] = sizes of levels 0..i
+        std::vector<Notional> cum_notional;  // Same for price * size
+
+        void clear() {
+            levels.clear();
+            cum_size.clear();
+            cum_notional.clear();
+        }
+
+        void push(Price price, Size size) {
+            levels.push_back({price, size});
+            cum_size.push_back((cum_size.empty() ? 0.0 : cum_size.back()) + size);
+            cum_notional.push_back((cum_notional.empty() ? 0.0 : cum_notional.back()) + price * size);
+        }
+
+        Size depth(int n) const {
+            int k = std::min(n, static_cast<int>(cum_size.size()));
+            return k > 0 ? cum_size[k - 1] : 0.0;
+        }
+
+        Notional notional(int n) const {
+            int k = std::min(n, static_cast<int>(cum_notional.size()));
+            return k > 0 ? cum_notional[k - 1] : 0.0;
+        }
+    };
+    SideAggregates bid_agg_;
+    SideAggregates ask_agg_;
 
     mutable std::mutex mutex_;
 
-    void trim_levels();
+    // Seqlock-published top levels. Odd version = write in progress.
+    // Fields are relaxed atomics so torn reads are detected, not UB.
+    std::atomic<uint64_t> top_version_{0};
+    std::array<std::atomic<Price>, BookLevels::MAX_LEVELS> top_bid_prices_{};
+    std::array<std::atomic<Size>, BookLevels::MAX_LEVELS> top_bid_sizes_{};
+    std::array<std::atomic<Price>, BookLevels::MAX_LEVELS> top_ask_prices_{};
+    std::array<std::atomic<Size>, BookLevels::MAX_LEVELS> top_ask_sizes_{};
+    std::atomic<int> top_bid_count_{0};
+    std::atomic<int> top_ask_count_{0};
+    std::atomic<Size> top_bid_depth_{0.0};
+    std::atomic<Size> top_ask_depth_{0.0};
+    std::atomic<int64_t> top_update_ns_{0};
+    std::atomic<uint64_t> top_sequence_{0};
+
+    // Helpers below assume mutex_ is held
+    std::optional<PriceLevel> peek_bid() const;
+    std::optional<PriceLevel> peek_ask() const;
+    void rebuild_bids();
+    void rebuild_asks();
+    void publish_top();
+    void set_bid(Price price, Size size);
+    void set_ask(Price price, Size size);
+    template <typename Fn> void for_each_bid(int n, Fn&& fn) const;
+    template <typename Fn> void for_each_ask(int n, Fn&& fn) const;
+    void replace_levels(std::span<const LevelDelta> levels);  // Snapshot body, unpublished
+
+    // Seqlock read side. read_begin() waits out an in-flight write and returns
+    // the version; load_levels() copies published fields with no ordering of
+    // its own; read_validate() is true if no write overlapped the copy.
+    // BinaryMarketBook brackets both legs with these for a joint snapshot.
+    friend class BinaryMarketBook;
+    uint64_t read_begin() const;
+    void load_levels(BookLevels& out, int levels) const;
+    bool read_validate(uint64_t version) const;
+};
+
+/**
+ * Result of walking the YES and NO ask ladders together (S2 sizing).
+ * Each pair of shares pays out 1.0 and is charged the parabolic fee
+ * price * (1 - price) * fee_rate on both legs.
+ */
+struct PairedSweep {
+    Size size{0.0};                   // Paired shares whose marginal edge clears the threshold
+    Notional yes_cost{0.0};
+    Notional no_cost{0.0};
+    Notional fees{0.0};
+    Price yes_worst_price{0.0};       // Limit prices that reach the swept size
+    Price no_worst_price{0.0};
+    int yes_levels{0};
+    int no_levels{0};
+    double marginal_edge_cents{0.0};  // Per-pair edge on the last share taken
+
+    // Average per-pair edge in cents over the swept size
+    double avg_edge_cents() const {
+        if (size <= 0.0) return 0.0;
+        return (size - yes_cost - no_cost - fees) / size * 100.0;
+    }
+};
+
+// Largest paired size whose marginal edge (cents per pair, after fees on both
+// legs) stays >= min_edge_cents, within the ladders given. Ladders are
+// best-first; from a BinaryBookSnapshot that is BookLevels::MAX_LEVELS per
+// leg, the books' view depth, so a pair still profitable below it is not
+// counted. Per-share cost
+// p + p(1-p)*fee_rate rises with p, so the marginal edge never improves
+// deeper in the book and the walk stops at the first failing pair. Each
+// pair's edge is fixed_pair_edge() on scale's grid, so the stopping point
+// is the same on every replay.
+PairedSweep sweep_paired_asks(std::span<const PriceLevel> yes_asks,
+                              std::span<const PriceLevel> no_asks,
+                              int64_t fee_rate_ppm, double min_edge_cents,
+                              const FixedScale& scale = POLYMARKET_PRICE_SCALE);
+
+/**
+ * Both legs of a binary market captured at one instant.
+ * Plain value: strategies evaluate from it without touching the books again.
+ */
+struct BinaryBookSnapshot {
+    BookLevels yes;
+    BookLevels no;
+
+    bool has_liquidity() const { return yes.has_liquidity() && no.has_liquidity(); }
+
+    double sum_of_best_asks() const {
+        if (yes.ask_count == 0 || no.ask_count == 0) return 0.0;
+        return yes.asks[0].price + no.asks[0].price;
+    }
+
+    PairedSweep paired_ask_sweep(int64_t fee_rate_ppm, double min_edge_cents) const {
+        return sweep_paired_asks({yes.asks.data(), static_cast<size_t>(yes.ask_count)},
+                                 {no.asks.data(), static_cast<size_t>(no.ask_count)},
+                                 fee_rate_ppm, min_edge_cents);
+    }
 };
 
 /**
@@ -73,13 +349,19 @@ private:
  */
 class BinaryMarketBook {
 public:
-    explicit BinaryMarketBook(const std::string& market_id);
+    explicit BinaryMarketBook(const std::string& market_id,
+                              OrderBookImpl impl = OrderBookImpl::MAP,
+                              Price tick_size = 0.01);
 
     OrderBook& yes_book() { return yes_book_; }
     OrderBook& no_book() { return no_book_; }
     const OrderBook& yes_book() const { return yes_book_; }
     const OrderBook& no_book() const { return no_book_; }
 
+    // Top levels and sequence numbers of both legs from the same instant,
+    // without taking either book mutex. levels is clamped to MAX_LEVELS.
+    BinaryBookSnapshot snapshot(int levels = BookLevels::MAX_LEVELS) const;
+
     // Sum of best asks (for underpricing detection)
     double sum_of_best_asks() const;
 
@@ -96,9 +378,23 @@ public:
     bool is_stale(Duration threshold) const;
 
     const std::string& market_id() const { return market_id_; }
+    MarketHandle market_handle() const { return market_handle_; }
+
+    // Token handles of the two legs, set when the market is registered with
+    // the feed. Until then they are NO_SYMBOL and the token IDs fall back to
+    // the book symbols. A market that drops out and is listed again is
+    // re-registered while the trading loop may be reading them, hence atomic.
+    void set_tokens(TokenHandle yes_token, TokenHandle no_token);
+    TokenHandle yes_token() const { return yes_token_.load(std::memory_order_relaxed); }
+    TokenHandle no_token() const { return no_token_.load(std::memory_order_relaxed); }
+    const std::string& yes_token_id() const;
+    const std::string& no_token_id() const;
 
 private:
     std::string market_id_;
+    MarketHandle market_handle_{NO_SYMBOL};
+    std::atomic<TokenHandle> yes_token_{NO_SYMBOL};
+    std::atomic<TokenHandle> no_token_{NO_SYMBOL};
     OrderBook yes_book_;
     OrderBook no_book_;
 };
@@ -5,50 +5,90 @@
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
 #include <map>
+#include <set>
+#include <string_view>
 #include <vector>
 #include <nlohmann/json.hpp>
 #include "common/types.hpp"
+#include "common/fixed_point.hpp"
 #include "config/config.hpp"
 #include "market_data/order_book.hpp"
+#include "market_data/http_client.hpp"
+#include "market_data/polymarket_parser.hpp"
+#include "market_data/subscription_shards.hpp"
+#include "market_data/ws_client_base.hpp"
 
 namespace arb {
 
 /**
  * Polymarket CLOB client for market data and order management.
  * Connects to both REST API for market discovery and WebSocket for real-time updates.
+ * The WebSocket transport lives in WebSocketClientBase.
+ *
+ * With polymarket_shards > 1 the market channel is split over several
+ * connections, each parsing on its own thread. SubscriptionShards decides
+ * which tokens each shard carries. Shards look up token routes under a
+ * shared lock and update each book under that book's own lock, so updates
+ * to different books run in parallel.
  */
-class PolymarketClient {
+class PolymarketClient : public WebSocketClientBase {
 public:
-    using BookCallback = std::function<void(const std::string& market_id, const std::string& token_id)>;
+    // Fired on snapshots, and on deltas only when the token's top of book moved.
+    // Handles resolve back to IDs through SymbolRegistry. Runs on whichever
+    // feed or REST thread applied the update (shard loops, bootstrap, resync,
+    // discovery), possibly concurrently; don't assume any lock is held.
+    using BookCallback = std::function<void(MarketHandle market, TokenHandle token)>;
     using TradeCallback = std::function<void(const Fill&)>;
-    using StatusCallback = std::function<void(ConnectionStatus)>;
-    using ErrorCallback = std::function<void(const std::string&)>;
 
     explicit PolymarketClient(const ConnectionConfig& config);
-    ~PolymarketClient();
+    ~PolymarketClient() override;
 
     // Market discovery (REST)
-    std::vector<Market> fetch_markets();  // Fetch all active markets
+    std::vector<Market> fetch_markets();  // Fetch all active markets, page by page
+    // One page of active markets from Gamma. False on transport or format
+    // errors; page_items is the raw item count, so a short page ends the listing.
+    bool fetch_markets_page(size_t offset, size_t limit, std::vector<Market>& out, size_t& page_items);
     std::vector<Market> fetch_filtered_markets(const std::string& pattern);  // Filtered by regex pattern (empty = all)
     std::optional<Market> fetch_market(const std::string& condition_id);
 
-    // Order book (REST)
-    void fetch_order_book(const std::string& token_id, OrderBook& book);
+    // Outcome of one bootstrap_books() batch
+    struct BookBootstrapResult {
+        size_t requested{0};
+        size_t loaded{0};                 // Snapshots applied (or already newer from the feed)
+        size_t failed{0};                 // Transport, HTTP status or parse failures
+        size_t markets_ready{0};          // Markets whose YES and NO books both loaded
+        Duration elapsed{0};
+        std::optional<Timestamp> first_tradeable;  // When the first market became ready
+    };
+
+    // Fetch REST snapshots for registered tokens concurrently and apply each
+    // as its response arrives (empty = every registered token). Concurrency
+    // and request rate come from ConnectionConfig. Blocks until done.
+    BookBootstrapResult bootstrap_books(const std::vector<TokenHandle>& tokens = {});
 
-    // WebSocket connection
-    void connect();
-    void disconnect();
+    // Route a market's YES/NO tokens to its book. Call before subscribing,
+    // otherwise WebSocket updates for those tokens are dropped.
+    void register_market(const Market& market);
 
-    // Subscribe to market updates
+    // WebSocket connection (also runs the resync thread)
+    void connect() override;
+    void disconnect() override;
+
+    // Subscribe to market updates. Subscriptions are remembered and re-sent
+    // after every (re)connect, so they may be made before connect(). Register
+    // the market first so its tokens shard together.
     void subscribe_market(const std::string& token_id);
     void unsubscribe_market(const std::string& token_id);
+    // The same for many tokens, in as few messages as subscribe_batch_size allows
+    void subscribe_markets(const std::vector<std::string>& token_ids);
+    void unsubscribe_markets(const std::vector<std::string>& token_ids);
 
     // Callbacks
     void set_book_callback(BookCallback cb) { on_book_update_ = std::move(cb); }
     void set_trade_callback(TradeCallback cb) { on_trade_ = std::move(cb); }
-    void set_status_callback(StatusCallback cb) { on_status_ = std::move(cb); }
-    void set_error_callback(ErrorCallback cb) { on_error_ = std::move(cb); }
 
     // Order management (for paper/live trading)
     struct OrderRequest {
@@ -71,39 +111,74 @@ public:
     bool cancel_order(const std::string& order_id);
     std::vector<Fill> get_trades(const std::string& market_id);
 
-    // Get book reference (for direct access)
+    // Get book reference (for direct access); creates the book if needed
     BinaryMarketBook* get_market_book(const std::string& market_id);
-
-    // Status
-    ConnectionStatus status() const { return status_.load(); }
-    bool is_connected() const { return status_.load() == ConnectionStatus::CONNECTED; }
+    BinaryMarketBook* get_market_book(MarketHandle market);
 
     // Stats
-    int64_t messages_received() const { return messages_received_.load(); }
+    int64_t deltas_applied() const { return deltas_applied_.load(); }
+    int64_t resyncs_requested() const { return resyncs_requested_.load(); }
+    int64_t json_fallbacks() const { return json_fallbacks_.load(); }
+    size_t shard_tokens(size_t shard) const;
+    int64_t shard_moves() const;  // Market groups moved between shards to rebalance
+    HttpClientStats http_stats() const { return http_.stats(); }
     Timestamp last_update_time() const;
 
     // API credentials (from environment)
     void set_api_credentials(const std::string& key, const std::string& secret, const std::string& passphrase);
     bool has_credentials() const { return !api_key_.empty(); }
 
+protected:
+    void on_open(size_t shard) override;
+    void handle_message(size_t shard, std::string_view msg, Timestamp recv_time) override;
+
 private:
     ConnectionConfig config_;
 
+    // REST calls share pooled keep-alive connections
+    HttpClient http_;
+
     BookCallback on_book_update_;
     TradeCallback on_trade_;
-    StatusCallback on_status_;
-    ErrorCallback on_error_;
-
-    std::atomic<ConnectionStatus> status_{ConnectionStatus::DISCONNECTED};
     std::atomic<bool> running_{false};
-    std::thread recv_thread_;
 
-    // Market books keyed by market_id
-    std::map<std::string, std::unique_ptr<BinaryMarketBook>> market_books_;
-    std::mutex books_mutex_;
+    // Don't move markets between shards for less than this imbalance (in tokens)
+    static constexpr size_t SHARD_REBALANCE_SLACK = 4;
+    SubscriptionShards subscriptions_;
+    mutable std::mutex subscriptions_mutex_;
+
+    // Market books indexed by MarketHandle (null where no book was created).
+    // books_mutex_ guards this table and token_to_market_, not the books:
+    // books are never erased, so a pointer looked up under it stays valid.
+    std::vector<std::unique_ptr<BinaryMarketBook>> market_books_;
+    mutable std::shared_mutex books_mutex_;
+
+    // Token to market routing, indexed by TokenHandle
+    struct TokenRoute {
+        MarketHandle market{NO_SYMBOL};  // NO_SYMBOL = token not registered
+        bool is_yes{true};
+    };
+    std::vector<TokenRoute> token_to_market_;
 
-    // Token ID to market ID mapping
-    std::map<std::string, std::string> token_to_market_;
+    // Fixed-point wire parsing (null = strtod), see ConnectionConfig::fixed_point_prices
+    const FixedScale* price_scale_{nullptr};
+    const FixedScale* size_scale_{nullptr};
+
+    // Touched only by the shard's own loop thread
+    struct ShardState {
+        PolymarketMessage msg_buf;  // Reused for every WebSocket message
+        bool opened_once{false};
+    };
+    std::vector<ShardState> shard_state_;
+
+    // REST resync of individual tokens whose book diverged from the feed.
+    // Runs off the feed thread so a slow snapshot fetch never stalls deltas.
+    static constexpr auto RESYNC_MIN_INTERVAL = std::chrono::seconds(1);
+    std::thread resync_thread_;
+    std::set<TokenHandle> resync_pending_;
+    std::map<TokenHandle, Timestamp> last_resync_;
+    std::mutex resync_mutex_;
+    std::condition_variable resync_cv_;
 
     // API credentials
     std::string api_key_;
@@ -111,32 +186,34 @@ private:
     std::string api_passphrase_;
 
     // Stats
-    std::atomic<int64_t> messages_received_{0};
-    Timestamp last_update_time_;
-    mutable std::mutex time_mutex_;
+    std::atomic<int64_t> deltas_applied_{0};
+    std::atomic<int64_t> resyncs_requested_{0};
+    std::atomic<int64_t> json_fallbacks_{0};
+
+    void apply_book(const PolymarketMessage& msg);
+    void apply_price_change(const PolymarketMessage& msg);
+    void apply_trade(const PolymarketMessage& msg, Timestamp recv_time);
 
-    // Socket handles
-    void* socket_{nullptr};
-    void* ssl_ctx_{nullptr};
-    void* ssl_{nullptr};
+    // Apply a REST snapshot unless the feed already delivered a newer one.
+    // False if the token has no book; otherwise sets its market and leg.
+    bool apply_rest_snapshot(TokenHandle token, const PolymarketMessage& msg,
+                             MarketHandle& market, bool& is_yes);
 
-    void run_connection_loop();
-    void parse_message(const std::string& msg, Timestamp recv_time);
-    void parse_book_message(const nlohmann::json& data, Timestamp recv_time);
-    void parse_price_change(const nlohmann::json& data, Timestamp recv_time);
-    void parse_trade_message(const nlohmann::json& data, Timestamp recv_time);
+    // Token's book, market and leg, looked up under a shared books_mutex_
+    OrderBook* find_token_book(TokenHandle token, MarketHandle& market, bool& is_yes) const;
+    // Assumes books_mutex_ is held exclusively
+    BinaryMarketBook* book_for(MarketHandle market);
+
+    // Send staged subscription changes; assumes subscriptions_mutex_ is held
+    void commit_subscriptions();
+
+    void request_resync(TokenHandle token);
+    void run_resync_loop();
 
     // HTTP helpers for REST API
     std::string http_get(const std::string& url);
     std::string http_post(const std::string& url, const std::string& body);
 
-    // Low-level socket operations
-    bool connect_socket();
-    void disconnect_socket();
-    bool send_raw(const std::string& data);
-    std::string recv_frame();
-    void send_pong(const std::string& payload);
-
     // Authentication header generation
     std::string generate_l2_signature(const std::string& timestamp, const std::string& method,
                                        const std::string& path, const std::string& body);
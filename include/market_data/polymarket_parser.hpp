@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "common/types.hpp"
+#include "common/fixed_point.hpp"
+#include "market_data/order_book.hpp"
+
+namespace arb {
+
+// One entry of a price_change message's "price_changes" array
+struct PolymarketChange {
+    TokenHandle token{NO_SYMBOL};  // "asset_id"; NO_SYMBOL if never registered
+    uint32_t level{0};             // Index of this entry's delta in PolymarketMessage::levels
+    bool has_level{false};         // false when side or price was unusable
+    bool has_top{false};           // Entry carried both best_bid and best_ask
+    Price best_bid{0.0};
+    Price best_ask{0.0};
+};
+
+/**
+ * One Polymarket market-channel event, flattened.
+ *
+ * Meant to be reused across messages: parsing clears it but keeps the
+ * vectors' and asset_id's capacity, so a warmed-up message never allocates.
+ */
+struct PolymarketMessage {
+    enum class Kind { NONE, BOOK, PRICE_CHANGE, TRADE };
+
+    Kind kind{Kind::NONE};          // NONE: an event type we don't use
+    std::string asset_id;           // Top-level "asset_id" (book, trade, legacy price_change)
+    TokenHandle token{NO_SYMBOL};   // asset_id resolved through SymbolRegistry
+    int64_t timestamp_ms{0};        // "timestamp"; 0 if absent
+
+    // BOOK: bids (BUY) then asks (SELL), levels with price <= 0 dropped.
+    // PRICE_CHANGE: every usable {price, size, side} change in wire order.
+    std::vector<LevelDelta> levels;
+
+    // PRICE_CHANGE in the current shape; empty for the legacy "changes" shape
+    std::vector<PolymarketChange> changes;
+    bool has_price_changes{false};
+
+    // TRADE ("last_trade_price")
+    Price price{0.0};
+    Size size{0.0};
+    Side side{Side::SELL};
+
+    void reset();
+
+    // Deltas of changes[first, last), which are contiguous in levels
+    std::span<const LevelDelta> change_levels(size_t first, size_t last) const;
+};
+
+/**
+ * On-demand parser for Polymarket's market channel (book, price_change,
+ * last_trade_price).
+ *
+ * One forward scan over the frame: keys are matched in place, book levels
+ * and changes go straight into out.levels as LevelDeltas, and decimal
+ * strings are parsed onto price_scale / size_scale when non-null (the
+ * double nearest the decimal otherwise). Fields outside the schema are
+ * skipped without being decoded. Returns false for what it won't handle
+ * (escaped ids, exponents, top-level arrays, mixed shapes); callers then
+ * fall back to parse_polymarket_message_json().
+ */
+bool parse_polymarket_message(std::string_view msg, const FixedScale* price_scale,
+                              const FixedScale* size_scale, PolymarketMessage& out);
+
+// Reference nlohmann path with identical results on every message both accept
+bool parse_polymarket_message_json(std::string_view msg, const FixedScale* price_scale,
+                                   const FixedScale* size_scale, PolymarketMessage& out);
+
+// REST /book response: a book event without event_type. Tries the scanner,
+// then the nlohmann path; out.kind is BOOK on success.
+bool parse_polymarket_book(std::string_view body, const FixedScale* price_scale,
+                           const FixedScale* size_scale, PolymarketMessage& out);
+
+} // namespace arb
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+
+namespace arb {
+
+/**
+ * Process-wide cache of resolved host:port addresses.
+ *
+ * The first resolve() of an endpoint blocks in getaddrinfo; after that
+ * lookup() answers from memory, so a reconnect goes straight to connect().
+ * A background thread re-resolves every cached endpoint on an interval so
+ * DNS changes are picked up without putting a lookup on the reconnect path.
+ * A failed refresh keeps the old address; invalidate() drops an entry whose
+ * address stopped accepting connections.
+ *
+ * Every address getaddrinfo returns is kept. Callers pass an index to pick
+ * one (modulo the count), which lets redundant connections to one host
+ * take different network paths.
+ */
+class ResolverCache {
+public:
+    struct Address {
+        sockaddr_storage addr{};
+        socklen_t len{0};
+    };
+
+    ResolverCache();
+    ~ResolverCache();
+
+    ResolverCache(const ResolverCache&) = delete;
+    ResolverCache& operator=(const ResolverCache&) = delete;
+
+    // Cache shared by the feed connections
+    static ResolverCache& instance();
+
+    // Never blocks; false on a miss
+    bool lookup(const std::string& host, int port, Address& out, size_t index = 0);
+    // Blocking getaddrinfo; caches the result on success
+    bool resolve(const std::string& host, int port, Address& out, size_t index = 0);
+    void invalidate(const std::string& host, int port);
+
+    // Background refresh period (0 = never refresh)
+    void set_refresh_interval(std::chrono::milliseconds interval);
+
+    // Stats
+    int64_t hits() const { return hits_.load(); }
+    int64_t misses() const { return misses_.load(); }
+    int64_t refreshes() const { return refreshes_.load(); }
+    int64_t failures() const { return failures_.load(); }
+
+private:
+    std::map<std::string, std::vector<Address>> entries_;  // By "host:port", never empty
+    std::chrono::milliseconds refresh_interval_{60000};
+    std::mutex mutex_;
+
+    std::thread refresh_thread_;
+    bool running_{false};
+    std::condition_variable cv_;
+
+    std::atomic<int64_t> hits_{0};
+    std::atomic<int64_t> misses_{0};
+    std::atomic<int64_t> refreshes_{0};
+    std::atomic<int64_t> failures_{0};
+
+    void run_refresh();
+};
+
+} // namespace arb
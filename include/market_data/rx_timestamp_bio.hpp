@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include "common/types.hpp"
+
+struct bio_st;
+
+namespace arb {
+
+/**
+ * Kernel receive timestamps under TLS.
+ *
+ * SO_TIMESTAMPNS makes the kernel stamp each packet as it reaches the
+ * socket, before any of our own work. OpenSSL's socket BIO reads with
+ * read(), which drops the stamp, so TLS connections read through this BIO
+ * instead: the same non-blocking socket I/O, but via recvmsg(), recording
+ * the stamp (CLOCK_REALTIME ns) of every read into *last_rx_ns. Bytes an
+ * SSL_read() returns arrived no later than the latest such read.
+ *
+ * The BIO neither owns nor closes the fd.
+ */
+
+// Ask the kernel to stamp received packets; false if the socket refused
+bool enable_rx_timestamps(int fd);
+
+// Socket BIO over fd that stores each read's kernel timestamp in *last_rx_ns
+// (left untouched when a read carries none). Null on failure; the caller
+// owns the result, usually by handing it to SSL_set_bio().
+bio_st* new_rx_timestamp_bio(int fd, int64_t* last_rx_ns);
+
+// A CLOCK_REALTIME kernel stamp expressed on the steady clock, given the
+// steady time of the read that returned it. Never later than steady_now.
+Timestamp steady_from_realtime_ns(int64_t realtime_ns, Timestamp steady_now);
+
+} // namespace arb
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace arb {
+
+/**
+ * Spreads a feed's subscriptions over connection shards.
+ *
+ * Tokens travel in groups: under Key::MARKET a market's YES and NO tokens
+ * share a shard, so both legs of a book update on one thread; under
+ * Key::TOKEN every token stands alone. A new group goes to the shard
+ * carrying the fewest tokens. When removals leave the shards uneven by more
+ * than the slack, whole groups move from the fullest shard to the emptiest.
+ *
+ * add()/remove() only stage changes; commit() turns them into the
+ * subscribe and unsubscribe messages to send, each at most batch_size
+ * tokens. Subscribes come first, so a moved group is picked up by its new
+ * shard before the old one lets it go.
+ *
+ * Not thread-safe; the owner serializes calls.
+ */
+class SubscriptionShards {
+public:
+    enum class Key { MARKET, TOKEN };
+
+    // One subscribe or unsubscribe message
+    struct Batch {
+        size_t shard{0};
+        bool subscribe{true};
+        std::vector<std::string> token_ids;
+    };
+
+    SubscriptionShards(size_t shards, Key key, size_t batch_size, size_t slack);
+
+    // Stage a token; market is its group under Key::MARKET. No-op if known.
+    void add(const std::string& token_id, const std::string& market);
+    // Stage a token's removal. No-op if unknown.
+    void remove(const std::string& token_id);
+    // Place staged tokens, rebalance, and return the messages to send
+    std::vector<Batch> commit();
+
+    // Every token assigned to a shard, as subscribe batches (for a reconnect)
+    std::vector<Batch> resubscribe(size_t shard) const;
+
+    size_t shard_count() const { return shards_.size(); }
+    std::optional<size_t> shard_of(const std::string& token_id) const;
+    size_t load(size_t shard) const { return shards_[shard].tokens; }
+    size_t token_count() const { return token_group_.size(); }
+    int64_t groups_moved() const { return groups_moved_; }
+
+    static std::optional<Key> key_from_string(const std::string& s);
+
+private:
+    struct Group {
+        size_t shard{0};
+        std::vector<std::string> tokens;
+    };
+    struct ShardLoad {
+        size_t tokens{0};
+        std::map<std::string, Group*> groups;  // By group key
+    };
+
+    Key key_;
+    size_t batch_size_;
+    size_t slack_;
+    std::vector<ShardLoad> shards_;
+    std::map<std::string, Group> groups_;             // By group key
+    std::map<std::string, std::string> token_group_;  // Token to group key
+
+    // Staged since the last commit(), per shard
+    std::vector<std::vector<std::string>> added_;
+    std::vector<std::vector<std::string>> removed_;
+    int64_t groups_moved_{0};
+
+    size_t emptiest() const;
+    size_t fullest() const;
+    void rebalance();
+    void append_batches(size_t shard, bool subscribe, const std::vector<std::string>& tokens,
+                        std::vector<Batch>& out) const;
+};
+
+} // namespace arb
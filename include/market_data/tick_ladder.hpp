@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+#include <optional>
+#include <cmath>
+#include "common/types.hpp"
+
+namespace arb {
+
+/**
+ * One side of an order book stored as a flat array indexed by integer tick.
+ *
+ * Polymarket prices live on a bounded grid (0.01 - 0.99 at 1c ticks), so a
+ * level lookup is a single index instead of a tree walk, and the whole side
+ * fits in a couple of cache lines. Best and worst cursors are maintained on
+ * every mutation; removing the best level scans toward the worst cursor for
+ * the next populated tick.
+ *
+ * Not thread-safe - the owning OrderBook holds the lock.
+ */
+class TickLadder {
+public:
+    // descending = true for bids (highest price is best)
+    TickLadder(bool descending, Price tick_size);
+
+    // Set size at price; size <= 0 removes the level.
+    // Returns false if the price is not on the tick grid.
+    bool set(Price price, Size size);
+    void clear();
+
+    bool empty() const { return count_ == 0; }
+    int count() const { return count_; }
+
+    std::optional<PriceLevel> best() const {
+        if (count_ == 0) return std::nullopt;
+        return PriceLevel{to_price(best_), sizes_[best_]};
+    }
+
+    // Visit up to n levels best-first: fn(price, size)
+    template <typename Fn>
+    void for_each(int n, Fn&& fn) const {
+        if (count_ == 0) return;
+        const int step = descending_ ? -1 : 1;
+        int visited = 0;
+        for (int t = best_; visited < n; t += step) {
+            if (sizes_[t] > 0.0) {
+                fn(to_price(t), sizes_[t]);
+                ++visited;
+            }
+            if (t == worst_) break;
+        }
+    }
+
+    // Tick index for price, or -1 if off-grid / out of range
+    int to_tick(Price price) const {
+        double scaled = price * ticks_per_unit_;
+        long t = std::lround(scaled);
+        if (t <= 0 || t >= static_cast<long>(sizes_.size())) return -1;
+        if (std::abs(scaled - static_cast<double>(t)) > 1e-6) return -1;
+        return static_cast<int>(t);
+    }
+
+    Price to_price(int tick) const {
+        return static_cast<double>(tick) / ticks_per_unit_;
+    }
+
+private:
+    bool descending_;
+    double ticks_per_unit_;
+    std::vector<Size> sizes_;  // Indexed by tick; 0.0 = empty level
+    int best_{-1};
+    int worst_{-1};
+    int count_{0};
+
+    bool better(int a, int b) const { return descending_ ? a > b : a < b; }
+    void remove_at(int tick);
+};
+
+} // namespace arb
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+struct ssl_ctx_st;
+struct ssl_st;
+struct ssl_session_st;
+
+namespace arb {
+
+/**
+ * Long-lived TLS client context for one host:port.
+ *
+ * Created on first use and kept for the life of the process, so a
+ * reconnect neither rebuilds the context nor starts from a cold session:
+ * every new SSL offers the last session ticket the server issued, and a
+ * resumed handshake skips the certificate exchange. Tickets are captured
+ * through the new-session callback because TLS 1.3 servers send them only
+ * after the handshake has finished.
+ *
+ * Contexts are shared across threads; SSL objects are not.
+ */
+class TlsClientContext {
+public:
+    // Context for host:port; null if OpenSSL could not create one
+    static TlsClientContext* for_endpoint(const std::string& host, int port);
+
+    ~TlsClientContext();
+
+    TlsClientContext(const TlsClientContext&) = delete;
+    TlsClientContext& operator=(const TlsClientContext&) = delete;
+
+    // New client SSL with SNI set, offering the cached session if any.
+    // Null on failure; the caller owns the result.
+    ssl_st* new_ssl();
+
+    bool has_session() const;
+    const std::string& host() const { return host_; }
+
+    // Stats
+    int64_t sessions_received() const { return sessions_received_.load(); }
+
+private:
+    explicit TlsClientContext(const std::string& host);
+
+    std::string host_;
+    ssl_ctx_st* ctx_{nullptr};
+    ssl_session_st* session_{nullptr};  // Latest resumable session
+    mutable std::mutex session_mutex_;
+
+    std::atomic<int64_t> sessions_received_{0};
+
+    static int on_new_session(ssl_st* ssl, ssl_session_st* session);
+};
+
+} // namespace arb
@@ -1,37 +1,82 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <functional>
 #include <memory>
-#include <thread>
 #include <atomic>
-#include <queue>
+#include <optional>
+#include <vector>
 #include <mutex>
-#include <condition_variable>
 #include "common/types.hpp"
+#include "market_data/event_loop.hpp"
+#include "market_data/feed_latency.hpp"
+#include "market_data/first_arrival_filter.hpp"
+#include "market_data/ws_connection.hpp"
 
 namespace arb {
 
+// One shard's share of a feed
+struct FeedShardStats {
+    int64_t messages{0};        // Applied, after dropping redundant copies
+    int64_t parse_ns_total{0};  // Time in handle_message(): parse and apply
+    int64_t parse_ns_max{0};
+    int64_t feed_gaps{0};
+
+    double mean_parse_us() const { return messages > 0 ? parse_ns_total / 1000.0 / messages : 0.0; }
+};
+
 /**
  * Base WebSocket client with reconnection logic.
- * Uses a simple polling-based approach for portability.
+ *
+ * Owns one or more WsConnections on the shared EventLoop, which does all
+ * transport work (TLS, framing, fragment reassembly, control frames,
+ * backoff). Venue clients derive from this and only implement the protocol:
+ * handle_message() parses, on_open() restores subscriptions.
+ *
+ * With several connections the feed is redundant: each connection carries
+ * the full stream, optionally over a different resolved address, and only
+ * the first copy of every message reaches handle_message(). A stalled or
+ * dropped connection then costs nothing while another is up. The client
+ * reports CONNECTED while any connection is, and a feed gap only when all
+ * of them were down.
+ *
+ * Connections can also be split into shards, each carrying its own share
+ * of the subscriptions (the venue client decides which). The first shard
+ * runs on the shared EventLoop; every other shard gets an EventLoop thread
+ * of its own, so handle_message() runs concurrently across shards and must
+ * only share state behind a lock. Each shard is redundant on its own, and
+ * the feed is CONNECTED once every shard is.
+ *
+ * recv_time is the kernel's receive stamp when rx timestamps are on (see
+ * WsConnection). Derived clients record each message they apply into
+ * latency_, splitting its path into wire, parse, and book stages.
  */
 class WebSocketClientBase {
 public:
-    using MessageCallback = std::function<void(const std::string&, Timestamp)>;
+    using MessageCallback = std::function<void(std::string_view, Timestamp)>;
     using StatusCallback = std::function<void(ConnectionStatus)>;
     using ErrorCallback = std::function<void(const std::string&)>;
+    using FeedGapCallback = std::function<void(Duration gap)>;  // Feed down to first message after it
 
-    WebSocketClientBase(const std::string& url, const std::string& name);
+    // connections per shard
+    WebSocketClientBase(const std::string& url, const std::string& name, int connections = 1,
+                        int shards = 1);
     virtual ~WebSocketClientBase();
 
+    WebSocketClientBase(const WebSocketClientBase&) = delete;
+    WebSocketClientBase& operator=(const WebSocketClientBase&) = delete;
+
     // Connection management
     virtual void connect();
     virtual void disconnect();
     virtual void reconnect();
 
-    // Send message
-    virtual bool send(const std::string& message);
+    // Send a text message on every open connection; false if none is open.
+    // From on_open() it goes only to the connection that just opened.
+    virtual bool send(std::string_view message);
+    // The same, limited to one shard's connections
+    bool send(size_t shard, std::string_view message);
 
     // Status
     ConnectionStatus status() const { return status_.load(); }
@@ -41,15 +86,31 @@ public:
     void set_message_callback(MessageCallback cb) { on_message_ = std::move(cb); }
     void set_status_callback(StatusCallback cb) { on_status_ = std::move(cb); }
     void set_error_callback(ErrorCallback cb) { on_error_ = std::move(cb); }
+    void set_feed_gap_callback(FeedGapCallback cb) { on_feed_gap_ = std::move(cb); }
 
-    // Configuration
+    // Configuration (takes effect on the next connect)
     void set_reconnect_delay(int ms) { reconnect_delay_ms_ = ms; }
     void set_max_reconnect_attempts(int n) { max_reconnect_attempts_ = n; }
+    void set_feed_thread_cpu(int cpu) { feed_thread_cpu_ = cpu; }
+    // Give each redundant connection a different resolved address
+    void set_spread_addresses(bool spread) { spread_addresses_ = spread; }
+    // Time messages by the kernel's receive stamp (SO_TIMESTAMPNS)
+    void set_rx_timestamps(bool enabled) { rx_timestamps_ = enabled; }
 
     // Stats
-    int64_t messages_received() const { return messages_received_.load(); }
-    int64_t bytes_received() const { return bytes_received_.load(); }
+    int64_t messages_received() const;  // Applied, i.e. after dropping redundant copies
+    int64_t bytes_received() const;
     Timestamp last_message_time() const;
+    size_t connection_count() const { return ws_.size(); }  // Across all shards
+    size_t shard_count() const { return shards_.size(); }
+    FeedShardStats shard_stats(size_t shard) const;
+    WsConnectionStats connection_stats(size_t path = 0) const { return ws_[path]->stats(); }
+    FeedPathStats path_stats(size_t path) const;
+    int64_t duplicates_dropped() const;
+    int64_t feed_gaps() const { return feed_gaps_.load(); }
+    int64_t last_feed_gap_us() const { return last_feed_gap_us_.load(); }
+    int64_t max_feed_gap_us() const { return max_feed_gap_us_.load(); }
+    const FeedLatency& latency() const { return latency_; }
 
 protected:
     std::string url_;
@@ -59,28 +120,65 @@ protected:
     MessageCallback on_message_;
     StatusCallback on_status_;
     ErrorCallback on_error_;
+    FeedGapCallback on_feed_gap_;
 
     int reconnect_delay_ms_{1000};
     int max_reconnect_attempts_{10};
-    int reconnect_attempts_{0};
-
-    std::atomic<int64_t> messages_received_{0};
-    std::atomic<int64_t> bytes_received_{0};
-    Timestamp last_message_time_;
-    mutable std::mutex time_mutex_;
-
-    std::atomic<bool> running_{false};
-    std::thread recv_thread_;
+    int feed_thread_cpu_{-1};
+    bool spread_addresses_{false};
+    bool rx_timestamps_{false};
 
-    // Platform-specific socket handle
-    void* socket_handle_{nullptr};
+    // Derived clients record each applied message here
+    FeedLatency latency_;
 
-    virtual void run_receive_loop();
-    virtual void handle_message(const std::string& msg);
+    // Shard loop thread: after every successful (re)connect of any of its connections
+    virtual void on_open(size_t /*shard*/) {}
+    // Shard loop thread: one complete data message; the view dies with the call
+    virtual void handle_message(size_t shard, std::string_view msg, Timestamp recv_time);
     void set_status(ConnectionStatus s);
 
-    // SSL context for secure connections
-    void* ssl_ctx_{nullptr};
+    // From on_open(): whether another connection of the shard stayed open
+    // meanwhile, in which case nothing was missed and no resync is needed
+    bool other_connection_open(size_t shard) const;
+
+private:
+    // Drives on_path_status() and dispatch() directly, without sockets
+    friend class WebSocketClientBaseTest;
+
+    struct Shard {
+        EventLoop* loop{nullptr};
+        std::unique_ptr<EventLoop> own_loop;  // Every shard but the first
+        size_t first_path{0};
+        std::optional<FirstArrivalFilter> dedup;  // Set with two or more connections
+
+        // Shard loop-thread state
+        std::optional<size_t> opening_path;  // Inside on_open() for this connection
+
+        ConnectionStatus status{ConnectionStatus::DISCONNECTED};  // Guarded by status_mutex_
+        std::atomic<Timestamp::rep> down_since_ns{0};  // Every connection down; 0 = shard up
+        std::atomic<int64_t> messages{0};
+        std::atomic<int64_t> parse_ns_total{0};
+        std::atomic<int64_t> parse_ns_max{0};
+        std::atomic<int64_t> feed_gaps{0};
+    };
+
+    // Declared before ws_: shards own the loops those connections run on
+    std::vector<std::unique_ptr<Shard>> shards_;
+    // Live as long as the client; connect()/disconnect() start and stop them
+    std::vector<std::unique_ptr<WsConnection>> ws_;  // Shard-major: path = shard * per_shard_ + k
+    size_t per_shard_{1};
+
+    mutable std::mutex status_mutex_;
+    std::vector<ConnectionStatus> path_status_;  // Guarded by status_mutex_
+
+    std::atomic<bool> wanted_{false};
+    std::atomic<int64_t> feed_gaps_{0};
+    std::atomic<int64_t> last_feed_gap_us_{0};
+    std::atomic<int64_t> max_feed_gap_us_{0};
+
+    void dispatch(size_t path, std::string_view msg, Timestamp recv_time);
+    void on_path_status(size_t path, ConnectionStatus s);
+    void end_feed_gap(Shard& shard, Timestamp recv_time);
 };
 
 } // namespace arb
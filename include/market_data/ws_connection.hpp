@@ -0,0 +1,221 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/socket.h>
+#include "common/types.hpp"
+#include "market_data/event_loop.hpp"
+#include "market_data/resolver_cache.hpp"
+#include "market_data/ws_frame_decoder.hpp"
+#include "market_data/ws_frame_encoder.hpp"
+
+struct ssl_st;
+
+namespace arb {
+
+class TlsClientContext;
+
+// Parts of a ws:// or wss:// URL
+struct WsEndpoint {
+    std::string host;
+    int port{443};
+    std::string path{"/"};
+    bool tls{true};
+};
+
+// Returns false if url is not ws:// or wss:// with a host
+bool parse_ws_url(const std::string& url, WsEndpoint& out);
+
+// Per-connection counters, cumulative across reconnects
+struct WsConnectionStats {
+    int64_t messages_received{0};     // Complete data messages delivered
+    int64_t frames_received{0};       // Every frame, control and continuation included
+    int64_t bytes_received{0};        // Decrypted bytes off the socket
+    int64_t fragmented_messages{0};   // Messages reassembled from continuations
+    int64_t pings_received{0};
+    int64_t connects{0};
+    int64_t disconnects{0};           // Drops and closes of an open connection
+    int64_t tls_resumptions{0};       // Handshakes that resumed a cached session
+    int64_t kernel_stamped_reads{0};  // Reads timed by the kernel's receive stamp
+    int64_t feed_gaps{0};             // Drops followed by a delivered message
+    int64_t last_feed_gap_us{0};      // Drop to first message after reconnecting
+    int64_t max_feed_gap_us{0};
+};
+
+/**
+ * One non-blocking TLS WebSocket connection driven by an EventLoop.
+ *
+ * TCP connect, TLS handshake (SSL_ERROR_WANT_READ / WANT_WRITE re-arm the
+ * fd in epoll), HTTP upgrade and frame reads all advance from readiness
+ * callbacks on the loop thread, so no call here ever blocks the loop.
+ * Name resolution is the exception and runs on a short-lived helper thread.
+ *
+ * Data messages (continuation frames reassembled) are handed to the message
+ * callback on the loop thread; the payload view is only valid for the
+ * duration of the call. Control frames are answered inline, protocol
+ * violations close with the matching status code. A drop after a session
+ * that lasted is retried at once; failed connects and short-lived sessions
+ * back off exponentially. The open callback fires after every successful
+ * (re)connect so adapters can restore subscriptions.
+ *
+ * Reconnects skip the slow parts of a cold connect: the address comes from
+ * ResolverCache and the TLS handshake resumes the endpoint's last session.
+ * The time from a drop to the first message after it is the feed gap.
+ *
+ * With rx timestamps on, a message's recv_time is the kernel's stamp of the
+ * packet that completed it, moved onto the steady clock, so it excludes TLS
+ * decrypt and framing. Otherwise it is taken right after SSL_read().
+ */
+class WsConnection {
+public:
+    using OpenCallback = std::function<void()>;
+    using MessageCallback = std::function<void(std::string_view payload, Timestamp recv_time)>;
+    using StatusCallback = std::function<void(ConnectionStatus)>;
+    using ErrorCallback = std::function<void(const std::string&)>;
+    using FeedGapCallback = std::function<void(Duration gap)>;
+
+    WsConnection(EventLoop& loop, const std::string& url, const std::string& name);
+    ~WsConnection();
+
+    WsConnection(const WsConnection&) = delete;
+    WsConnection& operator=(const WsConnection&) = delete;
+
+    // Set before start()
+    void set_open_callback(OpenCallback cb) { on_open_ = std::move(cb); }
+    void set_message_callback(MessageCallback cb) { on_message_ = std::move(cb); }
+    void set_status_callback(StatusCallback cb) { on_status_ = std::move(cb); }
+    void set_error_callback(ErrorCallback cb) { on_error_ = std::move(cb); }
+    void set_feed_gap_callback(FeedGapCallback cb) { on_feed_gap_ = std::move(cb); }
+    void set_reconnect_policy(int delay_ms, int max_attempts);
+    // Which of the host's resolved addresses to use (modulo their count)
+    void set_address_index(size_t index) { address_index_ = index; }
+    // Time messages by the kernel's SO_TIMESTAMPNS receive stamp
+    void set_rx_timestamps(bool enabled) { rx_timestamps_ = enabled; }
+
+    // Thread-safe. start() returns immediately; stop() waits for teardown.
+    void start();
+    void stop();
+
+    // Thread-safe: queue a text frame. False if the connection is not open.
+    bool send_text(std::string_view message);
+
+    ConnectionStatus status() const { return status_.load(); }
+    const std::string& name() const { return name_; }
+    const WsEndpoint& endpoint() const { return endpoint_; }
+
+    // Stats
+    WsConnectionStats stats() const;
+    int64_t messages_received() const { return messages_received_.load(); }
+    int64_t bytes_received() const { return bytes_received_.load(); }
+    Timestamp last_message_time() const {
+        return Timestamp(Timestamp::duration(last_message_ns_.load()));
+    }
+
+private:
+    enum class State { IDLE, RESOLVING, CONNECTING, TLS_HANDSHAKE, WS_HANDSHAKE, OPEN, BACKOFF };
+
+    EventLoop& loop_;
+    std::string name_;
+    WsEndpoint endpoint_;
+    bool valid_url_{false};
+    TlsClientContext* tls_{nullptr};  // Per endpoint, outlives the connection
+    WsFrameEncoder encoder_;      // Shared by the loop and send_text() callers
+
+    OpenCallback on_open_;
+    MessageCallback on_message_;
+    StatusCallback on_status_;
+    ErrorCallback on_error_;
+    FeedGapCallback on_feed_gap_;
+
+    int reconnect_delay_ms_{1000};
+    int max_reconnect_attempts_{10};
+    size_t address_index_{0};
+    bool rx_timestamps_{false};
+
+    std::atomic<ConnectionStatus> status_{ConnectionStatus::DISCONNECTED};
+    std::atomic<int64_t> messages_received_{0};
+    std::atomic<int64_t> frames_received_{0};
+    std::atomic<int64_t> bytes_received_{0};
+    std::atomic<int64_t> fragmented_messages_{0};
+    std::atomic<int64_t> pings_received_{0};
+    std::atomic<int64_t> connects_{0};
+    std::atomic<int64_t> disconnects_{0};
+    std::atomic<int64_t> tls_resumptions_{0};
+    std::atomic<int64_t> kernel_stamped_reads_{0};
+    std::atomic<int64_t> feed_gaps_{0};
+    std::atomic<int64_t> last_feed_gap_us_{0};
+    std::atomic<int64_t> max_feed_gap_us_{0};
+    std::atomic<Timestamp::rep> last_message_ns_{0};
+
+    // Loop-thread state
+    State state_{State::IDLE};
+    bool wanted_{false};          // Between start() and stop()
+    uint64_t generation_{0};      // Bumped on teardown; stale async results are dropped
+    int attempts_{0};             // Failures since the last stable session
+    Timestamp opened_at_{};       // When the current session reached OPEN
+    Timestamp dropped_at_{};      // Last drop not yet followed by a message
+    EventLoop::TimerId backoff_timer_{0};
+    int fd_{-1};
+    bool fd_stamped_{false};      // SO_TIMESTAMPNS took on this socket
+    int64_t kernel_rx_ns_{0};     // Latest read's kernel stamp (CLOCK_REALTIME); 0 = none
+    ssl_st* ssl_{nullptr};
+    uint32_t armed_events_{0};
+    ResolverCache::Address addr_;
+
+    std::string upgrade_;         // HTTP upgrade response read so far
+    WsFrameDecoder rx_;           // Frames read but not yet parsed
+    WsMessageAssembler messages_; // Reassembles data messages, vets control frames
+    // Encoded frames not yet accepted by SSL_write, oldest first. Segments
+    // are written in place and recycled, so steady-state sends don't allocate.
+    std::deque<std::string> tx_queue_;
+    size_t tx_offset_{0};         // Bytes of the front segment already written
+    std::vector<std::string> tx_spare_;
+
+    // Frames encoded by send_text() off the loop thread, not yet queued.
+    // The loop swaps the whole buffer for a recycled segment, so these
+    // sends reuse buffers too instead of allocating one per frame.
+    std::mutex outbox_mutex_;
+    std::string outbox_;
+
+    // Cleared on destruction so a late name resolution never touches this.
+    // Helpers post to loop_ only while holding mutex with alive set, so once
+    // the destructor clears it neither this nor loop_ is touched again.
+    struct AliveToken {
+        std::mutex mutex;
+        bool alive{true};
+    };
+    std::shared_ptr<AliveToken> alive_;
+
+    void set_status(ConnectionStatus s);
+
+    void begin_connect();
+    void on_resolved(uint64_t generation, bool ok, const ResolverCache::Address& addr);
+    void on_io(uint32_t events);
+    void finish_tcp_connect();
+    void continue_tls_handshake();
+    void read_available();
+    bool parse_upgrade_response();
+    void parse_frames(Timestamp recv_time);
+    bool handle_frame(const WsFrame& frame, Timestamp recv_time);
+    void deliver(std::string_view payload, Timestamp recv_time);
+    void end_feed_gap(Timestamp recv_time);
+    void queue_frame(std::string_view payload, uint8_t opcode);
+    void drain_outbox();
+    std::string spare_segment();
+    void recycle_segment(std::string&& segment);
+    void queue_close(uint16_t code);
+    void protocol_error(uint16_t code, const std::string& reason);
+    void flush_tx();
+    void arm(uint32_t events);
+
+    void fail(const std::string& reason);
+    void teardown();
+};
+
+} // namespace arb
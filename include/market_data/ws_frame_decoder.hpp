@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace arb {
+
+// RFC 6455 7.4.1 status codes
+constexpr uint16_t WS_CLOSE_NORMAL = 1000;
+constexpr uint16_t WS_CLOSE_PROTOCOL_ERROR = 1002;
+constexpr uint16_t WS_CLOSE_TOO_BIG = 1009;
+
+// One decoded WebSocket frame. The payload points into the decoder and is
+// only valid until the next call on it.
+struct WsFrame {
+    uint8_t opcode{0};
+    bool fin{true};
+    uint8_t rsv{0};  // RSV1-3 as the low three bits
+    std::string_view payload;
+};
+
+/**
+ * WebSocket frame decoder over a reusable receive ring buffer.
+ *
+ * Callers read straight into write_space() - as many bytes as the socket
+ * has - then commit() and drain every complete buffered frame with next().
+ * Headers are parsed in place and payloads are handed out as views into the
+ * ring; a payload is only copied (into a reused scratch buffer) when it
+ * straddles the wrap. The ring doubles when a single frame would not fit.
+ *
+ * Not thread-safe - owned by one connection on the loop thread.
+ */
+class WsFrameDecoder {
+public:
+    enum class Result { FRAME, NEED_MORE, ERROR };
+
+    struct Space {
+        char* data;
+        size_t size;
+    };
+
+    explicit WsFrameDecoder(size_t initial_capacity = 64 * 1024,
+                            uint64_t max_payload = 1024 * 1024);
+
+    // Contiguous free region for the next read, then commit what was filled
+    Space write_space();
+    void commit(size_t n);
+
+    // Copy bytes in (handshake leftovers, tests)
+    void append(std::string_view data);
+
+    // Decode the next complete frame. ERROR is sticky until clear().
+    Result next(WsFrame& frame);
+
+    void clear();
+
+    const std::string& error() const { return error_; }
+    size_t buffered() const { return size_; }
+    size_t capacity() const { return buf_.size(); }
+    // Frames whose payload had to be copied because it crossed the wrap
+    int64_t wrapped_frames() const { return wrapped_frames_; }
+
+private:
+    std::vector<char> buf_;      // Power-of-two capacity
+    size_t mask_{0};
+    size_t head_{0};             // Index of the first unread byte
+    size_t size_{0};             // Unread bytes
+    uint64_t max_payload_;
+
+    std::string scratch_;        // Linearised payload of a wrapped frame
+    std::string error_;
+    int64_t wrapped_frames_{0};
+
+    uint8_t byte_at(size_t offset) const {
+        return static_cast<uint8_t>(buf_[(head_ + offset) & mask_]);
+    }
+    void grow(size_t min_capacity);
+};
+
+/**
+ * RFC 6455 message layer over decoded frames: reassembles fragmented data
+ * messages, lets control frames interleave with them, and decides how the
+ * connection answers each frame.
+ *
+ * The caller sends what the action asks for: a pong carrying payload() for
+ * PING, a close with close_code() for CLOSE (0 = an empty close frame) and
+ * ERROR. A received close code that is reserved or invalid on the wire is
+ * answered with 1002 rather than echoed, as is any frame with an RSV bit set
+ * (no extension is ever negotiated).
+ *
+ * Not thread-safe - owned by one connection on the loop thread.
+ */
+class WsMessageAssembler {
+public:
+    enum class Action {
+        NONE,     // Fragment buffered, or a pong
+        MESSAGE,  // payload() is a complete data message
+        PING,     // Answer with a pong carrying payload()
+        CLOSE,    // The peer closed; reply with close_code()
+        ERROR     // Protocol violation; close with close_code(), see error()
+    };
+
+    explicit WsMessageAssembler(size_t max_message = 4 * 1024 * 1024);
+
+    // The frame's payload must stay valid until the call returns
+    Action on_frame(const WsFrame& frame);
+
+    // MESSAGE, PING and CLOSE (the reason text); valid until the next on_frame()
+    std::string_view payload() const { return payload_; }
+    uint16_t close_code() const { return close_code_; }
+    const std::string& error() const { return error_; }
+    // The last MESSAGE was reassembled from continuation frames
+    bool fragmented() const { return fragmented_; }
+
+    // Drop a message in progress (on disconnect)
+    void clear();
+
+    // Codes a peer may send in a close frame
+    static bool valid_close_code(uint16_t code);
+
+private:
+    size_t max_message_;
+    std::string fragments_;       // Data message being reassembled
+    uint8_t fragment_opcode_{0};  // Opcode of that message; 0 = none in progress
+
+    std::string_view payload_;
+    uint16_t close_code_{0};
+    std::string error_;
+    bool fragmented_{false};
+
+    Action fail(uint16_t code, std::string reason);
+};
+
+} // namespace arb
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace arb {
+
+// Largest client frame header: 2 bytes + 64-bit length + 4-byte mask key
+constexpr size_t WS_MAX_HEADER = 14;
+
+// dst[i] = src[i] ^ key[i % 4], eight bytes per step. dst may equal src.
+void ws_mask(const char* src, char* dst, size_t len, const uint8_t key[4]);
+
+/**
+ * Encoder for outbound (masked) client frames.
+ *
+ * Frames are written straight into a caller-owned buffer in one pass: the
+ * header is formatted in place and the payload is masked while it is copied,
+ * so reusing the buffer makes sending allocation-free. Mask keys come from a
+ * per-connection SplitMix64 stream rather than a fresh std::random_device
+ * per frame; it is lock-free, so any thread may encode.
+ */
+class WsFrameEncoder {
+public:
+    explicit WsFrameEncoder(uint64_t seed);
+
+    // Thread-safe
+    uint32_t next_mask_key();
+
+    // Format a header for payload_len into out (at least WS_MAX_HEADER
+    // bytes). Returns the header length; the key is written last.
+    static size_t encode_header(uint8_t opcode, size_t payload_len, const uint8_t key[4], char* out);
+
+    // Append one complete masked frame to out. Thread-safe.
+    void encode(std::string_view payload, uint8_t opcode, std::string& out);
+
+private:
+    std::atomic<uint64_t> state_;
+};
+
+} // namespace arb
@@ -13,6 +13,8 @@ namespace arb {
 struct Position {
     std::string token_id;
     std::string market_id;
+    TokenHandle token_handle{NO_SYMBOL};
+    MarketHandle market_handle{NO_SYMBOL};
     std::string outcome_name;  // "YES" or "NO"
 
     Size size{0.0};           // Positive = long
@@ -52,9 +54,11 @@ public:
     void record_fill(const Fill& fill);
 
     // Mark positions to market
+    void mark_to_market(TokenHandle token, Price mark_price);
     void mark_to_market(const std::string& token_id, Price mark_price);
 
     // Query positions
+    std::optional<Position> get_position(TokenHandle token) const;
     std::optional<Position> get_position(const std::string& token_id) const;
     std::vector<Position> get_all_positions() const;
     std::vector<Position> get_open_positions() const;
@@ -89,7 +93,7 @@ public:
 
 private:
     mutable std::mutex mutex_;
-    std::map<std::string, Position> positions_;  // Keyed by token_id
+    std::map<TokenHandle, Position> positions_;
 
     // Aggregate tracking
     Notional total_realized_pnl_{0.0};
@@ -4,6 +4,7 @@
 #include <mutex>
 #include <chrono>
 #include <deque>
+#include <vector>
 #include "common/types.hpp"
 #include "config/config.hpp"
 
@@ -24,6 +25,7 @@ public:
     };
 
     CheckResult check_order(const Signal& signal, Notional notional) const;
+    CheckResult check_position_limit(MarketHandle market) const;
     CheckResult check_position_limit(const std::string& market_id) const;
     CheckResult check_daily_loss() const;
 
@@ -33,6 +35,7 @@ public:
 
     // Exposure queries
     double current_exposure() const;
+    double exposure_for_market(MarketHandle market) const;
     double exposure_for_market(const std::string& market_id) const;
     int open_position_count() const;
 
@@ -71,9 +74,9 @@ private:
     std::atomic<double> current_balance_;
     std::atomic<double> daily_pnl_{0.0};
 
-    // Position tracking by market
+    // Position tracking by market, indexed by MarketHandle (0.0 = no exposure)
     mutable std::mutex position_mutex_;
-    std::map<std::string, double> market_exposure_;
+    std::vector<double> market_exposure_;
     int open_positions_{0};
 
     // Kill switch
@@ -6,6 +6,8 @@
 #include "common/types.hpp"
 #include "config/config.hpp"
 #include "market_data/order_book.hpp"
+#include "market_data/market_table.hpp"
+#include "common/fixed_point.hpp"
 
 namespace arb {
 
@@ -25,6 +27,15 @@ public:
         Timestamp now
     ) = 0;
 
+    // Optional cross-market screen. A strategy whose trigger can be read off
+    // the top of book appends the markets worth evaluating to candidates
+    // (ascending) and returns true; the caller then skips evaluate() for all
+    // other markets. The default screens nothing out.
+    virtual bool prefilter(const MarketTable& /* table */,
+                           std::vector<MarketHandle>& /* candidates */) const {
+        return false;
+    }
+
     // Strategy name
     const std::string& name() const { return name_; }
 
@@ -59,6 +70,9 @@ public:
         Timestamp now
     ) override;
 
+    // Markets whose best asks alone clear min_edge_cents after fees
+    bool prefilter(const MarketTable& table, std::vector<MarketHandle>& candidates) const override;
+
     // Calculate edge after fees
     double calculate_edge(double yes_ask, double no_ask, double fee_rate_bps) const;
 
@@ -68,12 +82,6 @@ public:
     // Calculate fee for a single position using Polymarket's parabolic formula
     // Fee = price * (1 - price) * FEE_RATE
     static double calculate_position_fee(double price);
-
-private:
-    // Polymarket fee rate constant (derived from fee table: ~6.24% at p=0.50)
-    // fee = price * (1 - price) * FEE_RATE
-    // At $0.50: 0.50 * 0.50 * 0.0624 = $0.0156 (matches table)
-    static constexpr double POLYMARKET_FEE_RATE = 0.0624;
 };
 
 /**
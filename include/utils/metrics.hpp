@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <atomic>
 #include <algorithm>
@@ -12,6 +14,11 @@ namespace arb {
 
 /**
  * Histogram for latency measurements.
+ *
+ * Keeps the latest max_samples in a ring of atomic slots. record() is a
+ * fetch_add and a store, so hot threads never block on each other or on a
+ * reader; readers copy the ring and compute from the copy. A slot claimed
+ * but not yet stored may show its previous sample, which is fine for stats.
  */
 class LatencyHistogram {
 public:
@@ -27,9 +34,10 @@ public:
     Duration max() const;
     Duration mean() const;
 
-    int64_t count() const { return count_.load(); }
+    int64_t count() const { return count_.load(std::memory_order_relaxed); }
     void reset();
 
+    const std::string& name() const { return name_; }
     std::string summary() const;
 
 private:
@@ -37,10 +45,12 @@ private:
     size_t max_samples_;
     std::atomic<int64_t> count_{0};
 
-    mutable std::mutex mutex_;
-    std::vector<int64_t> samples_ns_;
+    static constexpr int64_t EMPTY_SLOT = INT64_MIN;
+    std::unique_ptr<std::atomic<int64_t>[]> samples_ns_;  // Ring of the latest max_samples_
+    std::atomic<uint64_t> next_{0};
 
-    int64_t percentile(double p) const;
+    std::vector<int64_t> samples() const;
+    static int64_t percentile(std::vector<int64_t> samples, double p);
 };
 
 /**
@@ -92,6 +102,11 @@ public:
     Gauge& gauge(const std::string& name);
     LatencyHistogram& histogram(const std::string& name);
 
+    // Export a histogram owned elsewhere under its name, until detached.
+    // A later attach under the same name replaces it.
+    void attach(LatencyHistogram& histogram);
+    void detach(const LatencyHistogram& histogram);
+
     // Export all metrics as JSON
     std::string to_json() const;
 
@@ -105,6 +120,7 @@ private:
     std::map<std::string, std::unique_ptr<Counter>> counters_;
     std::map<std::string, std::unique_ptr<Gauge>> gauges_;
     std::map<std::string, std::unique_ptr<LatencyHistogram>> histograms_;
+    std::map<std::string, LatencyHistogram*> attached_;
 };
 
 // Convenience macros
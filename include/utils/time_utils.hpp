@@ -51,6 +51,11 @@ bool is_trading_hours();
  */
 Duration time_to_next_15m();
 
+/**
+ * First 15-minute boundary strictly after t (UTC).
+ */
+WallClock next_15m_boundary(WallClock t);
+
 /**
  * Calculate time until specific wall clock.
  */
@@ -0,0 +1,81 @@
+#include "common/symbol_registry.hpp"
+#include <mutex>
+
+namespace arb {
+
+SymbolRegistry& SymbolRegistry::instance() {
+    static SymbolRegistry registry;
+    return registry;
+}
+
+SymbolRegistry::SymbolRegistry() {
+    // Reserve handle 0 for NO_SYMBOL
+    markets_.names.emplace_back();
+    tokens_.names.emplace_back();
+}
+
+MarketHandle SymbolRegistry::intern_market(std::string_view market_id) {
+    return intern(markets_, market_id);
+}
+
+TokenHandle SymbolRegistry::intern_token(std::string_view token_id) {
+    return intern(tokens_, token_id);
+}
+
+MarketHandle SymbolRegistry::find_market(std::string_view market_id) const {
+    return find(markets_, market_id);
+}
+
+TokenHandle SymbolRegistry::find_token(std::string_view token_id) const {
+    return find(tokens_, token_id);
+}
+
+const std::string& SymbolRegistry::market_name(MarketHandle handle) const {
+    return name(markets_, handle);
+}
+
+const std::string& SymbolRegistry::token_name(TokenHandle handle) const {
+    return name(tokens_, handle);
+}
+
+size_t SymbolRegistry::market_count() const {
+    std::shared_lock lock(mutex_);
+    return markets_.names.size() - 1;
+}
+
+size_t SymbolRegistry::token_count() const {
+    std::shared_lock lock(mutex_);
+    return tokens_.names.size() - 1;
+}
+
+uint32_t SymbolRegistry::intern(Table& table, std::string_view id) {
+    if (id.empty()) return NO_SYMBOL;
+
+    {
+        std::shared_lock lock(mutex_);
+        auto it = table.ids.find(id);
+        if (it != table.ids.end()) return it->second;
+    }
+
+    std::unique_lock lock(mutex_);
+    auto [it, inserted] = table.ids.try_emplace(std::string(id),
+                                                static_cast<uint32_t>(table.names.size()));
+    if (inserted) {
+        table.names.emplace_back(id);
+    }
+    return it->second;
+}
+
+uint32_t SymbolRegistry::find(const Table& table, std::string_view id) const {
+    std::shared_lock lock(mutex_);
+    auto it = table.ids.find(id);
+    return it != table.ids.end() ? it->second : NO_SYMBOL;
+}
+
+const std::string& SymbolRegistry::name(const Table& table, uint32_t handle) const {
+    std::shared_lock lock(mutex_);
+    if (handle >= table.names.size()) return table.names[NO_SYMBOL];
+    return table.names[handle];
+}
+
+} // namespace arb
@@ -60,10 +60,30 @@ void to_json(nlohmann::json& j, const ConnectionConfig& c) {
         {"polymarket_gamma_url", c.polymarket_gamma_url},
         {"binance_ws_url", c.binance_ws_url},
         {"binance_symbol", c.binance_symbol},
+        {"binance_trade_stream", c.binance_trade_stream},
         {"reconnect_delay_ms", c.reconnect_delay_ms},
         {"max_reconnect_attempts", c.max_reconnect_attempts},
+        {"dns_refresh_ms", c.dns_refresh_ms},
+        {"feed_connections", c.feed_connections},
+        {"feed_spread_addresses", c.feed_spread_addresses},
+        {"kernel_rx_timestamps", c.kernel_rx_timestamps},
+        {"polymarket_shards", c.polymarket_shards},
+        {"polymarket_shard_key", c.polymarket_shard_key},
+        {"subscribe_batch_size", c.subscribe_batch_size},
         {"heartbeat_interval_ms", c.heartbeat_interval_ms},
-        {"connection_timeout_ms", c.connection_timeout_ms}
+        {"connection_timeout_ms", c.connection_timeout_ms},
+        {"http_timeout_ms", c.http_timeout_ms},
+        {"http2", c.http2},
+        {"bootstrap_concurrency", c.bootstrap_concurrency},
+        {"bootstrap_rate_limit", c.bootstrap_rate_limit},
+        {"discovery_interval_ms", c.discovery_interval_ms},
+        {"discovery_page_size", c.discovery_page_size},
+        {"rollover_lead_ms", c.rollover_lead_ms},
+        {"order_book_impl", c.order_book_impl},
+        {"price_tick_size", c.price_tick_size},
+        {"fixed_point_prices", c.fixed_point_prices},
+        {"binance_price_decimals", c.binance_price_decimals},
+        {"feed_thread_cpu", c.feed_thread_cpu}
     };
 }
 
@@ -73,10 +93,30 @@ void from_json(const nlohmann::json& j, ConnectionConfig& c) {
     if (j.contains("polymarket_gamma_url")) j.at("polymarket_gamma_url").get_to(c.polymarket_gamma_url);
     if (j.contains("binance_ws_url")) j.at("binance_ws_url").get_to(c.binance_ws_url);
     if (j.contains("binance_symbol")) j.at("binance_symbol").get_to(c.binance_symbol);
+    if (j.contains("binance_trade_stream")) j.at("binance_trade_stream").get_to(c.binance_trade_stream);
     if (j.contains("reconnect_delay_ms")) j.at("reconnect_delay_ms").get_to(c.reconnect_delay_ms);
     if (j.contains("max_reconnect_attempts")) j.at("max_reconnect_attempts").get_to(c.max_reconnect_attempts);
+    if (j.contains("dns_refresh_ms")) j.at("dns_refresh_ms").get_to(c.dns_refresh_ms);
+    if (j.contains("feed_connections")) j.at("feed_connections").get_to(c.feed_connections);
+    if (j.contains("feed_spread_addresses")) j.at("feed_spread_addresses").get_to(c.feed_spread_addresses);
+    if (j.contains("kernel_rx_timestamps")) j.at("kernel_rx_timestamps").get_to(c.kernel_rx_timestamps);
+    if (j.contains("polymarket_shards")) j.at("polymarket_shards").get_to(c.polymarket_shards);
+    if (j.contains("polymarket_shard_key")) j.at("polymarket_shard_key").get_to(c.polymarket_shard_key);
+    if (j.contains("subscribe_batch_size")) j.at("subscribe_batch_size").get_to(c.subscribe_batch_size);
     if (j.contains("heartbeat_interval_ms")) j.at("heartbeat_interval_ms").get_to(c.heartbeat_interval_ms);
     if (j.contains("connection_timeout_ms")) j.at("connection_timeout_ms").get_to(c.connection_timeout_ms);
+    if (j.contains("http_timeout_ms")) j.at("http_timeout_ms").get_to(c.http_timeout_ms);
+    if (j.contains("http2")) j.at("http2").get_to(c.http2);
+    if (j.contains("bootstrap_concurrency")) j.at("bootstrap_concurrency").get_to(c.bootstrap_concurrency);
+    if (j.contains("bootstrap_rate_limit")) j.at("bootstrap_rate_limit").get_to(c.bootstrap_rate_limit);
+    if (j.contains("discovery_interval_ms")) j.at("discovery_interval_ms").get_to(c.discovery_interval_ms);
+    if (j.contains("discovery_page_size")) j.at("discovery_page_size").get_to(c.discovery_page_size);
+    if (j.contains("rollover_lead_ms")) j.at("rollover_lead_ms").get_to(c.rollover_lead_ms);
+    if (j.contains("order_book_impl")) j.at("order_book_impl").get_to(c.order_book_impl);
+    if (j.contains("price_tick_size")) j.at("price_tick_size").get_to(c.price_tick_size);
+    if (j.contains("fixed_point_prices")) j.at("fixed_point_prices").get_to(c.fixed_point_prices);
+    if (j.contains("binance_price_decimals")) j.at("binance_price_decimals").get_to(c.binance_price_decimals);
+    if (j.contains("feed_thread_cpu")) j.at("feed_thread_cpu").get_to(c.feed_thread_cpu);
 }
 
 void to_json(nlohmann::json& j, const LoggingConfig& c) {
@@ -192,6 +232,81 @@ bool Config::validate() const {
         return false;
     }
 
+    if (connection.order_book_impl != "map" && connection.order_book_impl != "tick") {
+        spdlog::error("order_book_impl must be \"map\" or \"tick\"");
+        return false;
+    }
+
+    if (connection.price_tick_size <= 0 || connection.price_tick_size >= 1.0) {
+        spdlog::error("price_tick_size must be in (0, 1)");
+        return false;
+    }
+
+    if (connection.binance_price_decimals < 0 || connection.binance_price_decimals > 8) {
+        spdlog::error("binance_price_decimals must be in [0, 8]");
+        return false;
+    }
+
+    if (connection.dns_refresh_ms < 0) {
+        spdlog::error("dns_refresh_ms must be non-negative");
+        return false;
+    }
+
+    if (connection.feed_connections < 1 || connection.feed_connections > 8) {
+        spdlog::error("feed_connections must be between 1 and 8");
+        return false;
+    }
+
+    if (connection.polymarket_shards < 1 || connection.polymarket_shards > 16) {
+        spdlog::error("polymarket_shards must be between 1 and 16");
+        return false;
+    }
+
+    if (connection.polymarket_shard_key != "market" && connection.polymarket_shard_key != "token") {
+        spdlog::error("polymarket_shard_key must be \"market\" or \"token\"");
+        return false;
+    }
+
+    if (connection.subscribe_batch_size < 1) {
+        spdlog::error("subscribe_batch_size must be at least 1");
+        return false;
+    }
+
+    if (connection.http_timeout_ms <= 0) {
+        spdlog::error("http_timeout_ms must be positive");
+        return false;
+    }
+
+    if (connection.bootstrap_concurrency < 1) {
+        spdlog::error("bootstrap_concurrency must be at least 1");
+        return false;
+    }
+
+    if (connection.bootstrap_rate_limit < 0) {
+        spdlog::error("bootstrap_rate_limit must be non-negative");
+        return false;
+    }
+
+    if (connection.discovery_interval_ms < 0) {
+        spdlog::error("discovery_interval_ms must be non-negative");
+        return false;
+    }
+
+    if (connection.discovery_page_size < 1) {
+        spdlog::error("discovery_page_size must be at least 1");
+        return false;
+    }
+
+    if (connection.rollover_lead_ms < 0 || connection.rollover_lead_ms >= 15 * 60 * 1000) {
+        spdlog::error("rollover_lead_ms must be between 0 and 15 minutes");
+        return false;
+    }
+
+    if (connection.feed_thread_cpu < -1) {
+        spdlog::error("feed_thread_cpu must be a CPU index or -1");
+        return false;
+    }
+
     if (strategy.min_edge_cents < 0) {
         spdlog::error("min_edge_cents must be non-negative");
         return false;
@@ -1,4 +1,6 @@
 #include "execution/execution_engine.hpp"
+#include "common/fixed_point.hpp"
+#include "common/symbol_registry.hpp"
 #include "utils/metrics.hpp"
 #include <spdlog/spdlog.h>
 #include <random>
@@ -57,6 +59,8 @@ ExecutionEngine::SubmitResult ExecutionEngine::submit_order(const Signal& signal
     order.strategy_name = signal.strategy_name;
     order.market_id = signal.market_id;
     order.token_id = signal.token_id;
+    order.market_handle = market_handle_of(signal);
+    order.token_handle = token_handle_of(signal);
     order.side = signal.side;
     order.type = OrderType::LIMIT;
     order.price = signal.target_price;
@@ -137,6 +141,8 @@ ExecutionEngine::SubmitResult ExecutionEngine::submit_paired_order(
     pair.yes_order.strategy_name = yes_signal.strategy_name;
     pair.yes_order.market_id = yes_signal.market_id;
     pair.yes_order.token_id = yes_signal.token_id;
+    pair.yes_order.market_handle = market_handle_of(yes_signal);
+    pair.yes_order.token_handle = token_handle_of(yes_signal);
     pair.yes_order.side = yes_signal.side;
     pair.yes_order.type = OrderType::IOC;  // Use IOC for paired orders
     pair.yes_order.price = yes_signal.target_price;
@@ -149,6 +155,8 @@ ExecutionEngine::SubmitResult ExecutionEngine::submit_paired_order(
     pair.no_order.strategy_name = no_signal.strategy_name;
     pair.no_order.market_id = no_signal.market_id;
     pair.no_order.token_id = no_signal.token_id;
+    pair.no_order.market_handle = market_handle_of(no_signal);
+    pair.no_order.token_handle = token_handle_of(no_signal);
     pair.no_order.side = no_signal.side;
     pair.no_order.type = OrderType::IOC;
     pair.no_order.price = no_signal.target_price;
@@ -280,10 +288,12 @@ std::vector<Order> ExecutionEngine::get_open_orders() const {
 }
 
 std::vector<Order> ExecutionEngine::get_orders_for_market(const std::string& market_id) const {
+    MarketHandle market = SymbolRegistry::instance().find_market(market_id);
     std::lock_guard<std::mutex> lock(orders_mutex_);
     std::vector<Order> result;
+    if (market == NO_SYMBOL) return result;
     for (const auto& [id, order] : orders_) {
-        if (order.market_id == market_id) {
+        if (order.market_handle == market) {
             result.push_back(order);
         }
     }
@@ -445,12 +455,14 @@ void ExecutionEngine::simulate_fill(Order& order) {
     fill.trade_id = generate_order_id();
     fill.market_id = order.market_id;
     fill.token_id = order.token_id;
+    fill.market_handle = order.market_handle;
+    fill.token_handle = order.token_handle;
     fill.side = order.side;
     fill.price = adverse_price;  // ADVERSARIAL: slippage applied
     fill.size = order.original_size * fill_ratio;
     fill.notional = fill.price * fill.size;
     // Correct Polymarket parabolic fee: fee = price * (1 - price) * 0.0624 per share
-    double per_share_fee = fill.price * (1.0 - fill.price) * 0.0624;
+    double per_share_fee = fixed_fee_per_share(fill.price, POLYMARKET_PRICE_SCALE);
     fill.fee = per_share_fee * fill.size;
     fill.fill_time = now();
     fill.exchange_time_ms = now_ms();
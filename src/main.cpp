@@ -1,6 +1,8 @@
 #include <iostream>
 #include <csignal>
 #include <atomic>
+#include <algorithm>
+#include <cmath>
 #include <CLI/CLI.hpp>
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
@@ -9,7 +11,11 @@
 #include "common/types.hpp"
 #include "config/config.hpp"
 #include "market_data/binance_client.hpp"
+#include "market_data/book_handoff.hpp"
 #include "market_data/polymarket_client.hpp"
+#include "market_data/market_discovery.hpp"
+#include "market_data/market_table.hpp"
+#include "market_data/resolver_cache.hpp"
 #include "strategy/strategy_base.hpp"
 #include "risk/risk_manager.hpp"
 #include "execution/execution_engine.hpp"
@@ -222,6 +228,8 @@ void print_startup_banner(const Config& config) {
 }
 
 int main(int argc, char* argv[]) {
+    const Timestamp startup_time = now();
+
     // CLI parsing
     CLI::App app{"DailyArb - Low-Latency Binary Outcome Arbitrage Bot"};
 
@@ -310,7 +318,13 @@ int main(int argc, char* argv[]) {
     // Position manager
     auto position_manager = std::make_shared<PositionManager>();
 
-    // Market data clients
+    // Top-of-book changes from the feed threads to the trading loop.
+    // Declared first so it outlives every thread that publishes into it.
+    BookHandoff handoff;
+
+    // Market data clients; feed hosts stay resolved so reconnects skip DNS
+    ResolverCache::instance().set_refresh_interval(
+        std::chrono::milliseconds(config.connection.dns_refresh_ms));
     auto binance_client = std::make_shared<BinanceClient>(config.connection);
     auto polymarket_client = std::make_shared<PolymarketClient>(config.connection);
 
@@ -384,6 +398,38 @@ int main(int argc, char* argv[]) {
         }
     });
 
+    // Feed threads only say which market moved; the trading loop reads the book
+    polymarket_client->set_book_callback([&](MarketHandle market, TokenHandle) {
+        handoff.publish(market);
+    });
+    // A BTC move is news for every market, but only S1 and S3 read it, and a
+    // pass per tick would keep the loop from ever sleeping. Ask for a full pass
+    // once BTC has moved lag_move_threshold_bps from where the last one was
+    // asked for; in between, book changes are still evaluated at the latest price.
+    std::atomic<double> full_pass_btc_mid{0.0};
+    if (config.strategy.enable_s1 || config.strategy.enable_s3) {
+        binance_client->set_price_callback([&](const BtcPrice& price) {
+            if (price.mid <= 0.0) return;
+            double ref = full_pass_btc_mid.load(std::memory_order_relaxed);
+            if (ref > 0.0 &&
+                std::abs(price.mid - ref) / ref * 10000.0 < config.strategy.lag_move_threshold_bps) {
+                return;
+            }
+            // Redundant connections can race here; one of them asks
+            if (full_pass_btc_mid.compare_exchange_strong(ref, price.mid, std::memory_order_relaxed)) {
+                handoff.publish_all();
+            }
+        });
+    }
+
+    // Every gap is time S1/S2 can't see the market
+    binance_client->set_feed_gap_callback([&](Duration gap) {
+        METRIC_HISTOGRAM("binance.feed_gap").record(gap);
+    });
+    polymarket_client->set_feed_gap_callback([&](Duration gap) {
+        METRIC_HISTOGRAM("polymarket.feed_gap").record(gap);
+    });
+
     // Start connections
     spdlog::info("Connecting to data sources...");
     binance_client->connect();
@@ -420,28 +466,74 @@ int main(int argc, char* argv[]) {
         return 0;
     }
 
-    // Fetch and subscribe to markets using config pattern
+    // Discover, subscribe and bootstrap markets matching the config pattern.
+    // The first pass runs here; later passes pick up new markets and drop
+    // expired ones in the background. Markets listed before they open (the
+    // next 15-minute window) are warmed up and swapped in at their start.
     spdlog::info("Fetching markets with pattern: '{}'", config.market_pattern.empty() ? "(all)" : config.market_pattern);
-    auto markets = polymarket_client->fetch_filtered_markets(config.market_pattern);
+    MarketDiscovery discovery(*polymarket_client, config.market_pattern, config.connection);
+    discovery.set_ready_callback([&](const Market& market, Duration open_to_ready) {
+        auto ready_ms = std::chrono::duration_cast<std::chrono::milliseconds>(open_to_ready).count();
+        METRIC_HISTOGRAM("rollover.open_to_ready").record(open_to_ready);
+        METRIC_GAUGE("rollover.open_to_ready_ms").set(static_cast<double>(ready_ms));
+        ui->log_info("Rolled into " + market.question + " (" + std::to_string(ready_ms) + " ms after open)");
+    });
+    DiscoveryResult discovered = discovery.refresh();
 
-    if (markets.empty()) {
+    if (discovered.listed == 0) {
         spdlog::warn("No markets found matching pattern '{}'. Use --list-markets to see available options.",
                      config.market_pattern);
         spdlog::warn("Tip: Set market_pattern to \"\" in config to trade all markets with S2 underpricing.");
     } else {
-        spdlog::info("Found {} markets to monitor", markets.size());
-        for (const auto& market : markets) {
-            polymarket_client->subscribe_market(market.yes_outcome.token_id);
-            polymarket_client->subscribe_market(market.no_outcome.token_id);
-
-            // Set first market as active in UI
-            if (ui) {
-                ui->set_active_market(market.condition_id);
-            }
-
-            spdlog::info("Subscribed to: {}", market.question);
+        spdlog::info("Found {} markets to monitor ({} opening later)", discovered.listed, discovered.pending);
+
+        const auto& bootstrap = discovered.bootstrap;
+        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(bootstrap.elapsed).count();
+        spdlog::info("Bootstrapped {}/{} books ({} markets ready, {} failed) in {} ms",
+                     bootstrap.loaded, bootstrap.requested, bootstrap.markets_ready,
+                     bootstrap.failed, elapsed_ms);
+        METRIC_GAUGE("startup.book_bootstrap_ms").set(static_cast<double>(elapsed_ms));
+
+        if (bootstrap.first_tradeable) {
+            auto ready_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                *bootstrap.first_tradeable - startup_time).count();
+            METRIC_GAUGE("startup.first_tradeable_book_ms").set(static_cast<double>(ready_ms));
+            spdlog::info("First tradeable book {} ms after startup", ready_ms);
         }
     }
+    discovery.start();
+
+    // Markets being traded; swapped whenever discovery publishes a new set
+    std::shared_ptr<const MarketSet> market_set = discovery.current();
+    if (ui && !market_set->markets.empty()) {
+        ui->set_active_market(market_set->markets.front().condition_id);
+    }
+
+    // Per-strategy prefilter results, reused every full pass
+    std::vector<std::vector<MarketHandle>> strategy_candidates(strategies.size());
+    std::vector<bool> strategy_screened(strategies.size(), false);
+
+    // Traded books by MarketHandle, for the markets the handoff reports
+    std::vector<BinaryMarketBook*> books_by_handle;
+    auto index_books = [&] {
+        std::fill(books_by_handle.begin(), books_by_handle.end(), nullptr);
+        for (BinaryMarketBook* book : market_set->books) {
+            MarketHandle market = book->market_handle();
+            if (market >= books_by_handle.size()) books_by_handle.resize(market + 1, nullptr);
+            books_by_handle[market] = book;
+        }
+    };
+    index_books();
+    std::vector<MarketHandle> changed_markets;
+
+    // Top of book of every traded market for the strategy prefilters. Only
+    // this thread touches it, refreshing rows from the books themselves.
+    MarketTable market_table;
+    handoff.publish_all();  // The first pass looks at every market
+
+    // Polymarket shard counters at the last metrics sample, for rates
+    std::vector<FeedShardStats> shard_sampled(polymarket_client->shard_count());
+    Timestamp shard_sampled_at = now();
 
     // Start UI
     ui->start();
@@ -477,28 +569,57 @@ int main(int argc, char* argv[]) {
             continue;
         }
 
+        // Pick up markets discovery added or expired since the last pass
+        bool set_changed = discovery.version() != market_set->version;
+        if (set_changed) {
+            market_set = discovery.current();
+            index_books();
+            METRIC_GAUGE("markets_live").set(static_cast<double>(market_set->books.size()));
+        }
+
+        // Markets whose top of book moved since the last pass, each once however
+        // often it moved. A BTC move, a full queue or a new market set means all.
+        changed_markets.clear();
+        bool full_pass = handoff.drain(changed_markets) || set_changed;
+
+        // A full pass may stand in for events a full ring dropped, or bring
+        // new markets, so it refreshes every row
+        if (full_pass) {
+            for (BinaryMarketBook* book : market_set->books) {
+                market_table.update(*book);
+            }
+        } else {
+            for (MarketHandle market : changed_markets) {
+                if (market < books_by_handle.size() && books_by_handle[market]) {
+                    market_table.update(*books_by_handle[market]);
+                }
+            }
+        }
+
         // Get current BTC price
         BtcPrice btc_price = binance_client->current_price();
         Timestamp now_time = now();
 
-        // Evaluate strategies for each market
-        for (const auto& market : markets) {
-            auto* book = polymarket_client->get_market_book(market.condition_id);
-            if (!book || !book->has_liquidity()) {
-                continue;
+        // Evaluate strategies for one market; screened applies the prefilter
+        auto evaluate_market = [&](BinaryMarketBook* book, bool screened) {
+            BinaryBookSnapshot snap = book->snapshot(1);
+            if (!snap.has_liquidity()) {
+                return;
             }
 
             // Update mark prices for position manager
-            if (auto yes_ask = book->yes_book().best_ask()) {
-                position_manager->mark_to_market(market.yes_outcome.token_id, yes_ask->price);
-            }
-            if (auto no_ask = book->no_book().best_ask()) {
-                position_manager->mark_to_market(market.no_outcome.token_id, no_ask->price);
-            }
+            position_manager->mark_to_market(book->yes_token(), snap.yes.asks[0].price);
+            position_manager->mark_to_market(book->no_token(), snap.no.asks[0].price);
 
             // Evaluate each strategy
-            for (auto& strategy : strategies) {
+            for (size_t s = 0; s < strategies.size(); ++s) {
+                auto& strategy = strategies[s];
                 if (!strategy->is_enabled()) continue;
+                if (screened && strategy_screened[s] &&
+                    !std::binary_search(strategy_candidates[s].begin(), strategy_candidates[s].end(),
+                                        book->market_handle())) {
+                    continue;
+                }
 
                 auto signals = strategy->evaluate(*book, btc_price, now_time);
 
@@ -512,8 +633,8 @@ int main(int argc, char* argv[]) {
                         // Find the matching pair
                         for (size_t i = 0; i < signals.size(); i++) {
                             for (size_t j = i + 1; j < signals.size(); j++) {
-                                if (signals[i].market_id == signals[j].market_id &&
-                                    signals[i].token_id != signals[j].token_id) {
+                                if (signals[i].market_handle == signals[j].market_handle &&
+                                    signals[i].token_handle != signals[j].token_handle) {
                                     auto result = execution_engine->submit_paired_order(signals[i], signals[j]);
                                     if (result.accepted) {
                                         spdlog::info("Paired order submitted: {}", result.order_id);
@@ -531,6 +652,24 @@ int main(int argc, char* argv[]) {
                     }
                 }
             }
+        };
+
+        if (full_pass) {
+            // Screen all markets from the market table in one pass per strategy
+            for (size_t s = 0; s < strategies.size(); ++s) {
+                strategy_candidates[s].clear();
+                strategy_screened[s] = strategies[s]->is_enabled() &&
+                    strategies[s]->prefilter(market_table, strategy_candidates[s]);
+            }
+            for (BinaryMarketBook* book : market_set->books) {
+                evaluate_market(book, true);
+            }
+        } else {
+            for (MarketHandle market : changed_markets) {
+                if (market < books_by_handle.size() && books_by_handle[market]) {
+                    evaluate_market(books_by_handle[market], false);
+                }
+            }
         }
 
         // Update metrics
@@ -538,8 +677,40 @@ int main(int argc, char* argv[]) {
         METRIC_GAUGE("daily_pnl").set(risk_manager->daily_pnl());
         METRIC_GAUGE("exposure").set(risk_manager->current_exposure());
 
-        // Small sleep to control loop rate
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        // Per-shard message rate and parse time, once a second
+        Timestamp sample_time = now();
+        if (sample_time - shard_sampled_at >= std::chrono::seconds(1)) {
+            double seconds = std::chrono::duration<double>(sample_time - shard_sampled_at).count();
+            for (size_t shard = 0; shard < shard_sampled.size(); ++shard) {
+                FeedShardStats stats = polymarket_client->shard_stats(shard);
+                const FeedShardStats& last = shard_sampled[shard];
+                int64_t messages = stats.messages - last.messages;
+                std::string prefix = "polymarket.shard" + std::to_string(shard + 1);
+                METRIC_GAUGE(prefix + ".msgs_per_sec").set(messages / seconds);
+                METRIC_GAUGE(prefix + ".parse_us").set(
+                    messages > 0 ? (stats.parse_ns_total - last.parse_ns_total) / 1000.0 / messages : 0.0);
+                METRIC_GAUGE(prefix + ".parse_max_us").set(stats.parse_ns_max / 1000.0);
+                METRIC_GAUGE(prefix + ".tokens").set(static_cast<double>(polymarket_client->shard_tokens(shard)));
+                shard_sampled[shard] = stats;
+            }
+            shard_sampled_at = sample_time;
+
+            // Skew plus fastest path; exchange_to_local above it is queueing
+            if (auto offset = binance_client->latency().clock_offset_ns()) {
+                METRIC_GAUGE("binance.clock_offset_ms").set(*offset / 1e6);
+            }
+            if (auto offset = polymarket_client->latency().clock_offset_ns()) {
+                METRIC_GAUGE("polymarket.clock_offset_ms").set(*offset / 1e6);
+            }
+
+            BookHandoffStats handoff_stats = handoff.stats();
+            METRIC_GAUGE("handoff.queue_depth").set(static_cast<double>(handoff_stats.depth));
+            METRIC_GAUGE("handoff.max_queue_depth").set(static_cast<double>(handoff_stats.max_depth));
+            METRIC_GAUGE("handoff.conflation_ratio").set(handoff_stats.conflation_ratio());
+        }
+
+        // Sleep until a feed thread hands over a change; wake anyway for housekeeping
+        handoff.wait(std::chrono::milliseconds(100));
     }
 
     // Shutdown
@@ -552,6 +723,7 @@ int main(int argc, char* argv[]) {
     ui->stop();
 
     // Disconnect
+    discovery.stop();
     binance_client->disconnect();
     polymarket_client->disconnect();
 
@@ -563,6 +735,49 @@ int main(int argc, char* argv[]) {
     spdlog::info("Total trades: {}", execution_engine->orders_filled());
     spdlog::info("Total fees: ${:.2f}", position_manager->total_fees());
 
+    auto log_feed = [](const char* name, const WebSocketClientBase& feed) {
+        spdlog::info("{}: {} feed gaps, longest {} ms", name, feed.feed_gaps(), feed.max_feed_gap_us() / 1000);
+        const FeedLatency& latency = feed.latency();
+        auto p50_us = [](const LatencyHistogram& h) { return h.p50().count() / 1000.0; };
+        auto p99_us = [](const LatencyHistogram& h) { return h.p99().count() / 1000.0; };
+        spdlog::info("{} latency p50/p99: wire->parse {:.1f}/{:.1f} us, parse->book {:.1f}/{:.1f} us, "
+                     "exchange->local {:.2f}/{:.2f} ms (clock offset {})",
+                     name, p50_us(latency.wire_to_parse()), p99_us(latency.wire_to_parse()),
+                     p50_us(latency.parse_to_book()), p99_us(latency.parse_to_book()),
+                     p50_us(latency.exchange_to_local()) / 1000.0, p99_us(latency.exchange_to_local()) / 1000.0,
+                     latency.clock_offset_ns() ? fmt::format("{:.2f} ms", *latency.clock_offset_ns() / 1e6)
+                                               : std::string("unknown"));
+        for (size_t path = 0; path < feed.connection_count(); ++path) {
+            WsConnectionStats ws = feed.connection_stats(path);
+            FeedPathStats race = feed.path_stats(path);
+            spdlog::info("{} #{}: {} connects ({} TLS resumed), won {:.1f}% of {} messages, "
+                         "{:.0f} us behind when second, {} kernel-stamped reads",
+                         name, path + 1, ws.connects, ws.tls_resumptions,
+                         race.win_rate() * 100.0, race.messages, race.mean_lag_us(), ws.kernel_stamped_reads);
+        }
+    };
+    log_feed("Binance", *binance_client);
+    log_feed("Polymarket", *polymarket_client);
+    for (size_t shard = 0; shard < polymarket_client->shard_count(); ++shard) {
+        FeedShardStats stats = polymarket_client->shard_stats(shard);
+        spdlog::info("Polymarket shard {}: {} tokens, {} messages, {:.1f} us mean / {:.1f} us max to parse, "
+                     "{} feed gaps", shard + 1, polymarket_client->shard_tokens(shard), stats.messages,
+                     stats.mean_parse_us(), stats.parse_ns_max / 1000.0, stats.feed_gaps);
+    }
+    if (polymarket_client->shard_count() > 1) {
+        spdlog::info("Polymarket shards: {} market groups moved to rebalance", polymarket_client->shard_moves());
+    }
+
+    BookHandoffStats handoff_stats = handoff.stats();
+    spdlog::info("Book handoff: {} updates reached the trading loop as {} market events ({:.1f}x conflation), "
+                 "{} full passes, deepest queue {}, {} overflows",
+                 handoff_stats.published, handoff_stats.delivered, handoff_stats.conflation_ratio(),
+                 handoff_stats.full_passes, handoff_stats.max_depth, handoff_stats.overflows);
+
+    HttpClientStats http = polymarket_client->http_stats();
+    spdlog::info("REST: {} requests over {} connections ({} failed)",
+                 http.requests, http.connects, http.failures);
+
     std::cout << "\nMetrics:\n" << MetricsRegistry::instance().to_json() << "\n";
 
     spdlog::info("DailyArb shutdown complete.");
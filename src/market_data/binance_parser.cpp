@@ -0,0 +1,184 @@
+#include "market_data/binance_parser.hpp"
+#include "market_data/json_scanner.hpp"
+#include <nlohmann/json.hpp>
+#include <charconv>
+#include <cstring>
+#include <string>
+
+namespace arb {
+
+bool BinanceTick::set_symbol(std::string_view s) {
+    if (s.size() > MAX_SYMBOL) return false;
+    std::memcpy(symbol_buf, s.data(), s.size());
+    symbol_buf[s.size()] = '\0';
+    symbol_len = s.size();
+    return true;
+}
+
+namespace {
+    // The keys either schema uses, indexed by their single character
+    struct Fields {
+        JsonField e, s, u, t, b, B, a, A, p, q, E;
+
+        JsonField* find(char key) {
+            switch (key) {
+                case 'e': return &e;
+                case 's': return &s;
+                case 'u': return &u;
+                case 't': return &t;
+                case 'b': return &b;
+                case 'B': return &B;
+                case 'a': return &a;
+                case 'A': return &A;
+                case 'p': return &p;
+                case 'q': return &q;
+                case 'E': return &E;
+                default: return nullptr;
+            }
+        }
+    };
+
+    bool scan_fields(std::string_view msg, Fields& fields) {
+        JsonScanner scan(msg);
+        if (!scan.consume('{')) return false;
+        if (scan.consume('}')) return scan.at_end();
+
+        // Neither schema nests, so a nested value anywhere declines the frame
+        JsonField ignored;
+        do {
+            std::string_view key;
+            if (!scan.key(key)) return false;
+
+            JsonField* field = key.size() == 1 ? fields.find(key[0]) : nullptr;
+            if (!scan.scalar(field ? *field : ignored)) return false;
+        } while (scan.consume(','));
+
+        return scan.consume('}') && scan.at_end();
+    }
+
+    bool parse_int(const JsonField& field, int64_t& out) {
+        if (field.is_string) return false;
+        const char* first = field.raw.data();
+        const char* last = first + field.raw.size();
+        auto [ptr, ec] = std::from_chars(first, last, out);
+        return ec == std::errc() && ptr == last;
+    }
+
+    bool parse_price(std::string_view text, const FixedScale* scale, Price& out) {
+        if (scale && parse_fixed_price(text, *scale, out)) return true;
+        return parse_decimal(text, out);
+    }
+
+    // Optional integer field: absent is fine, anything but an integer is not
+    bool optional_int(const JsonField& field, int64_t& out) {
+        return !field.present || parse_int(field, out);
+    }
+
+    // Optional decimal string: absent or non-string leaves out untouched
+    bool optional_decimal(const JsonField& field, double& out) {
+        return !field.present || !field.is_string || parse_decimal(field.raw, out);
+    }
+}
+
+bool parse_binance_message(std::string_view msg, const FixedScale* price_scale, BinanceTick& out) {
+    Fields f;
+    if (!scan_fields(msg, f)) return false;
+
+    BinanceTick tick;
+    if (f.s.present && f.s.is_string && !tick.set_symbol(f.s.raw)) return false;
+    if (!optional_int(f.E, tick.event_time_ms)) return false;
+
+    std::string_view event = f.e.present && f.e.is_string ? f.e.raw : std::string_view();
+    if (f.e.present && !f.e.is_string) return false;
+
+    if (event == "trade") {
+        if (f.p.present && f.p.is_string) {
+            tick.kind = BinanceTick::Kind::TRADE;
+            if (!parse_price(f.p.raw, price_scale, tick.price)) return false;
+            if (!optional_decimal(f.q, tick.qty)) return false;
+            if (!optional_int(f.t, tick.update_id)) return false;
+        }
+    } else if (event.empty() || event == "bookTicker") {
+        if (f.b.present && f.b.is_string && f.a.present && f.a.is_string) {
+            tick.kind = BinanceTick::Kind::BOOK_TICKER;
+            if (!parse_price(f.b.raw, price_scale, tick.bid)) return false;
+            if (!parse_price(f.a.raw, price_scale, tick.ask)) return false;
+            if (!optional_decimal(f.B, tick.bid_qty)) return false;
+            if (!optional_decimal(f.A, tick.ask_qty)) return false;
+            if (!optional_int(f.u, tick.update_id)) return false;
+        }
+    }
+
+    out = tick;
+    return true;
+}
+
+namespace {
+    Price json_price(const std::string& text, const FixedScale* scale) {
+        Price price = 0.0;
+        if (scale && parse_fixed_price(text, *scale, price)) return price;
+        return std::stod(text);
+    }
+
+    bool json_int(const nlohmann::json& j, const char* key, int64_t& out) {
+        auto it = j.find(key);
+        if (it == j.end()) return true;
+        if (!it->is_number_integer()) return false;
+        out = it->get<int64_t>();
+        return true;
+    }
+
+    void json_decimal(const nlohmann::json& j, const char* key, double& out) {
+        auto it = j.find(key);
+        if (it != j.end() && it->is_string()) out = std::stod(it->get_ref<const std::string&>());
+    }
+
+    bool json_string(const nlohmann::json& j, const char* key) {
+        auto it = j.find(key);
+        return it != j.end() && it->is_string();
+    }
+}
+
+bool parse_binance_message_json(std::string_view msg, const FixedScale* price_scale, BinanceTick& out) {
+    try {
+        auto j = nlohmann::json::parse(msg.begin(), msg.end());
+        if (!j.is_object()) return false;
+
+        BinanceTick tick;
+        if (json_string(j, "s") && !tick.set_symbol(j["s"].get_ref<const std::string&>())) return false;
+        if (!json_int(j, "E", tick.event_time_ms)) return false;
+
+        std::string event;
+        if (j.contains("e")) {
+            if (!j["e"].is_string()) return false;
+            event = j["e"].get<std::string>();
+        }
+
+        if (event == "trade") {
+            if (json_string(j, "p")) {
+                tick.kind = BinanceTick::Kind::TRADE;
+                tick.price = json_price(j["p"].get_ref<const std::string&>(), price_scale);
+                json_decimal(j, "q", tick.qty);
+                if (!json_int(j, "t", tick.update_id)) return false;
+            }
+        } else if (event.empty() || event == "bookTicker") {
+            // bookTicker format:
+            // {"u":12345,"s":"BTCUSDT","b":"42000.00","B":"1.5","a":"42001.00","A":"2.0"}
+            if (json_string(j, "b") && json_string(j, "a")) {
+                tick.kind = BinanceTick::Kind::BOOK_TICKER;
+                tick.bid = json_price(j["b"].get_ref<const std::string&>(), price_scale);
+                tick.ask = json_price(j["a"].get_ref<const std::string&>(), price_scale);
+                json_decimal(j, "B", tick.bid_qty);
+                json_decimal(j, "A", tick.ask_qty);
+                if (!json_int(j, "u", tick.update_id)) return false;
+            }
+        }
+
+        out = tick;
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+} // namespace arb
@@ -0,0 +1,183 @@
+#include "market_data/book_handoff.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <utility>
+
+namespace arb {
+
+namespace {
+    std::atomic<uint64_t> next_handoff_id{1};
+}
+
+BookHandoff::BookHandoff(size_t ring_capacity)
+    : id_(next_handoff_id.fetch_add(1))
+    , ring_capacity_(std::max<size_t>(ring_capacity, 2))
+{
+}
+
+BookHandoff::~BookHandoff() {
+    for (auto& chunk : pending_) delete[] chunk.load();
+}
+
+void BookHandoff::publish(MarketHandle market) {
+    published_.fetch_add(1, std::memory_order_relaxed);
+
+    std::atomic<uint8_t>* flag = pending_flag(market);
+    if (!flag) {
+        publish_all();
+        return;
+    }
+    // Already queued: the strategy thread will read this update with it
+    if (flag->exchange(1, std::memory_order_acq_rel)) return;
+
+    Ring* ring = producer_ring();
+    if (!ring || !ring->push(market)) {
+        // A full pass covers this market; let its next update queue again
+        flag->store(0, std::memory_order_release);
+        overflows_.fetch_add(1, std::memory_order_relaxed);
+        all_pending_.store(true, std::memory_order_release);
+    }
+    wake();
+}
+
+void BookHandoff::publish_all() {
+    all_pending_.store(true, std::memory_order_release);
+    wake();
+}
+
+void BookHandoff::wake() {
+    // Pairs with the fence in wait(): either we see the sleeper or it sees our event
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!sleeping_.load(std::memory_order_relaxed)) return;
+
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    wake_cv_.notify_one();
+}
+
+bool BookHandoff::wait(Duration timeout) {
+    if (has_pending()) return true;
+
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    sleeping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool woken = wake_cv_.wait_for(lock, timeout, [this] { return has_pending(); });
+    sleeping_.store(false, std::memory_order_relaxed);
+    return woken;
+}
+
+bool BookHandoff::has_pending() const {
+    if (all_pending_.load(std::memory_order_acquire)) return true;
+    size_t count = ring_count_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        if (producers_[i].load(std::memory_order_acquire)->ring.size() > 0) return true;
+    }
+    return false;
+}
+
+bool BookHandoff::drain(std::vector<MarketHandle>& out) {
+    bool all = all_pending_.exchange(false, std::memory_order_acq_rel);
+    size_t first = out.size();
+
+    size_t count = ring_count_.load(std::memory_order_acquire);
+    size_t depth = 0;
+    for (size_t i = 0; i < count; ++i) {
+        depth += producers_[i].load(std::memory_order_acquire)->ring.size();
+    }
+    if (depth > max_depth_.load(std::memory_order_relaxed)) {
+        max_depth_.store(depth, std::memory_order_relaxed);  // Strategy thread is the only writer
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        Ring& ring = producers_[i].load(std::memory_order_acquire)->ring;
+        MarketHandle market;
+        while (ring.pop(market)) {
+            // Cleared before the book is read, so a later update queues again.
+            // The RMW acquires every update conflated into this event.
+            pending_flag(market)->exchange(0, std::memory_order_acq_rel);
+            out.push_back(market);
+        }
+    }
+
+    // A market can come round twice when it updates again mid-drain
+    std::sort(out.begin() + static_cast<std::ptrdiff_t>(first), out.end());
+    out.erase(std::unique(out.begin() + static_cast<std::ptrdiff_t>(first), out.end()), out.end());
+
+    delivered_.fetch_add(static_cast<int64_t>(out.size() - first), std::memory_order_relaxed);
+    if (all) full_passes_.fetch_add(1, std::memory_order_relaxed);
+    return all;
+}
+
+BookHandoff::Ring* BookHandoff::producer_ring() {
+    // Rings of every handoff this thread has published to, by handoff id;
+    // given back when the thread exits
+    struct Claims {
+        std::vector<std::pair<uint64_t, std::shared_ptr<Producer>>> held;
+        ~Claims() {
+            for (auto& [id, producer] : held) {
+                if (producer) producer->claimed.store(false, std::memory_order_release);
+            }
+        }
+    };
+    thread_local Claims mine;
+    for (const auto& [id, producer] : mine.held) {
+        if (id == id_) return producer ? &producer->ring : nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(register_mutex_);
+
+    // A drained ring of an exited thread. The acquire pairs with the release
+    // on exit, so its producer-side state is ours now.
+    for (const auto& producer : owned_) {
+        if (producer->claimed.load(std::memory_order_acquire) || producer->ring.size() > 0) continue;
+        producer->claimed.store(true, std::memory_order_relaxed);
+        mine.held.emplace_back(id_, producer);
+        return &producer->ring;
+    }
+
+    size_t count = ring_count_.load(std::memory_order_relaxed);
+    if (count == MAX_PRODUCERS) {
+        spdlog::warn("BookHandoff: more than {} live producer threads; extra updates force full passes",
+                     MAX_PRODUCERS);
+        mine.held.emplace_back(id_, nullptr);
+        return nullptr;
+    }
+
+    auto producer = std::make_shared<Producer>(ring_capacity_);
+    owned_.push_back(producer);
+    producers_[count].store(producer.get(), std::memory_order_release);
+    ring_count_.store(count + 1, std::memory_order_release);
+    mine.held.emplace_back(id_, producer);
+    return &producer->ring;
+}
+
+std::atomic<uint8_t>* BookHandoff::pending_flag(MarketHandle market) {
+    size_t chunk = market / FLAG_CHUNK;
+    if (chunk >= MAX_FLAG_CHUNKS) return nullptr;
+
+    std::atomic<uint8_t>* flags = pending_[chunk].load(std::memory_order_acquire);
+    if (!flags) {
+        auto* fresh = new std::atomic<uint8_t>[FLAG_CHUNK]();
+        if (pending_[chunk].compare_exchange_strong(flags, fresh, std::memory_order_acq_rel)) {
+            flags = fresh;
+        } else {
+            delete[] fresh;  // Another thread got there first; flags holds its chunk
+        }
+    }
+    return &flags[market % FLAG_CHUNK];
+}
+
+BookHandoffStats BookHandoff::stats() const {
+    BookHandoffStats s;
+    s.published = published_.load();
+    s.delivered = delivered_.load();
+    s.full_passes = full_passes_.load();
+    s.overflows = overflows_.load();
+    size_t count = ring_count_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        s.depth += producers_[i].load(std::memory_order_acquire)->ring.size();
+    }
+    s.max_depth = max_depth_.load();
+    return s;
+}
+
+} // namespace arb
@@ -0,0 +1,234 @@
+#include "market_data/event_loop.hpp"
+#include <spdlog/spdlog.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <future>
+#include <stdexcept>
+
+namespace arb {
+
+EventLoop::EventLoop() {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        throw std::runtime_error(std::string("epoll_create1 failed: ") + strerror(errno));
+    }
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        close(epoll_fd_);
+        throw std::runtime_error(std::string("eventfd failed: ") + strerror(errno));
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = wake_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+}
+
+EventLoop::~EventLoop() {
+    stop();
+    close(wake_fd_);
+    close(epoll_fd_);
+}
+
+EventLoop& EventLoop::instance() {
+    static EventLoop loop;
+    return loop;
+}
+
+void EventLoop::start(int cpu) {
+    if (running_.exchange(true)) return;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        stopped_ = false;
+    }
+    thread_ = std::thread(&EventLoop::run, this, cpu);
+}
+
+void EventLoop::stop() {
+    if (!running_.exchange(false)) return;
+    wake();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    // Set under the queue lock before the last drain: a run_sync() task
+    // queued before this point runs in the drain and one offered after runs
+    // inline, so callers racing with stop() are never left waiting
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        stopped_ = true;
+    }
+    run_pending();
+}
+
+bool EventLoop::in_loop_thread() const {
+    return loop_thread_id_.load() == std::this_thread::get_id();
+}
+
+void EventLoop::post(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        pending_.push_back(std::move(task));
+    }
+    wake();
+}
+
+void EventLoop::run_sync(const Task& task) {
+    if (in_loop_thread() || !running_.load()) {
+        task();
+        return;
+    }
+    bool run_inline = false;
+    std::promise<void> done;
+    auto finished = done.get_future();
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        if (stopped_) {
+            run_inline = true;
+        } else {
+            pending_.push_back([&] {
+                task();
+                done.set_value();
+            });
+        }
+    }
+    if (run_inline) {
+        task();  // stop() drained the queue since the check above
+        return;
+    }
+    wake();
+    finished.wait();
+}
+
+bool EventLoop::add(int fd, uint32_t events, IoCallback cb) {
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        spdlog::error("epoll add fd {} failed: {}", fd, strerror(errno));
+        return false;
+    }
+    handlers_[fd] = std::make_shared<IoCallback>(std::move(cb));
+    fd_count_ = handlers_.size();
+    return true;
+}
+
+bool EventLoop::modify(int fd, uint32_t events) {
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev) < 0) {
+        spdlog::error("epoll modify fd {} failed: {}", fd, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void EventLoop::remove(int fd) {
+    if (handlers_.erase(fd) == 0) return;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    fd_count_ = handlers_.size();
+}
+
+EventLoop::TimerId EventLoop::run_after(std::chrono::milliseconds delay, Task task) {
+    TimerId id = next_timer_id_++;
+    Clock::time_point deadline = Clock::now() + delay;
+    timers_.emplace(std::make_pair(deadline, id), std::move(task));
+    timer_deadlines_[id] = deadline;
+    return id;
+}
+
+void EventLoop::cancel_timer(TimerId id) {
+    auto it = timer_deadlines_.find(id);
+    if (it == timer_deadlines_.end()) return;
+    timers_.erase(std::make_pair(it->second, id));
+    timer_deadlines_.erase(it);
+}
+
+void EventLoop::wake() {
+    uint64_t one = 1;
+    ssize_t n = write(wake_fd_, &one, sizeof(one));
+    (void)n;  // EAGAIN only if the counter is saturated, i.e. already awake
+}
+
+void EventLoop::run_pending() {
+    std::vector<Task> tasks;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        tasks.swap(pending_);
+    }
+    for (auto& task : tasks) {
+        task();
+    }
+}
+
+void EventLoop::run_due_timers() {
+    Clock::time_point now = Clock::now();
+    while (!timers_.empty() && timers_.begin()->first.first <= now) {
+        auto node = timers_.extract(timers_.begin());
+        timer_deadlines_.erase(node.key().second);
+        node.mapped()();
+    }
+}
+
+int EventLoop::next_timeout_ms() const {
+    if (timers_.empty()) return -1;
+    auto wait = timers_.begin()->first.first - Clock::now();
+    if (wait <= Clock::duration::zero()) return 0;
+    // Round up so a timer is never polled early and spun on
+    return static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(wait).count());
+}
+
+void EventLoop::run(int cpu) {
+    loop_thread_id_ = std::this_thread::get_id();
+
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+            spdlog::warn("Failed to pin event loop to CPU {}", cpu);
+        } else {
+            spdlog::info("Event loop pinned to CPU {}", cpu);
+        }
+    }
+
+    constexpr int MAX_EVENTS = 64;
+    epoll_event events[MAX_EVENTS];
+
+    while (running_.load()) {
+        int n = epoll_wait(epoll_fd_, events, MAX_EVENTS, next_timeout_ms());
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            spdlog::error("epoll_wait failed: {}", strerror(errno));
+            break;
+        }
+        wakeups_++;
+
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == wake_fd_) {
+                uint64_t count;
+                ssize_t r = read(wake_fd_, &count, sizeof(count));
+                (void)r;
+                continue;
+            }
+            // Looked up per event: an earlier callback may have removed this fd
+            auto it = handlers_.find(fd);
+            if (it == handlers_.end()) continue;
+            std::shared_ptr<IoCallback> handler = it->second;
+            (*handler)(events[i].events);
+        }
+
+        run_pending();
+        run_due_timers();
+    }
+
+    loop_thread_id_ = std::thread::id();
+}
+
+} // namespace arb
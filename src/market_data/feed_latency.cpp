@@ -0,0 +1,72 @@
+#include "market_data/feed_latency.hpp"
+#include <algorithm>
+
+namespace arb {
+
+ClockOffsetEstimator::ClockOffsetEstimator(Duration window, size_t intervals)
+    : interval_ns_(std::max<int64_t>(window.count() / static_cast<int64_t>(std::max<size_t>(intervals, 1)), 1))
+    , intervals_(std::max<size_t>(intervals, 1))
+{
+}
+
+void ClockOffsetEstimator::add(int64_t sample_ns, Timestamp at) {
+    int64_t epoch = at.time_since_epoch().count() / interval_ns_;
+    Interval& slot = intervals_[static_cast<size_t>(epoch) % intervals_.size()];
+
+    int64_t seen = slot.epoch.load();
+    if (seen > epoch) return;  // Already reused for a later interval
+    if (seen < epoch && slot.epoch.compare_exchange_strong(seen, epoch)) {
+        slot.min_ns.store(sample_ns);
+        return;
+    }
+
+    int64_t current = slot.min_ns.load();
+    while (sample_ns < current && !slot.min_ns.compare_exchange_weak(current, sample_ns)) {}
+}
+
+std::optional<int64_t> ClockOffsetEstimator::offset_ns(Timestamp at) const {
+    int64_t epoch = at.time_since_epoch().count() / interval_ns_;
+    int64_t oldest = epoch - static_cast<int64_t>(intervals_.size()) + 1;
+
+    std::optional<int64_t> best;
+    for (const auto& slot : intervals_) {
+        int64_t e = slot.epoch.load();
+        if (e < oldest || e > epoch) continue;
+        int64_t min_ns = slot.min_ns.load();
+        if (!best || min_ns < *best) best = min_ns;
+    }
+    return best;
+}
+
+FeedLatency::FeedLatency(const std::string& feed)
+    : wire_to_parse_(feed + ".wire_to_parse")
+    , parse_to_book_(feed + ".parse_to_book")
+    , exchange_to_local_(feed + ".exchange_to_local")
+{
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    registry.attach(wire_to_parse_);
+    registry.attach(parse_to_book_);
+    registry.attach(exchange_to_local_);
+}
+
+FeedLatency::~FeedLatency() {
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    registry.detach(wire_to_parse_);
+    registry.detach(parse_to_book_);
+    registry.detach(exchange_to_local_);
+}
+
+void FeedLatency::record(Timestamp recv_time, Timestamp parsed, Timestamp applied, int64_t exchange_ms) {
+    wire_to_parse_.record(parsed - recv_time);
+    parse_to_book_.record(applied - parsed);
+    if (exchange_ms <= 0) return;
+
+    // Receive stamp on the wall clock; applied stands in for the steady "now"
+    int64_t wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(wall_now().time_since_epoch()).count();
+    int64_t local_ns = wall_ns - (applied - recv_time).count();
+    int64_t sample_ns = local_ns - exchange_ms * 1'000'000;
+    exchange_to_local_.record_ns(sample_ns);
+    offset_.add(sample_ns, applied);
+}
+
+} // namespace arb
@@ -0,0 +1,51 @@
+#include "market_data/first_arrival_filter.hpp"
+#include <algorithm>
+#include <bit>
+#include <functional>
+
+namespace arb {
+
+FirstArrivalFilter::FirstArrivalFilter(size_t paths, size_t slots)
+    : slots_(std::bit_ceil(std::max<size_t>(slots, 1)))
+    , mask_(slots_.size() - 1)
+{
+    paths_.reserve(paths);
+    for (size_t i = 0; i < paths; ++i) {
+        paths_.push_back(std::make_unique<PathCounters>());
+    }
+}
+
+bool FirstArrivalFilter::accept(size_t path, std::string_view payload, Timestamp recv_time) {
+    PathCounters& counters = *paths_[path];
+    counters.messages.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t key = std::hash<std::string_view>{}(payload) | 1;  // Never the empty marker
+    Arrival& slot = slots_[key & mask_];
+    Timestamp::rep recv_ns = recv_time.time_since_epoch().count();
+
+    if (slot.key == key) {
+        if (slot.path != path) {
+            int64_t lag_us = std::max<int64_t>(0, (recv_ns - slot.recv_ns) / 1000);
+            counters.late.fetch_add(1, std::memory_order_relaxed);
+            counters.late_total_us.fetch_add(lag_us, std::memory_order_relaxed);
+        }
+        duplicates_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    slot = {key, recv_ns, path};
+    counters.wins.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+FeedPathStats FirstArrivalFilter::path_stats(size_t path) const {
+    const PathCounters& counters = *paths_[path];
+    FeedPathStats s;
+    s.messages = counters.messages.load();
+    s.wins = counters.wins.load();
+    s.late = counters.late.load();
+    s.late_total_us = counters.late_total_us.load();
+    return s;
+}
+
+} // namespace arb
@@ -0,0 +1,311 @@
+#include "market_data/http_client.hpp"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace arb {
+
+namespace {
+    size_t write_callback(void* contents, size_t size, size_t nmemb, std::string* output) {
+        size_t total_size = size * nmemb;
+        output->append(static_cast<char*>(contents), total_size);
+        return total_size;
+    }
+
+    // Request headers as a curl list; freed on scope exit
+    class HeaderList {
+    public:
+        explicit HeaderList(const std::vector<std::string>& headers) {
+            for (const auto& header : headers) {
+                list_ = curl_slist_append(list_, header.c_str());
+            }
+        }
+        ~HeaderList() { curl_slist_free_all(list_); }
+
+        HeaderList(const HeaderList&) = delete;
+        HeaderList& operator=(const HeaderList&) = delete;
+
+        curl_slist* get() const { return list_; }
+
+    private:
+        curl_slist* list_{nullptr};
+    };
+}
+
+HttpClient::HttpClient(HttpClientOptions options)
+    : options_(options)
+{
+    curl_global_init(CURL_GLOBAL_ALL);
+
+    share_ = curl_share_init();
+    if (!share_) {
+        throw std::runtime_error("Failed to initialize CURL share");
+    }
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, lock_share);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, unlock_share);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+}
+
+HttpClient::~HttpClient() {
+    // Handles hold references into the share; they must go first
+    for (CURL* curl : idle_) {
+        curl_easy_cleanup(curl);
+    }
+    idle_.clear();
+    for (CURLM* multi : idle_multis_) {
+        curl_multi_cleanup(multi);
+    }
+    idle_multis_.clear();
+    curl_share_cleanup(share_);
+    curl_global_cleanup();
+}
+
+void HttpClient::lock_share(CURL*, curl_lock_data data, curl_lock_access, void* user) {
+    static_cast<HttpClient*>(user)->share_locks_[data].lock();
+}
+
+void HttpClient::unlock_share(CURL*, curl_lock_data data, void* user) {
+    static_cast<HttpClient*>(user)->share_locks_[data].unlock();
+}
+
+CURL* HttpClient::create_handle() {
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        throw std::runtime_error("Failed to initialize CURL");
+    }
+
+    curl_easy_setopt(curl, CURLOPT_SHARE, share_);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, options_.timeout_ms);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, options_.connect_timeout_ms);
+    curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, options_.tcp_nodelay ? 1L : 0L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPIDLE, options_.keepalive_idle_s);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPINTVL, options_.keepalive_idle_s);
+    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION,
+                     options_.http2 ? CURL_HTTP_VERSION_2TLS : CURL_HTTP_VERSION_1_1);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+
+    handles_++;
+    return curl;
+}
+
+CURL* HttpClient::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        if (!idle_.empty()) {
+            CURL* curl = idle_.back();
+            idle_.pop_back();
+            return curl;
+        }
+    }
+    return create_handle();
+}
+
+void HttpClient::release(CURL* curl) {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    idle_.push_back(curl);
+}
+
+CURLM* HttpClient::acquire_multi() {
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        if (!idle_multis_.empty()) {
+            CURLM* multi = idle_multis_.back();
+            idle_multis_.pop_back();
+            return multi;
+        }
+    }
+    CURLM* multi = curl_multi_init();
+    if (!multi) {
+        throw std::runtime_error("Failed to initialize CURL multi");
+    }
+    return multi;
+}
+
+void HttpClient::release_multi(CURLM* multi) {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    idle_multis_.push_back(multi);
+}
+
+HttpResponse HttpClient::get(const std::string& url, const std::vector<std::string>& headers) {
+    CURL* curl = acquire();
+    curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+
+    try {
+        HttpResponse response = perform(curl, url, headers);
+        release(curl);
+        return response;
+    } catch (...) {
+        release(curl);
+        throw;
+    }
+}
+
+HttpResponse HttpClient::post(const std::string& url, std::string_view body,
+                              const std::vector<std::string>& headers) {
+    CURL* curl = acquire();
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 0L);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(body.size()));
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.data());
+
+    try {
+        HttpResponse response = perform(curl, url, headers);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, nullptr);
+        release(curl);
+        return response;
+    } catch (...) {
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, nullptr);
+        release(curl);
+        throw;
+    }
+}
+
+HttpResponse HttpClient::perform(CURL* curl, const std::string& url,
+                                 const std::vector<std::string>& headers) {
+    HttpResponse response;
+    HeaderList header_list(headers);
+
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response.body);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list.get());
+
+    CURLcode res = curl_easy_perform(curl);
+
+    // Neither may dangle into the next request on this handle
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, nullptr);
+
+    record_transfer(curl, res == CURLE_OK);
+
+    if (res != CURLE_OK) {
+        throw std::runtime_error(std::string("CURL request failed: ") + curl_easy_strerror(res));
+    }
+
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response.status);
+    return response;
+}
+
+void HttpClient::record_transfer(CURL* curl, bool ok) {
+    requests_++;
+    if (!ok) failures_++;
+
+    long new_connects = 0;
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &new_connects);
+    connects_ += new_connects;
+    curl_off_t total_us = 0;
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total_us);
+    total_time_us_ += static_cast<int64_t>(total_us);
+}
+
+void HttpClient::get_many(const std::vector<std::string>& urls,
+                          const std::vector<std::string>& headers,
+                          const HttpBatchOptions& batch, const BatchCallback& on_done) {
+    if (urls.empty()) return;
+
+    // Pooled, so the batch reuses the connections an earlier one left open
+    CURLM* multi = acquire_multi();
+
+    HeaderList header_list(headers);
+    const size_t concurrency = static_cast<size_t>(std::max(1, batch.max_concurrency));
+
+    // One slot per transfer in flight; a slot keeps its handle for the batch
+    struct Slot {
+        CURL* curl{nullptr};
+        size_t index{0};
+        HttpResponse response;
+    };
+    std::vector<Slot> slots(std::min(concurrency, urls.size()));
+    std::vector<Slot*> free_slots;
+    for (auto& slot : slots) {
+        slot.curl = acquire();
+        curl_easy_setopt(slot.curl, CURLOPT_HTTPGET, 1L);
+        curl_easy_setopt(slot.curl, CURLOPT_FOLLOWLOCATION, 1L);
+        curl_easy_setopt(slot.curl, CURLOPT_HTTPHEADER, header_list.get());
+        curl_easy_setopt(slot.curl, CURLOPT_PRIVATE, &slot);
+        free_slots.push_back(&slot);
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto start_interval = batch.max_rate > 0
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / batch.max_rate))
+        : Clock::duration::zero();
+    auto next_start = Clock::now();
+
+    size_t next_url = 0;
+    size_t in_flight = 0;
+    std::string error;
+
+    while (next_url < urls.size() || in_flight > 0) {
+        while (next_url < urls.size() && !free_slots.empty() && Clock::now() >= next_start) {
+            Slot* slot = free_slots.back();
+            free_slots.pop_back();
+            slot->index = next_url;
+            slot->response = HttpResponse{};
+            curl_easy_setopt(slot->curl, CURLOPT_URL, urls[next_url].c_str());
+            curl_easy_setopt(slot->curl, CURLOPT_WRITEDATA, &slot->response.body);
+            curl_multi_add_handle(multi, slot->curl);
+            ++next_url;
+            ++in_flight;
+            next_start = Clock::now() + start_interval;
+        }
+
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        int queued = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi, &queued)) {
+            if (msg->msg != CURLMSG_DONE) continue;
+
+            CURL* curl = msg->easy_handle;
+            CURLcode res = msg->data.result;
+            Slot* slot = nullptr;
+            curl_easy_getinfo(curl, CURLINFO_PRIVATE, &slot);
+            curl_multi_remove_handle(multi, curl);
+            --in_flight;
+
+            record_transfer(curl, res == CURLE_OK);
+            error.clear();
+            if (res == CURLE_OK) {
+                curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &slot->response.status);
+            } else {
+                error = std::string("CURL request failed: ") + curl_easy_strerror(res);
+            }
+            on_done(slot->index, slot->response, error);
+            free_slots.push_back(slot);
+        }
+
+        // Sleep until there is socket activity, or the rate limit lets the next transfer start
+        int timeout_ms = 100;
+        if (next_url < urls.size() && !free_slots.empty()) {
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next_start - Clock::now());
+            timeout_ms = static_cast<int>(std::clamp<int64_t>(wait.count(), 0, timeout_ms));
+        }
+        if (in_flight > 0 || timeout_ms > 0) {
+            curl_multi_poll(multi, nullptr, 0, timeout_ms, nullptr);
+        }
+    }
+
+    for (auto& slot : slots) {
+        curl_easy_setopt(slot.curl, CURLOPT_HTTPHEADER, nullptr);
+        curl_easy_setopt(slot.curl, CURLOPT_WRITEDATA, nullptr);
+        curl_easy_setopt(slot.curl, CURLOPT_PRIVATE, nullptr);
+        release(slot.curl);
+    }
+    release_multi(multi);
+}
+
+HttpClientStats HttpClient::stats() const {
+    HttpClientStats s;
+    s.requests = requests_.load();
+    s.failures = failures_.load();
+    s.connects = connects_.load();
+    s.handles = handles_.load();
+    s.total_time_us = total_time_us_.load();
+    return s;
+}
+
+} // namespace arb
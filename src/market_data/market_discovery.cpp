@@ -0,0 +1,371 @@
+#include "market_data/market_discovery.hpp"
+#include "common/symbol_registry.hpp"
+#include "utils/time_utils.hpp"
+#include <spdlog/spdlog.h>
+#include <set>
+
+namespace arb {
+
+MarketDiscovery::MarketDiscovery(PolymarketClient& client, const std::string& pattern,
+                                 const ConnectionConfig& config)
+    : client_(client)
+    , pattern_(pattern)
+    , interval_(config.discovery_interval_ms)
+    , lead_(config.rollover_lead_ms)
+    , page_size_(static_cast<size_t>(std::max(1, config.discovery_page_size)))
+    , current_(std::make_shared<MarketSet>())
+{
+    if (!pattern_.empty()) {
+        try {
+            filter_.emplace(pattern_, std::regex::icase);
+        } catch (const std::regex_error& e) {
+            spdlog::error("Invalid regex pattern '{}': {}; matching all markets", pattern_, e.what());
+        }
+    }
+}
+
+MarketDiscovery::~MarketDiscovery() {
+    stop();
+}
+
+bool MarketDiscovery::matches(const Market& market) const {
+    if (!filter_) return true;
+    return std::regex_search(market.question, *filter_) || std::regex_search(market.slug, *filter_);
+}
+
+void MarketDiscovery::unsubscribe(const Market& market) {
+    client_.unsubscribe_markets({market.yes_outcome.token_id, market.no_outcome.token_id});
+}
+
+size_t MarketDiscovery::pending_markets() const {
+    std::lock_guard<std::mutex> lock(refresh_mutex_);
+    return pending_.size();
+}
+
+DiscoveryResult MarketDiscovery::refresh() {
+    // One pass at a time; refresh_mutex_ is only taken to merge, so opens and
+    // expiries never wait on the listing or the bootstrap
+    std::lock_guard<std::mutex> pass(pass_mutex_);
+    refreshes_++;
+    DiscoveryResult result;
+
+    // A pass inside the lead window covers the coming boundary
+    WallClock started = wall_now();
+    WallClock boundary = time_utils::next_15m_boundary(started);
+    if (started >= boundary - lead_) {
+        std::lock_guard<std::mutex> lock(refresh_mutex_);
+        lead_boundary_ = boundary;
+    }
+
+    // Page through the whole listing before touching anything
+    std::vector<Market> listing;
+    size_t offset = 0;
+    size_t page_items = 0;
+    do {
+        if (!client_.fetch_markets_page(offset, page_size_, listing, page_items)) {
+            failed_refreshes_++;
+            std::lock_guard<std::mutex> lock(refresh_mutex_);
+            spdlog::warn("Market discovery failed at offset {}; keeping {} known markets",
+                         offset, known_.size());
+            return result;
+        }
+        offset += page_items;
+    } while (page_items == page_size_);
+
+    WallClock wall = wall_now();
+    std::map<std::string, const Market*> live;
+    std::set<std::string> expired;  // Listed, but past their end date
+    for (const auto& market : listing) {
+        if (!matches(market)) continue;
+        if (market.end_date != WallClock{} && market.end_date <= wall) {
+            expired.insert(market.condition_id);
+            continue;
+        }
+        live.emplace(market.condition_id, &market);
+    }
+    result.ok = true;
+    result.listed = live.size();
+
+    auto& registry = SymbolRegistry::instance();
+    std::vector<const Market*> added;
+    std::vector<TokenHandle> new_tokens;
+    std::vector<std::string> new_token_ids;
+    bool changed = false;
+    {
+        std::lock_guard<std::mutex> lock(refresh_mutex_);
+
+        // Expired, or missing from consecutive listings. Offset paging can
+        // skip a market when the listing shifts under it, so one miss alone
+        // doesn't drop a live book.
+        for (auto* markets : {&known_, &pending_}) {
+            for (auto it = markets->begin(); it != markets->end();) {
+                const std::string& condition_id = it->first;
+                const Market& market = it->second;
+                if (live.count(condition_id)) {
+                    missed_passes_.erase(condition_id);
+                    ++it;
+                    continue;
+                }
+                bool ended = expired.count(condition_id) ||
+                    (market.end_date != WallClock{} && market.end_date <= wall);
+                if (!ended && ++missed_passes_[condition_id] < MISSED_PASSES_TO_DROP) {
+                    spdlog::debug("Market missing from listing, keeping for now: {}", market.question);
+                    ++it;
+                    continue;
+                }
+                unsubscribe(market);
+                if (ended) {
+                    spdlog::info("Market ended, unsubscribed: {}", market.question);
+                } else {
+                    spdlog::warn("Market missing from {} listings, unsubscribed: {}",
+                                 MISSED_PASSES_TO_DROP, market.question);
+                }
+                missed_passes_.erase(condition_id);
+                it = markets->erase(it);
+                result.removed++;
+                changed |= markets == &known_;
+            }
+        }
+
+        for (const auto& [condition_id, market] : live) {
+            if (known_.count(condition_id) || pending_.count(condition_id)) continue;
+
+            client_.register_market(*market);
+            new_token_ids.push_back(market->yes_outcome.token_id);
+            new_token_ids.push_back(market->no_outcome.token_id);
+            new_tokens.push_back(registry.find_token(market->yes_outcome.token_id));
+            new_tokens.push_back(registry.find_token(market->no_outcome.token_id));
+            added.push_back(market);
+        }
+        if (changed) {
+            publish();
+        }
+    }
+
+    // One pass over the shards, in as few subscribe messages as possible
+    client_.subscribe_markets(new_token_ids);
+    if (!new_tokens.empty()) {
+        result.bootstrap = client_.bootstrap_books(new_tokens);
+    }
+
+    std::lock_guard<std::mutex> lock(refresh_mutex_);
+    changed = false;
+    for (const Market* market : added) {
+        result.added++;
+
+        // Warm the book now; it joins the traded set when it opens
+        if (market->start_date > wall) {
+            spdlog::info("Subscribed ahead of open at {}: {}",
+                         time_utils::to_iso8601(market->start_date), market->question);
+            pending_.emplace(market->condition_id, *market);
+            result.pending++;
+        } else {
+            spdlog::info("Subscribed to: {}", market->question);
+            known_.emplace(market->condition_id, *market);
+            changed = true;
+        }
+    }
+
+    markets_added_ += static_cast<int64_t>(result.added);
+    markets_removed_ += static_cast<int64_t>(result.removed);
+
+    // The bootstrap may have run past a start or end date
+    changed |= roll(wall_now());
+    if (changed) {
+        publish();
+    }
+    check_ready(wall_now());
+    return result;
+}
+
+bool MarketDiscovery::roll(WallClock wall) {
+    bool changed = false;
+    for (auto it = known_.begin(); it != known_.end();) {
+        const Market& market = it->second;
+        if (market.end_date == WallClock{} || market.end_date > wall) {
+            ++it;
+            continue;
+        }
+        unsubscribe(market);
+        spdlog::info("Market ended, unsubscribed: {}", market.question);
+        missed_passes_.erase(it->first);
+        it = known_.erase(it);
+        markets_removed_++;
+        changed = true;
+    }
+
+    for (auto it = pending_.begin(); it != pending_.end();) {
+        const Market& market = it->second;
+        if (market.start_date > wall) {
+            ++it;
+            continue;
+        }
+        spdlog::info("Market opened: {}", market.question);
+        awaiting_ready_.push_back({market, client_.get_market_book(market.condition_id)});
+        ready_poll_ = READY_POLL;
+        known_.emplace(it->first, market);
+        it = pending_.erase(it);
+        markets_opened_++;
+        changed = true;
+    }
+    return changed;
+}
+
+void MarketDiscovery::check_ready(WallClock wall) {
+    for (auto it = awaiting_ready_.begin(); it != awaiting_ready_.end();) {
+        const Market& market = it->market;
+        if (!known_.count(market.condition_id)) {
+            it = awaiting_ready_.erase(it);  // Ended before it ever had a book
+            continue;
+        }
+        if (!it->book->snapshot(1).has_liquidity()) {
+            ++it;
+            continue;
+        }
+
+        Duration open_to_ready = std::max(
+            Duration{0}, std::chrono::duration_cast<Duration>(wall - market.start_date));
+        int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(open_to_ready).count();
+        last_open_to_ready_ms_ = ms;
+        spdlog::info("First tradeable book {} ms after open: {}", ms, market.question);
+        if (on_ready_) {
+            on_ready_(market, open_to_ready);
+        }
+        it = awaiting_ready_.erase(it);
+    }
+    if (!awaiting_ready_.empty()) {
+        ready_poll_ = std::min(ready_poll_ * 2, MAX_READY_POLL);
+    }
+}
+
+WallClock MarketDiscovery::next_wake(WallClock wall, WallClock next_refresh) const {
+    WallClock wake = wall + MAX_IDLE;
+
+    // A listing pass in flight pokes the loop when it finishes
+    if (!refreshing_.load()) {
+        wake = std::min(wake, next_refresh);
+        if (lead_.count() > 0) {
+            WallClock boundary = time_utils::next_15m_boundary(wall);
+            WallClock lead_at = boundary - lead_;
+            if (lead_boundary_ == boundary) {
+                lead_at += std::chrono::minutes(15);
+            }
+            wake = std::min(wake, lead_at);
+        }
+    }
+
+    for (const auto& [condition_id, market] : pending_) {
+        wake = std::min(wake, market.start_date);
+    }
+    for (const auto& [condition_id, market] : known_) {
+        if (market.end_date != WallClock{}) {
+            wake = std::min(wake, market.end_date);
+        }
+    }
+    if (!awaiting_ready_.empty()) {
+        wake = std::min(wake, wall + ready_poll_);
+    }
+    return wake;
+}
+
+void MarketDiscovery::publish() {
+    auto set = std::make_shared<MarketSet>();
+    set->version = version_.load(std::memory_order_relaxed) + 1;
+    set->markets.reserve(known_.size());
+    set->books.reserve(known_.size());
+    for (const auto& [condition_id, market] : known_) {
+        set->markets.push_back(market);
+        set->books.push_back(client_.get_market_book(condition_id));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(current_mutex_);
+        current_ = std::move(set);
+    }
+    version_.fetch_add(1, std::memory_order_release);
+}
+
+std::shared_ptr<const MarketSet> MarketDiscovery::current() const {
+    std::lock_guard<std::mutex> lock(current_mutex_);
+    return current_;
+}
+
+void MarketDiscovery::start() {
+    if (running_.exchange(true)) return;
+    thread_ = std::thread(&MarketDiscovery::run, this);
+}
+
+void MarketDiscovery::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        running_ = false;
+    }
+    wait_cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (refresh_thread_.joinable()) {
+        refresh_thread_.join();
+    }
+}
+
+void MarketDiscovery::start_refresh() {
+    if (refresh_thread_.joinable()) {
+        refresh_thread_.join();  // The last pass already finished
+    }
+    refreshing_ = true;
+    refresh_thread_ = std::thread([this] {
+        DiscoveryResult result = refresh();
+        if (result.added > 0 || result.removed > 0) {
+            spdlog::info("Market discovery: {} added ({} opening later), {} removed, {} live",
+                         result.added, result.pending, result.removed, result.listed);
+        }
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        refreshing_ = false;
+        poked_ = true;
+        wait_cv_.notify_all();
+    });
+}
+
+void MarketDiscovery::run() {
+    WallClock next_refresh = interval_.count() > 0 ? wall_now() + interval_ : WallClock::max();
+
+    while (running_.load()) {
+        WallClock wake;
+        {
+            std::lock_guard<std::mutex> lock(refresh_mutex_);
+            wake = next_wake(wall_now(), next_refresh);
+        }
+        {
+            std::unique_lock<std::mutex> lock(wait_mutex_);
+            wait_cv_.wait_until(lock, wake, [this] { return !running_.load() || poked_; });
+            if (!running_.load()) break;
+            poked_ = false;
+        }
+
+        WallClock wall = wall_now();
+        bool lead_due = false;
+        if (lead_.count() > 0) {
+            std::lock_guard<std::mutex> lock(refresh_mutex_);
+            WallClock boundary = time_utils::next_15m_boundary(wall);
+            lead_due = wall >= boundary - lead_ && lead_boundary_ != boundary;
+        }
+
+        // Listing passes run beside this loop, so a slow listing or bootstrap
+        // never holds up an open or an expiry
+        if ((wall >= next_refresh || lead_due) && !refreshing_.load()) {
+            start_refresh();
+            if (wall >= next_refresh) {
+                next_refresh = wall + interval_;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(refresh_mutex_);
+        if (roll(wall)) {
+            publish();
+        }
+        check_ready(wall_now());
+    }
+}
+
+} // namespace arb
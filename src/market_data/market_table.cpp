@@ -0,0 +1,123 @@
+#include "market_data/market_table.hpp"
+
+namespace arb {
+
+void underpriced_edges(const int32_t* __restrict yes_ask, const int32_t* __restrict no_ask, size_t n,
+                       const FixedScale& scale, int64_t fee_rate_ppm, double* __restrict edge) {
+    // fixed_pair_edge() in doubles: int32 -> double and double mul/add have
+    // baseline SSE2 forms, int64 multiplies do not
+    const double one = static_cast<double>(scale.units);
+    const double payout = one * one * 1e6;
+    const double cost_per_tick = one * 1e6;
+    const double rate = static_cast<double>(fee_rate_ppm);
+    for (size_t i = 0; i < n; ++i) {
+        double y = yes_ask[i];
+        double no = no_ask[i];
+        double fees = (y * (one - y) + no * (one - no)) * rate;
+        edge[i] = payout - (y + no) * cost_per_tick - fees;
+    }
+}
+
+void MarketTable::grow(size_t rows) {
+    if (rows <= yes_ask_.size()) return;
+    yes_bid_.resize(rows, 0.0);
+    yes_bid_size_.resize(rows, 0.0);
+    yes_ask_.resize(rows, NO_ASK);
+    yes_ask_size_.resize(rows, 0.0);
+    no_bid_.resize(rows, 0.0);
+    no_bid_size_.resize(rows, 0.0);
+    no_ask_.resize(rows, NO_ASK);
+    no_ask_size_.resize(rows, 0.0);
+    yes_ask_ticks_.resize(rows, static_cast<int32_t>(PRICE_SCALE.to_ticks(NO_ASK)));
+    no_ask_ticks_.resize(rows, static_cast<int32_t>(PRICE_SCALE.to_ticks(NO_ASK)));
+}
+
+void MarketTable::update(MarketHandle market, bool is_yes, const TopOfBook& top) {
+    set_leg(market, is_yes, top.best_bid, top.best_ask);
+}
+
+void MarketTable::update(const BinaryMarketBook& book) {
+    BinaryBookSnapshot snap = book.snapshot(1);
+    set_leg(book.market_handle(), true, snap.yes.best_bid(), snap.yes.best_ask());
+    set_leg(book.market_handle(), false, snap.no.best_bid(), snap.no.best_ask());
+}
+
+void MarketTable::set_leg(MarketHandle market, bool is_yes, const std::optional<PriceLevel>& best_bid,
+                          const std::optional<PriceLevel>& best_ask) {
+    if (market == NO_SYMBOL) return;
+
+    Price bid = best_bid ? best_bid->price : 0.0;
+    Size bid_size = best_bid ? best_bid->size : 0.0;
+    Price ask = best_ask ? best_ask->price : NO_ASK;
+    Size ask_size = best_ask ? best_ask->size : 0.0;
+    auto ask_ticks = static_cast<int32_t>(PRICE_SCALE.to_ticks(ask));
+
+    grow(static_cast<size_t>(market) + 1);
+
+    if (is_yes) {
+        yes_bid_[market] = bid;
+        yes_bid_size_[market] = bid_size;
+        yes_ask_[market] = ask;
+        yes_ask_size_[market] = ask_size;
+        yes_ask_ticks_[market] = ask_ticks;
+    } else {
+        no_bid_[market] = bid;
+        no_bid_size_[market] = bid_size;
+        no_ask_[market] = ask;
+        no_ask_size_[market] = ask_size;
+        no_ask_ticks_[market] = ask_ticks;
+    }
+}
+
+MarketTable::Row MarketTable::row(MarketHandle market) const {
+    Row r;
+    if (market >= yes_ask_.size()) return r;
+
+    r.yes_bid = yes_bid_[market];
+    r.yes_bid_size = yes_bid_size_[market];
+    r.yes_ask = yes_ask_[market];
+    r.yes_ask_size = yes_ask_size_[market];
+    r.no_bid = no_bid_[market];
+    r.no_bid_size = no_bid_size_[market];
+    r.no_ask = no_ask_[market];
+    r.no_ask_size = no_ask_size_[market];
+    return r;
+}
+
+size_t MarketTable::size() const {
+    return yes_ask_.size();
+}
+
+size_t MarketTable::scan_underpriced(int64_t fee_rate_ppm, double min_edge_cents,
+                                     std::vector<MarketHandle>& out) const {
+    const int64_t min_edge = fixed_edge_from_cents(min_edge_cents, PRICE_SCALE);
+
+    const size_t n = yes_ask_ticks_.size();
+    edge_scratch_.resize(n);
+    underpriced_edges(yes_ask_ticks_.data(), no_ask_ticks_.data(), n, PRICE_SCALE, fee_rate_ppm,
+                      edge_scratch_.data());
+
+    // Branch-free compaction: always write, advance only on a hit
+    const double screen = static_cast<double>(min_edge);
+    const size_t start = out.size();
+    out.resize(start + n);
+    MarketHandle* dst = out.data() + start;
+    size_t hits = 0;
+    for (size_t i = 0; i < n; ++i) {
+        dst[hits] = static_cast<MarketHandle>(i);
+        hits += edge_scratch_[i] >= screen;
+    }
+
+    // Confirm the few hits on the exact integer edge
+    size_t kept = 0;
+    for (size_t h = 0; h < hits; ++h) {
+        MarketHandle market = dst[h];
+        dst[kept] = market;
+        kept += fixed_pair_edge(yes_ask_ticks_[market], no_ask_ticks_[market], PRICE_SCALE,
+                                fee_rate_ppm) >= min_edge;
+    }
+    out.resize(start + kept);
+    return kept;
+}
+
+} // namespace arb
@@ -1,42 +1,115 @@
 #include "market_data/order_book.hpp"
+#include "common/symbol_registry.hpp"
 #include <algorithm>
 
 namespace arb {
 
+OrderBookImpl order_book_impl_from_string(const std::string& s) {
+    if (s == "tick" || s == "tick_array") return OrderBookImpl::TICK_ARRAY;
+    return OrderBookImpl::MAP;
+}
+
+std::string order_book_impl_to_string(OrderBookImpl impl) {
+    return impl == OrderBookImpl::TICK_ARRAY ? "tick" : "map";
+}
+
 OrderBook::OrderBook(const std::string& symbol, int max_levels)
+    : OrderBook(symbol, max_levels, OrderBookImpl::MAP)
+{
+}
+
+OrderBook::OrderBook(const std::string& symbol, int max_levels, OrderBookImpl impl,
+                     Price tick_size)
     : symbol_(symbol)
     , max_levels_(max_levels)
+    , impl_(impl)
     , last_update_(now())
+    , tick_bids_(true, tick_size)
+    , tick_asks_(false, tick_size)
 {
+    top_update_ns_.store(last_update_.time_since_epoch().count(), std::memory_order_relaxed);
 }
 
-void OrderBook::update_bid(Price price, Size size) {
-    std::lock_guard<std::mutex> lock(mutex_);
+void OrderBook::set_bid(Price price, Size size) {
+    if (impl_ == OrderBookImpl::TICK_ARRAY) {
+        if (!tick_bids_.set(price, size)) rejected_updates_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Ticks key = BOOK_KEY_SCALE.to_ticks(price);
     if (size <= 0.0) {
-        bids_.erase(price);
+        bids_.erase(key);
     } else {
-        bids_[price] = size;
+        bids_[key] = size;
     }
-    last_update_ = now();
-    trim_levels();
 }
 
-void OrderBook::update_ask(Price price, Size size) {
-    std::lock_guard<std::mutex> lock(mutex_);
+void OrderBook::set_ask(Price price, Size size) {
+    if (impl_ == OrderBookImpl::TICK_ARRAY) {
+        if (!tick_asks_.set(price, size)) rejected_updates_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Ticks key = BOOK_KEY_SCALE.to_ticks(price);
     if (size <= 0.0) {
-        asks_.erase(price);
+        asks_.erase(key);
     } else {
-        asks_[price] = size;
+        asks_[key] = size;
     }
+}
+
+template <typename Fn>
+void OrderBook::for_each_bid(int n, Fn&& fn) const {
+    if (impl_ == OrderBookImpl::TICK_ARRAY) {
+        tick_bids_.for_each(n, fn);
+        return;
+    }
+    int count = 0;
+    for (const auto& [key, size] : bids_) {
+        if (count >= n) break;
+        fn(BOOK_KEY_SCALE.to_double(key), size);
+        count++;
+    }
+}
+
+template <typename Fn>
+void OrderBook::for_each_ask(int n, Fn&& fn) const {
+    if (impl_ == OrderBookImpl::TICK_ARRAY) {
+        tick_asks_.for_each(n, fn);
+        return;
+    }
+    int count = 0;
+    for (const auto& [key, size] : asks_) {
+        if (count >= n) break;
+        fn(BOOK_KEY_SCALE.to_double(key), size);
+        count++;
+    }
+}
+
+void OrderBook::update_bid(Price price, Size size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    set_bid(price, size);
+    last_update_ = now();
+    rebuild_bids();
+    publish_top();
+}
+
+void OrderBook::update_ask(Price price, Size size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    set_ask(price, size);
     last_update_ = now();
-    trim_levels();
+    rebuild_asks();
+    publish_top();
 }
 
 void OrderBook::clear() {
     std::lock_guard<std::mutex> lock(mutex_);
     bids_.clear();
     asks_.clear();
+    tick_bids_.clear();
+    tick_asks_.clear();
     last_update_ = now();
+    bid_agg_.clear();
+    ask_agg_.clear();
+    publish_top();
 }
 
 void OrderBook::apply_snapshot(const std::vector<PriceLevel>& bids,
@@ -44,35 +117,233 @@ void OrderBook::apply_snapshot(const std::vector<PriceLevel>& bids,
     std::lock_guard<std::mutex> lock(mutex_);
 
     bids_.clear();
+    tick_bids_.clear();
     for (const auto& level : bids) {
         if (level.size > 0.0) {
-            bids_[level.price] = level.size;
+            set_bid(level.price, level.size);
         }
     }
 
     asks_.clear();
+    tick_asks_.clear();
     for (const auto& level : asks) {
         if (level.size > 0.0) {
-            asks_[level.price] = level.size;
+            set_ask(level.price, level.size);
         }
     }
 
     last_update_ = now();
-    trim_levels();
+    rebuild_bids();
+    rebuild_asks();
+    publish_top();
 }
 
-std::optional<PriceLevel> OrderBook::best_bid() const {
+void OrderBook::apply_snapshot(std::span<const LevelDelta> levels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    replace_levels(levels);
+    publish_top();
+}
+
+bool OrderBook::apply_snapshot(std::span<const LevelDelta> levels, uint64_t sequence) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (sequence != 0 && sequence < sequence_) return false;
+
+    replace_levels(levels);
+    sequence_ = sequence;
+    publish_top();
+    return true;
+}
+
+void OrderBook::replace_levels(std::span<const LevelDelta> levels) {
+    bids_.clear();
+    tick_bids_.clear();
+    asks_.clear();
+    tick_asks_.clear();
+    for (const auto& level : levels) {
+        if (level.size <= 0.0) continue;
+        if (level.side == Side::BUY) {
+            set_bid(level.price, level.size);
+        } else {
+            set_ask(level.price, level.size);
+        }
+    }
+
+    last_update_ = now();
+    rebuild_bids();
+    rebuild_asks();
+}
+
+DeltaResult OrderBook::apply_deltas(std::span<const LevelDelta> deltas, uint64_t sequence) {
     std::lock_guard<std::mutex> lock(mutex_);
+
+    // A snapshot from another thread overtook this batch
+    if (sequence != 0 && sequence < sequence_) {
+        DeltaResult stale;
+        stale.stale = true;
+        return stale;
+    }
+
+    auto bid_before = peek_bid();
+    auto ask_before = peek_ask();
+
+    bool bids_touched = false;
+    bool asks_touched = false;
+    for (const auto& delta : deltas) {
+        if (delta.side == Side::BUY) {
+            set_bid(delta.price, delta.size);
+            bids_touched = true;
+        } else {
+            set_ask(delta.price, delta.size);
+            asks_touched = true;
+        }
+    }
+
+    last_update_ = now();
+    if (bids_touched) rebuild_bids();
+    if (asks_touched) rebuild_asks();
+    if (sequence != 0) sequence_ = sequence;
+    publish_top();
+
+    auto bid_after = peek_bid();
+    auto ask_after = peek_ask();
+
+    auto price_of = [](const std::optional<PriceLevel>& l) { return l ? l->price : 0.0; };
+    auto size_of = [](const std::optional<PriceLevel>& l) { return l ? l->size : 0.0; };
+
+    DeltaResult result;
+    result.bid_price_changed = price_of(bid_before) != price_of(bid_after);
+    result.ask_price_changed = price_of(ask_before) != price_of(ask_after);
+    result.top_size_changed =
+        (!result.bid_price_changed && size_of(bid_before) != size_of(bid_after)) ||
+        (!result.ask_price_changed && size_of(ask_before) != size_of(ask_after));
+    return result;
+}
+
+void OrderBook::set_sequence(uint64_t seq) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sequence_ = seq;
+    publish_top();
+}
+
+std::optional<PriceLevel> OrderBook::peek_bid() const {
+    if (impl_ == OrderBookImpl::TICK_ARRAY) return tick_bids_.best();
     if (bids_.empty()) return std::nullopt;
     auto it = bids_.begin();
-    return PriceLevel{it->first, it->second};
+    return PriceLevel{BOOK_KEY_SCALE.to_double(it->first), it->second};
 }
 
-std::optional<PriceLevel> OrderBook::best_ask() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+std::optional<PriceLevel> OrderBook::peek_ask() const {
+    if (impl_ == OrderBookImpl::TICK_ARRAY) return tick_asks_.best();
     if (asks_.empty()) return std::nullopt;
     auto it = asks_.begin();
-    return PriceLevel{it->first, it->second};
+    return PriceLevel{BOOK_KEY_SCALE.to_double(it->first), it->second};
+}
+
+void OrderBook::rebuild_bids() {
+    // Already holding lock. The ladder keeps every level; the view stops at max_levels_
+    bid_agg_.clear();
+    for_each_bid(max_levels_, [&](Price price, Size size) { bid_agg_.push(price, size); });
+}
+
+void OrderBook::rebuild_asks() {
+    ask_agg_.clear();
+    for_each_ask(max_levels_, [&](Price price, Size size) { ask_agg_.push(price, size); });
+}
+
+void OrderBook::publish_top() {
+    // Already holding lock, so this is the only writer. Aggregates are current.
+    constexpr int N = BookLevels::MAX_LEVELS;
+    std::array<PriceLevel, N> bids{};
+    std::array<PriceLevel, N> asks{};
+    int bid_count = std::min(N, static_cast<int>(bid_agg_.levels.size()));
+    int ask_count = std::min(N, static_cast<int>(ask_agg_.levels.size()));
+    std::copy_n(bid_agg_.levels.begin(), bid_count, bids.begin());
+    std::copy_n(ask_agg_.levels.begin(), ask_count, asks.begin());
+    Size bid_total = bid_agg_.depth(max_levels_);
+    Size ask_total = ask_agg_.depth(max_levels_);
+
+    uint64_t v = top_version_.load(std::memory_order_relaxed);
+    top_version_.store(v + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Readers never look past the counts, so only live slots are written
+    for (int i = 0; i < bid_count; ++i) {
+        top_bid_prices_[i].store(bids[i].price, std::memory_order_relaxed);
+        top_bid_sizes_[i].store(bids[i].size, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < ask_count; ++i) {
+        top_ask_prices_[i].store(asks[i].price, std::memory_order_relaxed);
+        top_ask_sizes_[i].store(asks[i].size, std::memory_order_relaxed);
+    }
+    top_bid_count_.store(bid_count, std::memory_order_relaxed);
+    top_ask_count_.store(ask_count, std::memory_order_relaxed);
+    top_bid_depth_.store(bid_total, std::memory_order_relaxed);
+    top_ask_depth_.store(ask_total, std::memory_order_relaxed);
+    top_update_ns_.store(last_update_.time_since_epoch().count(), std::memory_order_relaxed);
+    top_sequence_.store(sequence_, std::memory_order_relaxed);
+
+    top_version_.store(v + 2, std::memory_order_release);
+}
+
+uint64_t OrderBook::read_begin() const {
+    uint64_t v;
+    while ((v = top_version_.load(std::memory_order_acquire)) & 1) {
+        // Writer mid-publish; it holds no lock we could block on, so spin
+    }
+    return v;
+}
+
+void OrderBook::load_levels(BookLevels& out, int levels) const {
+    levels = std::clamp(levels, 0, BookLevels::MAX_LEVELS);
+    // Counts are clamped too: a torn read can pair them with other fields,
+    // and the caller discards the copy in that case anyway
+    out.bid_count = std::min(top_bid_count_.load(std::memory_order_relaxed), levels);
+    out.ask_count = std::min(top_ask_count_.load(std::memory_order_relaxed), levels);
+    for (int i = 0; i < out.bid_count; ++i) {
+        out.bids[i] = {top_bid_prices_[i].load(std::memory_order_relaxed),
+                       top_bid_sizes_[i].load(std::memory_order_relaxed)};
+    }
+    for (int i = 0; i < out.ask_count; ++i) {
+        out.asks[i] = {top_ask_prices_[i].load(std::memory_order_relaxed),
+                       top_ask_sizes_[i].load(std::memory_order_relaxed)};
+    }
+    out.last_update = Timestamp(Timestamp::duration(
+        top_update_ns_.load(std::memory_order_relaxed)));
+    out.sequence = top_sequence_.load(std::memory_order_relaxed);
+}
+
+bool OrderBook::read_validate(uint64_t version) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return top_version_.load(std::memory_order_relaxed) == version;
+}
+
+TopOfBook OrderBook::top_of_book() const {
+    BookLevels levels;
+    TopOfBook top;
+    uint64_t v;
+
+    do {
+        v = read_begin();
+        load_levels(levels, 1);
+        top.bid_depth = top_bid_depth_.load(std::memory_order_relaxed);
+        top.ask_depth = top_ask_depth_.load(std::memory_order_relaxed);
+    } while (!read_validate(v));
+
+    top.best_bid = levels.best_bid();
+    top.best_ask = levels.best_ask();
+    top.last_update = levels.last_update;
+    top.sequence = levels.sequence;
+    return top;
+}
+
+std::optional<PriceLevel> OrderBook::best_bid() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peek_bid();
+}
+
+std::optional<PriceLevel> OrderBook::best_ask() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peek_ask();
 }
 
 Price OrderBook::mid_price() const {
@@ -97,54 +368,72 @@ Price OrderBook::spread_bps() const {
 
 std::vector<PriceLevel> OrderBook::top_bids(int n) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    std::vector<PriceLevel> result;
-    int count = 0;
-    for (const auto& [price, size] : bids_) {
-        if (count >= n) break;
-        result.push_back({price, size});
-        count++;
-    }
-    return result;
+    int k = std::clamp(n, 0, static_cast<int>(bid_agg_.levels.size()));
+    return std::vector<PriceLevel>(bid_agg_.levels.begin(), bid_agg_.levels.begin() + k);
 }
 
 std::vector<PriceLevel> OrderBook::top_asks(int n) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    std::vector<PriceLevel> result;
-    int count = 0;
-    for (const auto& [price, size] : asks_) {
-        if (count >= n) break;
-        result.push_back({price, size});
-        count++;
-    }
-    return result;
+    int k = std::clamp(n, 0, static_cast<int>(ask_agg_.levels.size()));
+    return std::vector<PriceLevel>(ask_agg_.levels.begin(), ask_agg_.levels.begin() + k);
 }
 
 Size OrderBook::bid_depth(int levels) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    Size total = 0.0;
-    int count = 0;
-    for (const auto& [price, size] : bids_) {
-        if (count >= levels) break;
-        total += size;
-        count++;
-    }
-    return total;
+    return bid_agg_.depth(levels);
 }
 
 Size OrderBook::ask_depth(int levels) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    Size total = 0.0;
-    int count = 0;
-    for (const auto& [price, size] : asks_) {
-        if (count >= levels) break;
-        total += size;
-        count++;
-    }
-    return total;
+    return ask_agg_.depth(levels);
 }
 
 Size OrderBook::total_depth(int levels) const {
-    return bid_depth(levels) + ask_depth(levels);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bid_agg_.depth(levels) + ask_agg_.depth(levels);
+}
+
+Notional OrderBook::bid_notional(int levels) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bid_agg_.notional(levels);
+}
+
+Notional OrderBook::ask_notional(int levels) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ask_agg_.notional(levels);
+}
+
+SweepQuote OrderBook::sweep(Side side, Size size) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const SideAggregates& agg = side == Side::BUY ? ask_agg_ : bid_agg_;
+
+    SweepQuote quote;
+    if (size <= 0.0 || agg.levels.empty()) return quote;
+
+    // First level whose running size covers the request
+    auto it = std::lower_bound(agg.cum_size.begin(), agg.cum_size.end(), size);
+    if (it == agg.cum_size.end()) {
+        // Side exhausted: everything we hold
+        quote.filled = agg.cum_size.back();
+        quote.cost = agg.cum_notional.back();
+        quote.worst_price = agg.levels.back().price;
+        quote.levels = static_cast<int>(agg.levels.size());
+        return quote;
+    }
+
+    size_t k = static_cast<size_t>(it - agg.cum_size.begin());
+    Size size_before = k > 0 ? agg.cum_size[k - 1] : 0.0;
+    Notional cost_before = k > 0 ? agg.cum_notional[k - 1] : 0.0;
+
+    quote.filled = size;
+    quote.cost = cost_before + (size - size_before) * agg.levels[k].price;
+    quote.worst_price = agg.levels[k].price;
+    quote.levels = static_cast<int>(k) + 1;
+    return quote;
+}
+
+Price OrderBook::vwap_to_size(Side side, Size size) const {
+    return sweep(side, size).vwap();
 }
 
 Timestamp OrderBook::last_update_time() const {
@@ -157,41 +446,107 @@ bool OrderBook::is_stale(Duration threshold) const {
     return (now() - last_update_) > threshold;
 }
 
-void OrderBook::trim_levels() {
-    // Already holding lock
-    while (static_cast<int>(bids_.size()) > max_levels_) {
-        auto it = bids_.end();
-        --it;
-        bids_.erase(it);
-    }
-    while (static_cast<int>(asks_.size()) > max_levels_) {
-        auto it = asks_.end();
-        --it;
-        asks_.erase(it);
+PairedSweep sweep_paired_asks(std::span<const PriceLevel> yes_asks,
+                              std::span<const PriceLevel> no_asks,
+                              int64_t fee_rate_ppm, double min_edge_cents,
+                              const FixedScale& scale) {
+    PairedSweep result;
+    if (yes_asks.empty() || no_asks.empty()) return result;
+
+    // Edges compare as integers; only the reported amounts go back to doubles
+    const int64_t min_edge = fixed_edge_from_cents(min_edge_cents, scale);
+    const double per_dollar = fixed_edge_per_cent(scale) * 100.0;
+
+    size_t i = 0;
+    size_t j = 0;
+    Size yes_left = yes_asks[0].size;
+    Size no_left = no_asks[0].size;
+    Ticks y = scale.to_ticks(yes_asks[0].price);
+    Ticks n = scale.to_ticks(no_asks[0].price);
+
+    while (true) {
+        const int64_t edge = fixed_pair_edge(y, n, scale, fee_rate_ppm);
+        if (edge < min_edge) break;
+        const double fee =
+            static_cast<double>(fixed_fee(y, scale, fee_rate_ppm) + fixed_fee(n, scale, fee_rate_ppm)) / per_dollar;
+
+        const Size take = std::min(yes_left, no_left);
+        result.size += take;
+        result.yes_cost += take * yes_asks[i].price;
+        result.no_cost += take * no_asks[j].price;
+        result.fees += take * fee;
+        result.yes_worst_price = yes_asks[i].price;
+        result.no_worst_price = no_asks[j].price;
+        result.yes_levels = static_cast<int>(i) + 1;
+        result.no_levels = static_cast<int>(j) + 1;
+        result.marginal_edge_cents = static_cast<double>(edge) / fixed_edge_per_cent(scale);
+
+        yes_left -= take;
+        no_left -= take;
+        if (yes_left <= 0.0) {
+            if (++i == yes_asks.size()) break;
+            yes_left = yes_asks[i].size;
+            y = scale.to_ticks(yes_asks[i].price);
+        }
+        if (no_left <= 0.0) {
+            if (++j == no_asks.size()) break;
+            no_left = no_asks[j].size;
+            n = scale.to_ticks(no_asks[j].price);
+        }
     }
+
+    return result;
 }
 
 // BinaryMarketBook implementation
 
-BinaryMarketBook::BinaryMarketBook(const std::string& market_id)
+BinaryMarketBook::BinaryMarketBook(const std::string& market_id,
+                                   OrderBookImpl impl, Price tick_size)
     : market_id_(market_id)
-    , yes_book_(market_id + "_YES")
-    , no_book_(market_id + "_NO")
+    , market_handle_(SymbolRegistry::instance().intern_market(market_id))
+    , yes_book_(market_id + "_YES", BookLevels::MAX_LEVELS, impl, tick_size)
+    , no_book_(market_id + "_NO", BookLevels::MAX_LEVELS, impl, tick_size)
 {
 }
 
-double BinaryMarketBook::sum_of_best_asks() const {
-    auto yes_ask = yes_book_.best_ask();
-    auto no_ask = no_book_.best_ask();
+void BinaryMarketBook::set_tokens(TokenHandle yes_token, TokenHandle no_token) {
+    yes_token_.store(yes_token, std::memory_order_relaxed);
+    no_token_.store(no_token, std::memory_order_relaxed);
+}
+
+const std::string& BinaryMarketBook::yes_token_id() const {
+    TokenHandle token = yes_token();
+    if (token == NO_SYMBOL) return yes_book_.symbol();
+    return SymbolRegistry::instance().token_name(token);
+}
+
+const std::string& BinaryMarketBook::no_token_id() const {
+    TokenHandle token = no_token();
+    if (token == NO_SYMBOL) return no_book_.symbol();
+    return SymbolRegistry::instance().token_name(token);
+}
 
-    if (!yes_ask || !no_ask) return 0.0;
+BinaryBookSnapshot BinaryMarketBook::snapshot(int levels) const {
+    BinaryBookSnapshot snap;
+    // Both versions must hold across both copies, so the legs come from
+    // one instant rather than two independent reads
+    for (;;) {
+        uint64_t yes_v = yes_book_.read_begin();
+        uint64_t no_v = no_book_.read_begin();
+        yes_book_.load_levels(snap.yes, levels);
+        no_book_.load_levels(snap.no, levels);
+        if (yes_book_.read_validate(yes_v) && no_book_.read_validate(no_v)) break;
+    }
+    return snap;
+}
 
-    return yes_ask->price + no_ask->price;
+double BinaryMarketBook::sum_of_best_asks() const {
+    return snapshot(1).sum_of_best_asks();
 }
 
 double BinaryMarketBook::sum_of_best_bids() const {
-    auto yes_bid = yes_book_.best_bid();
-    auto no_bid = no_book_.best_bid();
+    auto yes_bid = yes_book_.top_of_book().best_bid;
+    auto no_bid = no_book_.top_of_book().best_bid;
 
     if (!yes_bid || !no_bid) return 0.0;
 
@@ -204,10 +559,7 @@ double BinaryMarketBook::yes_implied_probability() const {
 }
 
 bool BinaryMarketBook::has_liquidity() const {
-    return yes_book_.best_bid().has_value() &&
-           yes_book_.best_ask().has_value() &&
-           no_book_.best_bid().has_value() &&
-           no_book_.best_ask().has_value();
+    return snapshot(1).has_liquidity();
 }
 
 bool BinaryMarketBook::is_stale(Duration threshold) const {
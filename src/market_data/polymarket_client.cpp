@@ -1,177 +1,137 @@
 #include "market_data/polymarket_client.hpp"
+#include "common/fixed_point.hpp"
+#include "common/symbol_registry.hpp"
 #include "utils/crypto.hpp"
 #include "utils/time_utils.hpp"
 #include <spdlog/spdlog.h>
-#include <curl/curl.h>
-#include <openssl/ssl.h>
-#include <openssl/err.h>
-#include <sys/socket.h>
-#include <netdb.h>
-#include <unistd.h>
+#include <cmath>
 #include <cstring>
-#include <random>
 #include <regex>
 
 namespace arb {
 
 namespace {
-    // CURL write callback
-    size_t write_callback(void* contents, size_t size, size_t nmemb, std::string* output) {
-        size_t total_size = size * nmemb;
-        output->append(static_cast<char*>(contents), total_size);
-        return total_size;
-    }
-
-    // WebSocket frame creation (same as Binance client)
-    std::string create_ws_handshake(const std::string& host, const std::string& path) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(0, 255);
-
-        std::string key;
-        for (int i = 0; i < 16; i++) {
-            key += static_cast<char>(dis(gen));
-        }
-
-        static const char* b64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-        std::string encoded_key;
-        for (size_t i = 0; i < key.size(); i += 3) {
-            uint32_t n = static_cast<uint8_t>(key[i]) << 16;
-            if (i + 1 < key.size()) n |= static_cast<uint8_t>(key[i + 1]) << 8;
-            if (i + 2 < key.size()) n |= static_cast<uint8_t>(key[i + 2]);
-            encoded_key += b64[(n >> 18) & 0x3F];
-            encoded_key += b64[(n >> 12) & 0x3F];
-            encoded_key += (i + 1 < key.size()) ? b64[(n >> 6) & 0x3F] : '=';
-            encoded_key += (i + 2 < key.size()) ? b64[n & 0x3F] : '=';
-        }
-
-        std::string request = "GET " + path + " HTTP/1.1\r\n";
-        request += "Host: " + host + "\r\n";
-        request += "Upgrade: websocket\r\n";
-        request += "Connection: Upgrade\r\n";
-        request += "Sec-WebSocket-Key: " + encoded_key + "\r\n";
-        request += "Sec-WebSocket-Version: 13\r\n";
-        request += "\r\n";
-        return request;
-    }
-
-    std::string create_ws_frame(const std::string& data, uint8_t opcode = 0x01) {
-        std::string frame;
-        frame += static_cast<char>(0x80 | opcode);
-
-        size_t len = data.size();
-        if (len < 126) {
-            frame += static_cast<char>(0x80 | len);
-        } else if (len < 65536) {
-            frame += static_cast<char>(0x80 | 126);
-            frame += static_cast<char>((len >> 8) & 0xFF);
-            frame += static_cast<char>(len & 0xFF);
-        } else {
-            frame += static_cast<char>(0x80 | 127);
-            for (int i = 7; i >= 0; i--) {
-                frame += static_cast<char>((len >> (8 * i)) & 0xFF);
+    HttpClientOptions http_options(const ConnectionConfig& config) {
+        HttpClientOptions options;
+        options.timeout_ms = config.http_timeout_ms;
+        options.connect_timeout_ms = config.connection_timeout_ms;
+        options.http2 = config.http2;
+        return options;
+    }
+
+    // Market channel subscribe/unsubscribe request for a batch of tokens
+    std::string subscription_message(const char* type, const std::vector<std::string>& token_ids) {
+        nlohmann::json msg = {
+            {"type", type},
+            {"channel", "market"},
+            {"assets_ids", token_ids}
+        };
+        return msg.dump();
+    }
+
+    // One Gamma /markets item; false unless it has a condition ID and both tokens
+    bool market_from_gamma(const nlohmann::json& item, Market& market) {
+        market.condition_id = item.value("conditionId", "");
+        market.question = item.value("question", "");
+        market.slug = item.value("slug", "");
+        market.active = item.value("active", true);
+
+        // Date-only values would parse as midnight; only take full timestamps.
+        // Rolling windows (e.g. 15-minute BTC) are listed before they open.
+        auto timestamp = [&](const char* key, WallClock& out) {
+            std::string value = item.value(key, "");
+            if (value.size() >= 19 && value[10] == 'T') {
+                out = time_utils::from_iso8601(value);
+            }
+        };
+        timestamp("eventStartTime", market.start_date);
+        timestamp("endDate", market.end_date);
+
+        if (item.contains("tokens") && item["tokens"].is_array()) {
+            for (const auto& token : item["tokens"]) {
+                std::string outcome = token.value("outcome", "");
+                std::string token_id = token.value("token_id", "");
+
+                if (outcome == "Yes") {
+                    market.yes_outcome.token_id = token_id;
+                    market.yes_outcome.name = "YES";
+                } else if (outcome == "No") {
+                    market.no_outcome.token_id = token_id;
+                    market.no_outcome.name = "NO";
+                }
             }
         }
 
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(0, 255);
-        uint8_t mask[4];
-        for (int i = 0; i < 4; i++) {
-            mask[i] = static_cast<uint8_t>(dis(gen));
-            frame += static_cast<char>(mask[i]);
-        }
+        return !market.condition_id.empty() &&
+               !market.yes_outcome.token_id.empty() &&
+               !market.no_outcome.token_id.empty();
+    }
 
-        for (size_t i = 0; i < data.size(); i++) {
-            frame += static_cast<char>(data[i] ^ mask[i % 4]);
-        }
+    // Compare our top of book with the exchange's post-change best_bid/best_ask,
+    // when the entry carries them. A mismatch means we missed a delta.
+    bool top_matches(const OrderBook& book, const PolymarketChange& change) {
+        if (!change.has_top) return true;
 
-        return frame;
+        auto matches = [](const std::optional<PriceLevel>& ours, double expected) {
+            double actual = ours ? ours->price : 0.0;
+            return std::abs(expected - actual) < 1e-9;
+        };
+
+        TopOfBook top = book.top_of_book();
+        return matches(top.best_bid, change.best_bid) && matches(top.best_ask, change.best_ask);
     }
 }
 
 PolymarketClient::PolymarketClient(const ConnectionConfig& config)
-    : config_(config)
+    : WebSocketClientBase(config.polymarket_ws_url, "Polymarket", config.feed_connections,
+                          config.polymarket_shards)
+    , config_(config)
+    , http_(http_options(config))
+    , subscriptions_(shard_count(),
+                     SubscriptionShards::key_from_string(config.polymarket_shard_key)
+                         .value_or(SubscriptionShards::Key::MARKET),
+                     static_cast<size_t>(config.subscribe_batch_size), SHARD_REBALANCE_SLACK)
+    , shard_state_(shard_count())
 {
-    curl_global_init(CURL_GLOBAL_ALL);
+    set_reconnect_delay(config_.reconnect_delay_ms);
+    set_max_reconnect_attempts(config_.max_reconnect_attempts);
+    set_feed_thread_cpu(config_.feed_thread_cpu);
+    set_spread_addresses(config_.feed_spread_addresses);
+    set_rx_timestamps(config_.kernel_rx_timestamps);
+
+    if (config_.fixed_point_prices) {
+        price_scale_ = &POLYMARKET_PRICE_SCALE;
+        size_scale_ = &POLYMARKET_SIZE_SCALE;
+    }
     spdlog::info("PolymarketClient initialized");
 }
 
 PolymarketClient::~PolymarketClient() {
     disconnect();
-    curl_global_cleanup();
 }
 
 std::string PolymarketClient::http_get(const std::string& url) {
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        throw std::runtime_error("Failed to initialize CURL");
-    }
-
-    std::string response;
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-
-    // Add headers
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Accept: application/json");
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-    CURLcode res = curl_easy_perform(curl);
-
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-
-    if (res != CURLE_OK) {
-        throw std::runtime_error(std::string("CURL request failed: ") + curl_easy_strerror(res));
-    }
-
-    return response;
+    return http_.get(url, {"Accept: application/json"}).body;
 }
 
 std::string PolymarketClient::http_post(const std::string& url, const std::string& body) {
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        throw std::runtime_error("Failed to initialize CURL");
-    }
-
-    std::string response;
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-    headers = curl_slist_append(headers, "Accept: application/json");
+    std::vector<std::string> headers = {
+        "Content-Type: application/json",
+        "Accept: application/json"
+    };
 
     // Add L2 authentication headers if we have credentials
     if (!api_key_.empty()) {
         std::string timestamp = std::to_string(time_utils::epoch_ms());
         std::string signature = generate_l2_signature(timestamp, "POST", url, body);
 
-        headers = curl_slist_append(headers, ("POLY_API_KEY: " + api_key_).c_str());
-        headers = curl_slist_append(headers, ("POLY_TIMESTAMP: " + timestamp).c_str());
-        headers = curl_slist_append(headers, ("POLY_SIGNATURE: " + signature).c_str());
-        headers = curl_slist_append(headers, ("POLY_PASSPHRASE: " + api_passphrase_).c_str());
+        headers.push_back("POLY_API_KEY: " + api_key_);
+        headers.push_back("POLY_TIMESTAMP: " + timestamp);
+        headers.push_back("POLY_SIGNATURE: " + signature);
+        headers.push_back("POLY_PASSPHRASE: " + api_passphrase_);
     }
 
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-    CURLcode res = curl_easy_perform(curl);
-
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-
-    if (res != CURLE_OK) {
-        throw std::runtime_error(std::string("CURL POST failed: ") + curl_easy_strerror(res));
-    }
-
-    return response;
+    return http_.post(url, body, headers).body;
 }
 
 std::string PolymarketClient::generate_l2_signature(const std::string& timestamp,
@@ -196,55 +156,48 @@ std::string PolymarketClient::generate_l2_signature(const std::string& timestamp
 
 std::vector<Market> PolymarketClient::fetch_markets() {
     std::vector<Market> markets;
+    size_t offset = 0;
+    size_t page_items = 0;
+    const size_t limit = static_cast<size_t>(config_.discovery_page_size);
 
+    do {
+        if (!fetch_markets_page(offset, limit, markets, page_items)) break;
+        offset += page_items;
+    } while (page_items == limit);
+
+    spdlog::info("Fetched {} markets from Polymarket", markets.size());
+    return markets;
+}
+
+bool PolymarketClient::fetch_markets_page(size_t offset, size_t limit, std::vector<Market>& out,
+                                          size_t& page_items) {
+    page_items = 0;
     try {
         // Use Gamma API to get markets
-        std::string url = config_.polymarket_gamma_url + "/markets?closed=false&active=true";
+        std::string url = config_.polymarket_gamma_url + "/markets?closed=false&active=true" +
+                          "&limit=" + std::to_string(limit) + "&offset=" + std::to_string(offset);
         std::string response = http_get(url);
 
         auto j = nlohmann::json::parse(response);
 
         if (!j.is_array()) {
             spdlog::error("Unexpected markets response format");
-            return markets;
+            return false;
         }
 
+        page_items = j.size();
         for (const auto& item : j) {
             Market market;
-            market.condition_id = item.value("conditionId", "");
-            market.question = item.value("question", "");
-            market.slug = item.value("slug", "");
-            market.active = item.value("active", true);
-
-            if (item.contains("tokens") && item["tokens"].is_array()) {
-                for (const auto& token : item["tokens"]) {
-                    std::string outcome = token.value("outcome", "");
-                    std::string token_id = token.value("token_id", "");
-
-                    if (outcome == "Yes") {
-                        market.yes_outcome.token_id = token_id;
-                        market.yes_outcome.name = "YES";
-                    } else if (outcome == "No") {
-                        market.no_outcome.token_id = token_id;
-                        market.no_outcome.name = "NO";
-                    }
-                }
-            }
-
-            if (!market.condition_id.empty() &&
-                !market.yes_outcome.token_id.empty() &&
-                !market.no_outcome.token_id.empty()) {
-                markets.push_back(market);
+            if (market_from_gamma(item, market)) {
+                out.push_back(std::move(market));
             }
         }
-
-        spdlog::info("Fetched {} markets from Polymarket", markets.size());
+        return true;
 
     } catch (const std::exception& e) {
         spdlog::error("Failed to fetch markets: {}", e.what());
+        return false;
     }
-
-    return markets;
 }
 
 std::vector<Market> PolymarketClient::fetch_filtered_markets(const std::string& pattern) {
@@ -282,42 +235,110 @@ std::vector<Market> PolymarketClient::fetch_filtered_markets(const std::string&
     return filtered_markets;
 }
 
-void PolymarketClient::fetch_order_book(const std::string& token_id, OrderBook& book) {
-    try {
-        std::string url = config_.polymarket_rest_url + "/book?token_id=" + token_id;
-        std::string response = http_get(url);
-
-        auto j = nlohmann::json::parse(response);
-
-        std::vector<PriceLevel> bids, asks;
-
-        if (j.contains("bids") && j["bids"].is_array()) {
-            for (const auto& bid : j["bids"]) {
-                PriceLevel level;
-                level.price = std::stod(bid.value("price", "0"));
-                level.size = std::stod(bid.value("size", "0"));
-                if (level.price > 0 && level.size > 0) {
-                    bids.push_back(level);
-                }
+PolymarketClient::BookBootstrapResult PolymarketClient::bootstrap_books(
+        const std::vector<TokenHandle>& tokens) {
+    BookBootstrapResult result;
+    Timestamp start = now();
+
+    // Registered tokens only; unrouted ones have no book to fill
+    std::vector<TokenHandle> targets;
+    {
+        std::shared_lock<std::shared_mutex> lock(books_mutex_);
+        auto registered = [this](TokenHandle t) {
+            return t < token_to_market_.size() && token_to_market_[t].market != NO_SYMBOL;
+        };
+        if (tokens.empty()) {
+            for (TokenHandle t = 0; t < token_to_market_.size(); ++t) {
+                if (registered(t)) targets.push_back(t);
+            }
+        } else {
+            for (TokenHandle t : tokens) {
+                if (registered(t)) targets.push_back(t);
             }
         }
+    }
+    result.requested = targets.size();
+    if (targets.empty()) return result;
+
+    auto& registry = SymbolRegistry::instance();
+    std::vector<std::string> urls;
+    urls.reserve(targets.size());
+    for (TokenHandle t : targets) {
+        urls.push_back(config_.polymarket_rest_url + "/book?token_id=" + registry.token_name(t));
+    }
+
+    HttpBatchOptions batch;
+    batch.max_concurrency = config_.bootstrap_concurrency;
+    batch.max_rate = config_.bootstrap_rate_limit;
+
+    // Legs loaded per market: bit 0 YES, bit 1 NO
+    std::map<MarketHandle, uint8_t> legs;
+    PolymarketMessage msg;
+
+    http_.get_many(urls, {"Accept: application/json"}, batch,
+                   [&](size_t i, HttpResponse& response, const std::string& error) {
+        TokenHandle token = targets[i];
+        if (!error.empty() || response.status != 200 ||
+            !parse_polymarket_book(response.body, price_scale_, size_scale_, msg)) {
+            result.failed++;
+            spdlog::warn("Book bootstrap failed for {}: {}", registry.token_name(token),
+                         !error.empty() ? error
+                         : response.status != 200 ? "HTTP " + std::to_string(response.status)
+                         : std::string("unparseable response"));
+            return;
+        }
 
-        if (j.contains("asks") && j["asks"].is_array()) {
-            for (const auto& ask : j["asks"]) {
-                PriceLevel level;
-                level.price = std::stod(ask.value("price", "0"));
-                level.size = std::stod(ask.value("size", "0"));
-                if (level.price > 0 && level.size > 0) {
-                    asks.push_back(level);
-                }
-            }
+        MarketHandle market = NO_SYMBOL;
+        bool is_yes = true;
+        if (!apply_rest_snapshot(token, msg, market, is_yes)) {
+            result.failed++;
+            return;
         }
+        result.loaded++;
+
+        uint8_t& loaded = legs[market];
+        bool was_ready = loaded == 3;
+        loaded |= is_yes ? 1 : 2;
+        if (!was_ready && loaded == 3) {
+            result.markets_ready++;
+            if (!result.first_tradeable) result.first_tradeable = now();
+        }
+    });
 
-        book.apply_snapshot(bids, asks);
+    result.elapsed = now() - start;
+    return result;
+}
 
-    } catch (const std::exception& e) {
-        spdlog::error("Failed to fetch order book for {}: {}", token_id, e.what());
+bool PolymarketClient::apply_rest_snapshot(TokenHandle token, const PolymarketMessage& msg,
+                                           MarketHandle& market, bool& is_yes) {
+    OrderBook* book = find_token_book(token, market, is_yes);
+    if (!book) return false;
+
+    // The feed may have delivered a newer snapshot while this one was in flight
+    if (!book->apply_snapshot(msg.levels, static_cast<uint64_t>(msg.timestamp_ms))) {
+        return true;
     }
+    if (on_book_update_) {
+        on_book_update_(market, token);
+    }
+    return true;
+}
+
+void PolymarketClient::register_market(const Market& market) {
+    auto& registry = SymbolRegistry::instance();
+    MarketHandle market_handle = registry.intern_market(market.condition_id);
+    TokenHandle yes_token = registry.intern_token(market.yes_outcome.token_id);
+    TokenHandle no_token = registry.intern_token(market.no_outcome.token_id);
+
+    std::unique_lock<std::shared_mutex> lock(books_mutex_);
+    book_for(market_handle)->set_tokens(yes_token, no_token);
+
+    TokenHandle max_token = std::max(yes_token, no_token);
+    if (max_token >= token_to_market_.size()) {
+        token_to_market_.resize(max_token + 1);
+    }
+    token_to_market_[yes_token] = {market_handle, true};
+    token_to_market_[no_token] = {market_handle, false};
 }
 
 void PolymarketClient::connect() {
@@ -327,375 +348,290 @@ void PolymarketClient::connect() {
     }
 
     running_ = true;
-    status_ = ConnectionStatus::CONNECTING;
-    if (on_status_) on_status_(status_.load());
-
-    recv_thread_ = std::thread(&PolymarketClient::run_connection_loop, this);
+    resync_thread_ = std::thread(&PolymarketClient::run_resync_loop, this);
+    WebSocketClientBase::connect();
 }
 
 void PolymarketClient::disconnect() {
     running_ = false;
-    if (recv_thread_.joinable()) {
-        recv_thread_.join();
-    }
-    disconnect_socket();
-    status_ = ConnectionStatus::DISCONNECTED;
-    if (on_status_) on_status_(status_.load());
-}
-
-bool PolymarketClient::connect_socket() {
-    std::string host = "ws-subscriptions-clob.polymarket.com";
-    int port = 443;
-    std::string path = "/ws/market";
-
-    int sock = socket(AF_INET, SOCK_STREAM, 0);
-    if (sock < 0) {
-        spdlog::error("Failed to create socket: {}", strerror(errno));
-        return false;
+    {
+        std::lock_guard<std::mutex> lock(resync_mutex_);
+        resync_cv_.notify_all();
     }
-
-    struct hostent* server = gethostbyname(host.c_str());
-    if (!server) {
-        spdlog::error("Failed to resolve host: {}", host);
-        close(sock);
-        return false;
-    }
-
-    struct sockaddr_in server_addr{};
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(port);
-    memcpy(&server_addr.sin_addr.s_addr, server->h_addr, server->h_length);
-
-    if (::connect(sock, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
-        spdlog::error("Failed to connect: {}", strerror(errno));
-        close(sock);
-        return false;
+    if (resync_thread_.joinable()) {
+        resync_thread_.join();
     }
-
-    SSL_library_init();
-    SSL_load_error_strings();
-
-    ssl_ctx_ = SSL_CTX_new(TLS_client_method());
-    if (!ssl_ctx_) {
-        spdlog::error("Failed to create SSL context");
-        close(sock);
-        return false;
-    }
-
-    ssl_ = SSL_new(static_cast<SSL_CTX*>(ssl_ctx_));
-    SSL_set_fd(static_cast<SSL*>(ssl_), sock);
-    SSL_set_tlsext_host_name(static_cast<SSL*>(ssl_), host.c_str());
-
-    if (SSL_connect(static_cast<SSL*>(ssl_)) <= 0) {
-        spdlog::error("SSL handshake failed");
-        SSL_free(static_cast<SSL*>(ssl_));
-        SSL_CTX_free(static_cast<SSL_CTX*>(ssl_ctx_));
-        close(sock);
-        ssl_ = nullptr;
-        ssl_ctx_ = nullptr;
-        return false;
-    }
-
-    socket_ = reinterpret_cast<void*>(static_cast<intptr_t>(sock));
-
-    std::string handshake = create_ws_handshake(host, path);
-    if (SSL_write(static_cast<SSL*>(ssl_), handshake.c_str(), handshake.size()) <= 0) {
-        spdlog::error("Failed to send WebSocket handshake");
-        disconnect_socket();
-        return false;
-    }
-
-    char buffer[4096];
-    int bytes = SSL_read(static_cast<SSL*>(ssl_), buffer, sizeof(buffer) - 1);
-    if (bytes <= 0) {
-        spdlog::error("Failed to receive WebSocket handshake response");
-        disconnect_socket();
-        return false;
-    }
-    buffer[bytes] = '\0';
-
-    if (strstr(buffer, "101") == nullptr) {
-        spdlog::error("WebSocket handshake failed: {}", buffer);
-        disconnect_socket();
-        return false;
-    }
-
-    spdlog::info("Polymarket WebSocket connected");
-    return true;
+    WebSocketClientBase::disconnect();
 }
 
-void PolymarketClient::disconnect_socket() {
-    if (ssl_) {
-        SSL_shutdown(static_cast<SSL*>(ssl_));
-        SSL_free(static_cast<SSL*>(ssl_));
-        ssl_ = nullptr;
-    }
-    if (ssl_ctx_) {
-        SSL_CTX_free(static_cast<SSL_CTX*>(ssl_ctx_));
-        ssl_ctx_ = nullptr;
-    }
-    if (socket_) {
-        close(static_cast<int>(reinterpret_cast<intptr_t>(socket_)));
-        socket_ = nullptr;
-    }
+void PolymarketClient::subscribe_market(const std::string& token_id) {
+    subscribe_markets({token_id});
 }
 
-std::string PolymarketClient::recv_frame() {
-    if (!ssl_) return "";
-
-    SSL* ssl = static_cast<SSL*>(ssl_);
-
-    uint8_t header[2];
-    int bytes = SSL_read(ssl, header, 2);
-    if (bytes < 2) return "";
-
-    uint8_t opcode = header[0] & 0x0F;
-    bool masked = (header[1] & 0x80) != 0;
-    uint64_t payload_len = header[1] & 0x7F;
+void PolymarketClient::unsubscribe_market(const std::string& token_id) {
+    unsubscribe_markets({token_id});
+}
 
-    if (payload_len == 126) {
-        uint8_t ext[2];
-        if (SSL_read(ssl, ext, 2) < 2) return "";
-        payload_len = (ext[0] << 8) | ext[1];
-    } else if (payload_len == 127) {
-        uint8_t ext[8];
-        if (SSL_read(ssl, ext, 8) < 8) return "";
-        payload_len = 0;
-        for (int i = 0; i < 8; i++) {
-            payload_len = (payload_len << 8) | ext[i];
+void PolymarketClient::subscribe_markets(const std::vector<std::string>& token_ids) {
+    if (token_ids.empty()) return;
+
+    // Shard by market: resolve each token's condition ID from its route
+    std::vector<std::string> markets;
+    markets.reserve(token_ids.size());
+    {
+        auto& registry = SymbolRegistry::instance();
+        std::shared_lock<std::shared_mutex> lock(books_mutex_);
+        for (const auto& token_id : token_ids) {
+            TokenHandle token = registry.find_token(token_id);
+            bool routed = token != NO_SYMBOL && token < token_to_market_.size() &&
+                          token_to_market_[token].market != NO_SYMBOL;
+            markets.push_back(routed ? registry.market_name(token_to_market_[token].market) : std::string());
         }
     }
 
-    uint8_t mask[4] = {0};
-    if (masked) {
-        if (SSL_read(ssl, mask, 4) < 4) return "";
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    for (size_t i = 0; i < token_ids.size(); ++i) {
+        subscriptions_.add(token_ids[i], markets[i]);
     }
+    spdlog::info("Subscribing to {} tokens", token_ids.size());
+    commit_subscriptions();
+}
 
-    if (payload_len > 1024 * 1024) {
-        spdlog::error("Frame too large: {}", payload_len);
-        return "";
-    }
+void PolymarketClient::unsubscribe_markets(const std::vector<std::string>& token_ids) {
+    if (token_ids.empty()) return;
 
-    std::string payload(payload_len, '\0');
-    size_t read_total = 0;
-    while (read_total < payload_len) {
-        int chunk = SSL_read(ssl, &payload[read_total], payload_len - read_total);
-        if (chunk <= 0) break;
-        read_total += chunk;
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    for (const auto& token_id : token_ids) {
+        subscriptions_.remove(token_id);
     }
+    commit_subscriptions();
+}
 
-    if (masked) {
-        for (size_t i = 0; i < payload.size(); i++) {
-            payload[i] ^= mask[i % 4];
-        }
+void PolymarketClient::commit_subscriptions() {
+    int64_t moved_before = subscriptions_.groups_moved();
+    for (const auto& batch : subscriptions_.commit()) {
+        // A shard that isn't open picks its tokens up in on_open()
+        send(batch.shard, subscription_message(batch.subscribe ? "subscribe" : "unsubscribe", batch.token_ids));
     }
+    if (shard_count() == 1) return;
 
-    if (opcode == 0x08) {
-        spdlog::info("Received WebSocket close frame");
-        return "";
-    } else if (opcode == 0x09) {
-        send_pong(payload);
-        return recv_frame();
-    } else if (opcode == 0x0A) {
-        return recv_frame();
+    std::string loads;
+    for (size_t shard = 0; shard < shard_count(); ++shard) {
+        loads += (shard ? "/" : "") + std::to_string(subscriptions_.load(shard));
+    }
+    int64_t moved = subscriptions_.groups_moved() - moved_before;
+    if (moved > 0) {
+        spdlog::info("Rebalanced Polymarket shards: moved {} groups, now {} tokens", moved, loads);
+    } else {
+        spdlog::debug("Polymarket shard loads: {} tokens", loads);
     }
-
-    return payload;
 }
 
-void PolymarketClient::send_pong(const std::string& payload) {
-    if (!ssl_) return;
-    std::string frame = create_ws_frame(payload, 0x0A);
-    SSL_write(static_cast<SSL*>(ssl_), frame.c_str(), frame.size());
+size_t PolymarketClient::shard_tokens(size_t shard) const {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    return subscriptions_.load(shard);
 }
 
-bool PolymarketClient::send_raw(const std::string& data) {
-    if (!ssl_) return false;
-    std::string frame = create_ws_frame(data);
-    return SSL_write(static_cast<SSL*>(ssl_), frame.c_str(), frame.size()) > 0;
+int64_t PolymarketClient::shard_moves() const {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    return subscriptions_.groups_moved();
 }
 
-void PolymarketClient::subscribe_market(const std::string& token_id) {
-    nlohmann::json sub_msg = {
-        {"type", "subscribe"},
-        {"channel", "market"},
-        {"assets_ids", {token_id}}
-    };
-
-    std::string msg = sub_msg.dump();
-    spdlog::info("Subscribing to market: {}", token_id);
-
-    if (!send_raw(msg)) {
-        spdlog::error("Failed to send subscription for {}", token_id);
+void PolymarketClient::on_open(size_t shard) {
+    std::vector<SubscriptionShards::Batch> batches;
+    {
+        std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+        batches = subscriptions_.resubscribe(shard);
+    }
+    // Another redundant connection kept the books current meanwhile
+    ShardState& state = shard_state_[shard];
+    bool reconnect = state.opened_once && !other_connection_open(shard);
+    state.opened_once = true;
+    if (batches.empty()) return;
+
+    size_t tokens = 0;
+    for (const auto& batch : batches) {
+        send(shard, subscription_message("subscribe", batch.token_ids));
+        tokens += batch.token_ids.size();
+    }
+    spdlog::info("Subscribed to {} tokens in {} messages after connect", tokens, batches.size());
+
+    // Deltas were lost while we were down; refetch every book off the loop thread
+    if (reconnect) {
+        auto& registry = SymbolRegistry::instance();
+        for (const auto& batch : batches) {
+            for (const auto& token_id : batch.token_ids) {
+                TokenHandle token = registry.find_token(token_id);
+                if (token != NO_SYMBOL) request_resync(token);
+            }
+        }
     }
 }
 
-void PolymarketClient::unsubscribe_market(const std::string& token_id) {
-    nlohmann::json unsub_msg = {
-        {"type", "unsubscribe"},
-        {"channel", "market"},
-        {"assets_ids", {token_id}}
-    };
-
-    send_raw(unsub_msg.dump());
-}
-
-void PolymarketClient::run_connection_loop() {
-    int reconnect_attempts = 0;
-
-    while (running_.load()) {
-        if (!connect_socket()) {
-            status_ = ConnectionStatus::RECONNECTING;
-            if (on_status_) on_status_(status_.load());
-
-            reconnect_attempts++;
-            if (reconnect_attempts > config_.max_reconnect_attempts) {
-                spdlog::error("Max reconnect attempts reached");
-                status_ = ConnectionStatus::ERROR;
-                if (on_status_) on_status_(status_.load());
-                if (on_error_) on_error_("Max reconnect attempts reached");
-                break;
-            }
-
-            int delay = config_.reconnect_delay_ms * (1 << std::min(reconnect_attempts - 1, 5));
-            spdlog::info("Reconnecting in {}ms (attempt {})", delay, reconnect_attempts);
-            std::this_thread::sleep_for(std::chrono::milliseconds(delay));
-            continue;
+void PolymarketClient::handle_message(size_t shard, std::string_view msg, Timestamp recv_time) {
+    // Parsing and applying run in parallel across shards; each book has its own lock
+    PolymarketMessage& parsed = shard_state_[shard].msg_buf;
+    if (!parse_polymarket_message(msg, price_scale_, size_scale_, parsed)) {
+        json_fallbacks_++;
+        if (!parse_polymarket_message_json(msg, price_scale_, size_scale_, parsed)) {
+            spdlog::debug("Failed to parse message: {}", msg.substr(0, 100));
+            return;
         }
+    }
 
-        status_ = ConnectionStatus::CONNECTED;
-        if (on_status_) on_status_(status_.load());
-        reconnect_attempts = 0;
-
-        while (running_.load() && ssl_) {
-            std::string msg = recv_frame();
-            if (msg.empty()) {
-                if (!running_.load()) break;
-                spdlog::warn("Empty frame received, reconnecting");
-                break;
-            }
-
-            Timestamp recv_time = now();
-            messages_received_++;
-            {
-                std::lock_guard<std::mutex> lock(time_mutex_);
-                last_update_time_ = recv_time;
-            }
-
-            parse_message(msg, recv_time);
-        }
+    Timestamp parsed_at = now();
 
-        disconnect_socket();
-        if (running_.load()) {
-            status_ = ConnectionStatus::RECONNECTING;
-            if (on_status_) on_status_(status_.load());
-        }
+    switch (parsed.kind) {
+        case PolymarketMessage::Kind::BOOK:
+            apply_book(parsed);
+            break;
+        case PolymarketMessage::Kind::PRICE_CHANGE:
+            apply_price_change(parsed);
+            break;
+        case PolymarketMessage::Kind::TRADE:
+            apply_trade(parsed, recv_time);
+            break;
+        case PolymarketMessage::Kind::NONE:
+            return;
     }
+    latency_.record(recv_time, parsed_at, now(), parsed.timestamp_ms);
 }
 
-void PolymarketClient::parse_message(const std::string& msg, Timestamp recv_time) {
-    try {
-        auto j = nlohmann::json::parse(msg);
+OrderBook* PolymarketClient::find_token_book(TokenHandle token, MarketHandle& market, bool& is_yes) const {
+    std::shared_lock<std::shared_mutex> lock(books_mutex_);
+    if (token >= token_to_market_.size()) return nullptr;
 
-        std::string event_type = j.value("event_type", "");
+    const TokenRoute& route = token_to_market_[token];
+    if (route.market == NO_SYMBOL || route.market >= market_books_.size()) return nullptr;
 
-        if (event_type == "book") {
-            parse_book_message(j, recv_time);
-        } else if (event_type == "price_change") {
-            parse_price_change(j, recv_time);
-        } else if (event_type == "last_trade_price") {
-            parse_trade_message(j, recv_time);
-        }
+    BinaryMarketBook* book = market_books_[route.market].get();
+    if (!book) return nullptr;
 
-    } catch (const std::exception& e) {
-        spdlog::debug("Failed to parse message: {} - {}", e.what(), msg.substr(0, 100));
-    }
+    market = route.market;
+    is_yes = route.is_yes;
+    return route.is_yes ? &book->yes_book() : &book->no_book();
 }
 
-void PolymarketClient::parse_book_message(const nlohmann::json& data, Timestamp recv_time) {
-    std::string asset_id = data.value("asset_id", "");
-    if (asset_id.empty()) return;
-
-    std::lock_guard<std::mutex> lock(books_mutex_);
-
-    auto it = token_to_market_.find(asset_id);
-    if (it == token_to_market_.end()) return;
+void PolymarketClient::apply_book(const PolymarketMessage& msg) {
+    if (msg.token == NO_SYMBOL) return;
 
-    std::string market_id = it->second;
-    auto book_it = market_books_.find(market_id);
-    if (book_it == market_books_.end()) return;
+    MarketHandle market = NO_SYMBOL;
+    bool is_yes = true;
+    OrderBook* target_book = find_token_book(msg.token, market, is_yes);
+    if (!target_book) return;
 
-    BinaryMarketBook* book = book_it->second.get();
-
-    // Determine if YES or NO
-    OrderBook* target_book = nullptr;
-    if (book->yes_book().symbol().find(asset_id) != std::string::npos ||
-        asset_id == book->yes_book().symbol()) {
-        target_book = &book->yes_book();
-    } else {
-        target_book = &book->no_book();
+    // A slower connection's snapshot, already overtaken by deltas
+    if (!target_book->apply_snapshot(msg.levels, static_cast<uint64_t>(msg.timestamp_ms))) {
+        return;
     }
+    if (on_book_update_) {
+        on_book_update_(market, msg.token);
+    }
+}
 
-    std::vector<PriceLevel> bids, asks;
-
-    if (data.contains("bids") && data["bids"].is_array()) {
-        for (const auto& bid : data["bids"]) {
-            PriceLevel level;
-            level.price = std::stod(bid.value("price", "0"));
-            level.size = std::stod(bid.value("size", "0"));
-            if (level.price > 0) bids.push_back(level);
+void PolymarketClient::apply_price_change(const PolymarketMessage& msg) {
+    int64_t exchange_ts = msg.timestamp_ms;
+    uint64_t seq = exchange_ts > 0 ? static_cast<uint64_t>(exchange_ts) : 0;
+
+    auto apply = [&](TokenHandle token, std::span<const LevelDelta> deltas,
+                     const PolymarketChange* last) {
+        MarketHandle market = NO_SYMBOL;
+        bool is_yes = true;
+        OrderBook* book = find_token_book(token, market, is_yes);
+        if (!book) return;
+
+        // No snapshot yet: apply anyway, but the book has no baseline to build on
+        if (book->sequence() == 0) request_resync(token);
+
+        // Older than the snapshot the book was last rebuilt from. Checked under
+        // the book lock, since a REST snapshot may land from another thread.
+        DeltaResult result = book->apply_deltas(deltas, seq);
+        if (result.stale) return;
+        deltas_applied_ += static_cast<int64_t>(deltas.size());
+
+        if (last && !top_matches(*book, *last)) {
+            spdlog::debug("Top of book diverged for {}, resyncing",
+                          SymbolRegistry::instance().token_name(token));
+            request_resync(token);
         }
-    }
+        if (!result.top_changed()) return;
+        if (on_book_update_) on_book_update_(market, token);
+    };
 
-    if (data.contains("asks") && data["asks"].is_array()) {
-        for (const auto& ask : data["asks"]) {
-            PriceLevel level;
-            level.price = std::stod(ask.value("price", "0"));
-            level.size = std::stod(ask.value("size", "0"));
-            if (level.price > 0) asks.push_back(level);
+    // Current shape: "price_changes" entries, each with its own asset_id and
+    // the exchange's resulting best_bid/best_ask for that token. Consecutive
+    // entries for one token are applied as a single batch.
+    if (msg.has_price_changes) {
+        const auto& changes = msg.changes;
+        size_t i = 0;
+        while (i < changes.size()) {
+            TokenHandle token = changes[i].token;
+            size_t end = i + 1;
+            while (end < changes.size() && changes[end].token == token) ++end;
+
+            if (token != NO_SYMBOL) apply(token, msg.change_levels(i, end), &changes[end - 1]);
+            i = end;
         }
+        return;
     }
 
-    target_book->apply_snapshot(bids, asks);
-
-    if (on_book_update_) {
-        on_book_update_(market_id, asset_id);
-    }
+    // Legacy shape: one asset_id with a "changes" array
+    if (msg.token == NO_SYMBOL) return;
+    apply(msg.token, msg.levels, nullptr);
 }
 
-void PolymarketClient::parse_price_change(const nlohmann::json& data, Timestamp recv_time) {
-    // price_change updates individual price levels
-    std::string asset_id = data.value("asset_id", "");
-    if (asset_id.empty()) return;
+void PolymarketClient::request_resync(TokenHandle token) {
+    std::lock_guard<std::mutex> lock(resync_mutex_);
 
-    std::lock_guard<std::mutex> lock(books_mutex_);
+    auto last = last_resync_.find(token);
+    if (last != last_resync_.end() && now() - last->second < RESYNC_MIN_INTERVAL) return;
+    if (!resync_pending_.insert(token).second) return;
 
-    auto it = token_to_market_.find(asset_id);
-    if (it == token_to_market_.end()) return;
+    resyncs_requested_++;
+    resync_cv_.notify_one();
+}
 
-    std::string market_id = it->second;
-    auto book_it = market_books_.find(market_id);
-    if (book_it == market_books_.end()) return;
+void PolymarketClient::run_resync_loop() {
+    while (running_.load()) {
+        std::vector<TokenHandle> tokens;
+        {
+            std::unique_lock<std::mutex> lock(resync_mutex_);
+            resync_cv_.wait(lock, [this] { return !running_.load() || !resync_pending_.empty(); });
+            if (!running_.load()) break;
+
+            // Everything pending goes out as one concurrent batch
+            Timestamp t = now();
+            tokens.assign(resync_pending_.begin(), resync_pending_.end());
+            resync_pending_.clear();
+            for (TokenHandle token : tokens) last_resync_[token] = t;
+        }
 
-    // Update individual levels if provided
-    if (on_book_update_) {
-        on_book_update_(market_id, asset_id);
+        if (tokens.size() == 1) {
+            spdlog::info("Resyncing order book for token {}",
+                         SymbolRegistry::instance().token_name(tokens.front()));
+        } else {
+            spdlog::info("Resyncing {} order books", tokens.size());
+        }
+        bootstrap_books(tokens);
     }
 }
 
-void PolymarketClient::parse_trade_message(const nlohmann::json& data, Timestamp recv_time) {
+void PolymarketClient::apply_trade(const PolymarketMessage& msg, Timestamp recv_time) {
     Fill fill;
-    fill.token_id = data.value("asset_id", "");
-    fill.price = std::stod(data.value("price", "0"));
-    fill.size = std::stod(data.value("size", "0"));
-
-    std::string side_str = data.value("side", "");
-    fill.side = (side_str == "buy" || side_str == "BUY") ? Side::BUY : Side::SELL;
-
-    fill.fill_time = recv_time;
-    if (data.contains("timestamp")) {
-        fill.exchange_time_ms = data["timestamp"].get<int64_t>();
+    fill.token_id = msg.asset_id;
+    fill.token_handle = msg.token;
+    {
+        std::shared_lock<std::shared_mutex> lock(books_mutex_);
+        if (fill.token_handle < token_to_market_.size()) {
+            fill.market_handle = token_to_market_[fill.token_handle].market;
+            fill.market_id = SymbolRegistry::instance().market_name(fill.market_handle);
+        }
     }
+    fill.price = msg.price;
+    fill.size = msg.size;
+    fill.side = msg.side;
+    fill.fill_time = recv_time;
+    fill.exchange_time_ms = msg.timestamp_ms;
 
     if (on_trade_) {
         on_trade_(fill);
@@ -703,17 +639,31 @@ void PolymarketClient::parse_trade_message(const nlohmann::json& data, Timestamp
 }
 
 BinaryMarketBook* PolymarketClient::get_market_book(const std::string& market_id) {
-    std::lock_guard<std::mutex> lock(books_mutex_);
-    auto it = market_books_.find(market_id);
-    if (it != market_books_.end()) {
-        return it->second.get();
+    return get_market_book(SymbolRegistry::instance().intern_market(market_id));
+}
+
+BinaryMarketBook* PolymarketClient::get_market_book(MarketHandle market) {
+    if (market == NO_SYMBOL) return nullptr;
+    {
+        std::shared_lock<std::shared_mutex> lock(books_mutex_);
+        if (market < market_books_.size() && market_books_[market]) return market_books_[market].get();
     }
+    std::unique_lock<std::shared_mutex> lock(books_mutex_);
+    return book_for(market);
+}
 
-    // Create new book
-    auto book = std::make_unique<BinaryMarketBook>(market_id);
-    BinaryMarketBook* ptr = book.get();
-    market_books_[market_id] = std::move(book);
-    return ptr;
+BinaryMarketBook* PolymarketClient::book_for(MarketHandle market) {
+    if (market >= market_books_.size()) {
+        market_books_.resize(market + 1);
+    }
+
+    auto& slot = market_books_[market];
+    if (!slot) {
+        slot = std::make_unique<BinaryMarketBook>(
+            SymbolRegistry::instance().market_name(market),
+            order_book_impl_from_string(config_.order_book_impl), config_.price_tick_size);
+    }
+    return slot.get();
 }
 
 void PolymarketClient::set_api_credentials(const std::string& key,
@@ -782,8 +732,7 @@ bool PolymarketClient::cancel_order(const std::string& order_id) {
 }
 
 Timestamp PolymarketClient::last_update_time() const {
-    std::lock_guard<std::mutex> lock(time_mutex_);
-    return last_update_time_;
+    return last_message_time();
 }
 
 } // namespace arb
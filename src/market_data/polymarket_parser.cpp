@@ -0,0 +1,424 @@
+#include "market_data/polymarket_parser.hpp"
+#include "common/symbol_registry.hpp"
+#include "market_data/json_scanner.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <charconv>
+
+namespace arb {
+
+void PolymarketMessage::reset() {
+    kind = Kind::NONE;
+    asset_id.clear();
+    token = NO_SYMBOL;
+    timestamp_ms = 0;
+    levels.clear();
+    changes.clear();
+    has_price_changes = false;
+    price = 0.0;
+    size = 0.0;
+    side = Side::SELL;
+}
+
+std::span<const LevelDelta> PolymarketMessage::change_levels(size_t first, size_t last) const {
+    if (first >= last) return {};
+    size_t begin = changes[first].level;
+    size_t end = changes[last - 1].level + (changes[last - 1].has_level ? 1 : 0);
+    return std::span<const LevelDelta>(levels.data() + begin, end - begin);
+}
+
+namespace {
+    PolymarketMessage::Kind kind_of(std::string_view event_type) {
+        if (event_type == "book") return PolymarketMessage::Kind::BOOK;
+        if (event_type == "price_change") return PolymarketMessage::Kind::PRICE_CHANGE;
+        if (event_type == "last_trade_price") return PolymarketMessage::Kind::TRADE;
+        return PolymarketMessage::Kind::NONE;
+    }
+
+    bool parse_side(std::string_view text, Side& out) {
+        if (text == "BUY" || text == "buy") {
+            out = Side::BUY;
+            return true;
+        }
+        if (text == "SELL" || text == "sell") {
+            out = Side::SELL;
+            return true;
+        }
+        return false;
+    }
+
+    // Decimal string onto scale (or to the nearest double); "" and literals
+    // read as 0, bare numbers are taken as-is
+    bool decimal(const JsonField& field, const FixedScale* scale, double& out) {
+        out = 0.0;
+        if (!field.present || field.raw.empty()) return true;
+        if (!field.is_string) {
+            char c = field.raw[0];
+            if (c != '-' && (c < '0' || c > '9')) return true;
+            return parse_decimal(field.raw, out);
+        }
+        if (scale && parse_fixed_price(field.raw, *scale, out)) return true;
+        return parse_decimal(field.raw, out);
+    }
+
+    // Integer or integer string; absent, "" and literals read as 0
+    bool timestamp(const JsonField& field, int64_t& out) {
+        out = 0;
+        if (!field.present || field.raw.empty()) return true;
+        char c = field.raw[0];
+        if (!field.is_string && c != '-' && (c < '0' || c > '9')) return true;
+        const char* first = field.raw.data();
+        const char* last = first + field.raw.size();
+        auto [ptr, ec] = std::from_chars(first, last, out);
+        return ec == std::errc() && ptr == last;
+    }
+
+    // The keys a level object can carry, in either array shape
+    struct LevelFields {
+        JsonField price, size, side, asset_id, best_bid, best_ask;
+
+        JsonField* find(std::string_view key) {
+            if (key == "price") return &price;
+            if (key == "size") return &size;
+            if (key == "side") return &side;
+            if (key == "asset_id") return &asset_id;
+            if (key == "best_bid") return &best_bid;
+            if (key == "best_ask") return &best_ask;
+            return nullptr;
+        }
+    };
+
+    bool scan_level(JsonScanner& scan, LevelFields& fields) {
+        if (!scan.consume('{')) return false;
+        if (scan.consume('}')) return true;
+        do {
+            std::string_view key;
+            if (!scan.key(key)) return false;
+            JsonField* field = fields.find(key);
+            if (field ? !scan.scalar(*field) : !scan.skip_value()) return false;
+        } while (scan.consume(','));
+        return scan.consume('}');
+    }
+
+    // Which array family a message carries; mixing them is left to the DOM path
+    enum class Shape { NONE, BOOK, CHANGES, PRICE_CHANGES };
+
+    class MessageParser {
+    public:
+        MessageParser(std::string_view msg, const FixedScale* price_scale,
+                      const FixedScale* size_scale, PolymarketMessage::Kind default_kind,
+                      PolymarketMessage& out)
+            : scan_(msg), price_scale_(price_scale), size_scale_(size_scale),
+              default_kind_(default_kind), out_(out) {}
+
+        bool parse() {
+            out_.reset();
+            if (!scan_.consume('{')) return false;
+            JsonField event_type, asset_id, ts, price, size, side;
+
+            if (!scan_.consume('}')) {
+                do {
+                    std::string_view key;
+                    if (!scan_.key(key)) return false;
+
+                    bool ok = true;
+                    if (key == "event_type") ok = scan_.scalar(event_type);
+                    else if (key == "asset_id") ok = scan_.scalar(asset_id);
+                    else if (key == "timestamp") ok = scan_.scalar(ts);
+                    else if (key == "price") ok = scan_.scalar(price);
+                    else if (key == "size") ok = scan_.scalar(size);
+                    else if (key == "side") ok = scan_.scalar(side);
+                    else if (key == "bids") ok = book_side(Side::BUY);
+                    else if (key == "asks") ok = book_side(Side::SELL);
+                    else if (key == "changes") ok = changes();
+                    else if (key == "price_changes") ok = price_changes();
+                    else ok = scan_.skip_value();
+                    if (!ok) return false;
+                } while (scan_.consume(','));
+                if (!scan_.consume('}')) return false;
+            }
+            if (!scan_.at_end()) return false;
+
+            if (event_type.present && !event_type.is_string) return false;
+            if (asset_id.present && !asset_id.is_string) return false;
+            out_.kind = event_type.present ? kind_of(event_type.raw) : default_kind_;
+            out_.asset_id.assign(asset_id.raw);
+            out_.token = asset_id.present ? SymbolRegistry::instance().find_token(asset_id.raw) : NO_SYMBOL;
+            if (!timestamp(ts, out_.timestamp_ms)) return false;
+
+            // Asks before bids on the wire: restore bids-then-asks
+            if (bids_start_ > 0 && asks_seen_) {
+                std::rotate(out_.levels.begin(), out_.levels.begin() + static_cast<std::ptrdiff_t>(bids_start_),
+                            out_.levels.end());
+            }
+
+            // Arrays that don't belong to this event type are ignored
+            using Kind = PolymarketMessage::Kind;
+            bool keep = (out_.kind == Kind::BOOK && shape_ == Shape::BOOK) ||
+                        (out_.kind == Kind::PRICE_CHANGE &&
+                         (shape_ == Shape::CHANGES || shape_ == Shape::PRICE_CHANGES));
+            if (!keep) {
+                out_.levels.clear();
+                out_.changes.clear();
+                out_.has_price_changes = false;
+            }
+
+            if (out_.kind == Kind::TRADE) {
+                if (!decimal(price, price_scale_, out_.price)) return false;
+                if (!decimal(size, size_scale_, out_.size)) return false;
+                Side taker = Side::SELL;
+                out_.side = side.is_string && parse_side(side.raw, taker) ? taker : Side::SELL;
+            }
+            return true;
+        }
+
+    private:
+        JsonScanner scan_;
+        const FixedScale* price_scale_;
+        const FixedScale* size_scale_;
+        PolymarketMessage::Kind default_kind_;  // When the frame has no event_type
+        PolymarketMessage& out_;
+
+        Shape shape_{Shape::NONE};
+        bool bids_seen_{false};
+        bool asks_seen_{false};
+        size_t bids_start_{0};
+
+        bool set_shape(Shape shape) {
+            if (shape_ != Shape::NONE && shape_ != shape) return false;
+            shape_ = shape;
+            return true;
+        }
+
+        // Parse {price, size[, side]} into a delta; false on a malformed value,
+        // usable = false when the level is well-formed but not applicable
+        bool level_delta(const LevelFields& f, Side side, bool side_from_field,
+                         LevelDelta& delta, bool& usable) {
+            if (!decimal(f.price, price_scale_, delta.price)) return false;
+            if (!decimal(f.size, size_scale_, delta.size)) return false;
+            delta.side = side;
+            usable = delta.price > 0;
+            if (side_from_field) {
+                if (f.side.present && !f.side.is_string) return false;
+                usable = usable && parse_side(f.side.raw, delta.side);
+            }
+            return true;
+        }
+
+        template <typename Each>
+        bool array(Each each) {
+            if (!scan_.consume('[')) return false;
+            if (scan_.consume(']')) return true;
+            do {
+                LevelFields fields;
+                if (!scan_level(scan_, fields) || !each(fields)) return false;
+            } while (scan_.consume(','));
+            return scan_.consume(']');
+        }
+
+        bool book_side(Side side) {
+            bool& seen = side == Side::BUY ? bids_seen_ : asks_seen_;
+            if (seen || !set_shape(Shape::BOOK)) return false;
+            seen = true;
+            if (side == Side::BUY) bids_start_ = out_.levels.size();
+
+            return array([&](const LevelFields& f) {
+                LevelDelta delta;
+                bool usable = false;
+                if (!level_delta(f, side, false, delta, usable)) return false;
+                if (usable) out_.levels.push_back(delta);
+                return true;
+            });
+        }
+
+        bool changes() {
+            if (!set_shape(Shape::CHANGES)) return false;
+            return array([&](const LevelFields& f) {
+                LevelDelta delta;
+                bool usable = false;
+                if (!level_delta(f, Side::BUY, true, delta, usable)) return false;
+                if (usable) out_.levels.push_back(delta);
+                return true;
+            });
+        }
+
+        bool price_changes() {
+            if (!set_shape(Shape::PRICE_CHANGES)) return false;
+            out_.has_price_changes = true;
+
+            // Batches repeat one asset_id; resolve it once per run
+            std::string_view last_id;
+            TokenHandle last_token = NO_SYMBOL;
+            bool have_last = false;
+
+            return array([&](const LevelFields& f) {
+                if (f.asset_id.present && !f.asset_id.is_string) return false;
+
+                PolymarketChange change;
+                if (f.asset_id.present) {
+                    if (!have_last || f.asset_id.raw != last_id) {
+                        last_id = f.asset_id.raw;
+                        last_token = SymbolRegistry::instance().find_token(last_id);
+                        have_last = true;
+                    }
+                    change.token = last_token;
+                }
+
+                LevelDelta delta;
+                bool usable = false;
+                if (!level_delta(f, Side::BUY, true, delta, usable)) return false;
+                change.level = static_cast<uint32_t>(out_.levels.size());
+                change.has_level = usable;
+                if (usable) out_.levels.push_back(delta);
+
+                change.has_top = f.best_bid.present && f.best_ask.present;
+                if (change.has_top) {
+                    if (!decimal(f.best_bid, price_scale_, change.best_bid)) return false;
+                    if (!decimal(f.best_ask, price_scale_, change.best_ask)) return false;
+                }
+                out_.changes.push_back(change);
+                return true;
+            });
+        }
+    };
+}
+
+bool parse_polymarket_message(std::string_view msg, const FixedScale* price_scale,
+                              const FixedScale* size_scale, PolymarketMessage& out) {
+    return MessageParser(msg, price_scale, size_scale, PolymarketMessage::Kind::NONE, out).parse();
+}
+
+namespace {
+    // Polymarket sends timestamps as ms-since-epoch strings; 0 if absent
+    int64_t json_timestamp_ms(const nlohmann::json& data) {
+        auto it = data.find("timestamp");
+        if (it == data.end()) return 0;
+        if (it->is_number()) return it->get<int64_t>();
+        if (it->is_string() && !it->get_ref<const std::string&>().empty()) {
+            return std::stoll(it->get_ref<const std::string&>());
+        }
+        return 0;
+    }
+
+    // Decimal string field as a double: exact fixed-point parse onto scale
+    // when one is given, strtod otherwise. Missing or empty fields read as 0.
+    double json_decimal(const nlohmann::json& obj, const char* key, const FixedScale* scale) {
+        auto it = obj.find(key);
+        if (it == obj.end()) return 0.0;
+        if (it->is_number()) return it->get<double>();
+        if (!it->is_string()) return 0.0;
+
+        const std::string& text = it->get_ref<const std::string&>();
+        if (text.empty()) return 0.0;
+        if (scale) {
+            double value = 0.0;
+            if (parse_fixed_price(text, *scale, value)) return value;
+        }
+        return std::stod(text);
+    }
+
+    // One {price, size, side} level change; size 0 removes the level
+    bool json_level_delta(const nlohmann::json& change, const FixedScale* price_scale,
+                          const FixedScale* size_scale, LevelDelta& out) {
+        out.price = json_decimal(change, "price", price_scale);
+        out.size = json_decimal(change, "size", size_scale);
+        if (out.price <= 0) return false;
+        return parse_side(change.value("side", ""), out.side);
+    }
+
+    TokenHandle json_token(const nlohmann::json& data) {
+        auto it = data.find("asset_id");
+        if (it == data.end()) return NO_SYMBOL;
+        return SymbolRegistry::instance().find_token(it->get_ref<const std::string&>());
+    }
+
+    void json_book_side(const nlohmann::json& data, const char* key, Side side,
+                        const FixedScale* price_scale, const FixedScale* size_scale,
+                        std::vector<LevelDelta>& levels) {
+        auto it = data.find(key);
+        if (it == data.end() || !it->is_array()) return;
+        for (const auto& level : *it) {
+            LevelDelta delta{side, json_decimal(level, "price", price_scale),
+                             json_decimal(level, "size", size_scale)};
+            if (delta.price > 0) levels.push_back(delta);
+        }
+    }
+
+    bool parse_json(std::string_view msg, const FixedScale* price_scale, const FixedScale* size_scale,
+                    PolymarketMessage::Kind default_kind, PolymarketMessage& out) {
+        out.reset();
+        try {
+            auto j = nlohmann::json::parse(msg.begin(), msg.end());
+            if (!j.is_object()) return false;
+
+            out.kind = j.contains("event_type") ? kind_of(j.value("event_type", "")) : default_kind;
+            out.asset_id = j.value("asset_id", "");
+            out.token = json_token(j);
+            out.timestamp_ms = json_timestamp_ms(j);
+
+            switch (out.kind) {
+                case PolymarketMessage::Kind::BOOK:
+                    json_book_side(j, "bids", Side::BUY, price_scale, size_scale, out.levels);
+                    json_book_side(j, "asks", Side::SELL, price_scale, size_scale, out.levels);
+                    break;
+
+                case PolymarketMessage::Kind::PRICE_CHANGE:
+                    if (j.contains("price_changes") && j["price_changes"].is_array()) {
+                        out.has_price_changes = true;
+                        for (const auto& entry : j["price_changes"]) {
+                            PolymarketChange change;
+                            change.token = json_token(entry);
+                            change.level = static_cast<uint32_t>(out.levels.size());
+
+                            LevelDelta delta;
+                            change.has_level = json_level_delta(entry, price_scale, size_scale, delta);
+                            if (change.has_level) out.levels.push_back(delta);
+
+                            change.has_top = entry.contains("best_bid") && entry.contains("best_ask");
+                            if (change.has_top) {
+                                change.best_bid = json_decimal(entry, "best_bid", price_scale);
+                                change.best_ask = json_decimal(entry, "best_ask", price_scale);
+                            }
+                            out.changes.push_back(change);
+                        }
+                    } else if (j.contains("changes") && j["changes"].is_array()) {
+                        // Legacy shape: one asset_id with a "changes" array
+                        for (const auto& entry : j["changes"]) {
+                            LevelDelta delta;
+                            if (json_level_delta(entry, price_scale, size_scale, delta)) out.levels.push_back(delta);
+                        }
+                    }
+                    break;
+
+                case PolymarketMessage::Kind::TRADE: {
+                    out.price = json_decimal(j, "price", price_scale);
+                    out.size = json_decimal(j, "size", size_scale);
+                    std::string side = j.value("side", "");
+                    out.side = (side == "buy" || side == "BUY") ? Side::BUY : Side::SELL;
+                    break;
+                }
+
+                case PolymarketMessage::Kind::NONE:
+                    break;
+            }
+            return true;
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+}
+
+bool parse_polymarket_message_json(std::string_view msg, const FixedScale* price_scale,
+                                   const FixedScale* size_scale, PolymarketMessage& out) {
+    return parse_json(msg, price_scale, size_scale, PolymarketMessage::Kind::NONE, out);
+}
+
+bool parse_polymarket_book(std::string_view body, const FixedScale* price_scale,
+                           const FixedScale* size_scale, PolymarketMessage& out) {
+    if (MessageParser(body, price_scale, size_scale, PolymarketMessage::Kind::BOOK, out).parse()) {
+        return true;
+    }
+    return parse_json(body, price_scale, size_scale, PolymarketMessage::Kind::BOOK, out);
+}
+
+} // namespace arb
@@ -0,0 +1,138 @@
+#include "market_data/resolver_cache.hpp"
+#include <spdlog/spdlog.h>
+#include <netdb.h>
+#include <cstring>
+#include <vector>
+
+namespace arb {
+
+namespace {
+    std::string endpoint_key(const std::string& host, int port) {
+        return host + ":" + std::to_string(port);
+    }
+
+    // Every distinct address, in getaddrinfo's preference order
+    bool getaddrinfo_all(const std::string& host, int port, std::vector<ResolverCache::Address>& out) {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* result = nullptr;
+        std::string service = std::to_string(port);
+        if (getaddrinfo(host.c_str(), service.c_str(), &hints, &result) != 0) return false;
+
+        out.clear();
+        for (addrinfo* ai = result; ai; ai = ai->ai_next) {
+            ResolverCache::Address address;
+            std::memcpy(&address.addr, ai->ai_addr, ai->ai_addrlen);
+            address.len = static_cast<socklen_t>(ai->ai_addrlen);
+            bool seen = false;
+            for (const auto& existing : out) {
+                seen |= existing.len == address.len && std::memcmp(&existing.addr, &address.addr, address.len) == 0;
+            }
+            if (!seen) out.push_back(address);
+        }
+        freeaddrinfo(result);
+        return !out.empty();
+    }
+}
+
+ResolverCache::ResolverCache() = default;
+
+ResolverCache::~ResolverCache() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (refresh_thread_.joinable()) {
+        refresh_thread_.join();
+    }
+}
+
+ResolverCache& ResolverCache::instance() {
+    static ResolverCache cache;
+    return cache;
+}
+
+bool ResolverCache::lookup(const std::string& host, int port, Address& out, size_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(endpoint_key(host, port));
+    if (it == entries_.end()) {
+        misses_++;
+        return false;
+    }
+    hits_++;
+    out = it->second[index % it->second.size()];
+    return true;
+}
+
+bool ResolverCache::resolve(const std::string& host, int port, Address& out, size_t index) {
+    std::vector<Address> addresses;
+    if (!getaddrinfo_all(host, port, addresses)) {
+        failures_++;
+        return false;
+    }
+    out = addresses[index % addresses.size()];
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[endpoint_key(host, port)] = std::move(addresses);
+    if (!running_ && refresh_interval_.count() > 0) {
+        running_ = true;
+        refresh_thread_ = std::thread(&ResolverCache::run_refresh, this);
+    }
+    return true;
+}
+
+void ResolverCache::invalidate(const std::string& host, int port) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.erase(endpoint_key(host, port));
+}
+
+void ResolverCache::set_refresh_interval(std::chrono::milliseconds interval) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        refresh_interval_ = interval;
+    }
+    cv_.notify_all();
+}
+
+void ResolverCache::run_refresh() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        if (refresh_interval_.count() == 0) {
+            cv_.wait(lock, [this] { return !running_ || refresh_interval_.count() > 0; });
+            continue;
+        }
+        cv_.wait_for(lock, refresh_interval_, [this] { return !running_; });
+        if (!running_) break;
+
+        std::vector<std::string> keys;
+        for (const auto& [key, address] : entries_) keys.push_back(key);
+        lock.unlock();
+
+        // getaddrinfo runs unlocked so lookups never wait on DNS
+        for (const auto& key : keys) {
+            size_t colon = key.rfind(':');
+            std::string host = key.substr(0, colon);
+            int port = std::stoi(key.substr(colon + 1));
+
+            std::vector<Address> addresses;
+            bool ok = getaddrinfo_all(host, port, addresses);
+            std::lock_guard<std::mutex> relock(mutex_);
+            if (!ok) {
+                failures_++;
+                spdlog::warn("DNS refresh failed for {}; keeping cached address", key);
+                continue;
+            }
+            // Only update entries that were not invalidated meanwhile
+            auto it = entries_.find(key);
+            if (it != entries_.end()) {
+                it->second = std::move(addresses);
+                refreshes_++;
+            }
+        }
+        lock.lock();
+    }
+}
+
+} // namespace arb
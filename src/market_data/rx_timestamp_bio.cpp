@@ -0,0 +1,128 @@
+#include "market_data/rx_timestamp_bio.hpp"
+#include <openssl/bio.h>
+#include <sys/socket.h>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+
+namespace arb {
+
+namespace {
+    struct SocketState {
+        int fd;
+        int64_t* last_rx_ns;
+        bool eof{false};
+    };
+
+    bool retriable(int err) {
+        return err == EAGAIN || err == EWOULDBLOCK || err == EINTR;
+    }
+
+    int rx_read(BIO* bio, char* buf, int len) {
+        auto* state = static_cast<SocketState*>(BIO_get_data(bio));
+        BIO_clear_retry_flags(bio);
+        if (!buf || len <= 0) return 0;
+
+        iovec iov{buf, static_cast<size_t>(len)};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(timespec))];
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        ssize_t n = recvmsg(state->fd, &msg, 0);
+        if (n < 0) {
+            if (retriable(errno)) BIO_set_retry_read(bio);
+            return -1;
+        }
+        if (n == 0) {
+            state->eof = true;
+            return 0;
+        }
+
+        for (cmsghdr* c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+            if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMPNS) {
+                timespec ts;
+                std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+                *state->last_rx_ns = static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+            }
+        }
+        return static_cast<int>(n);
+    }
+
+    int rx_write(BIO* bio, const char* buf, int len) {
+        auto* state = static_cast<SocketState*>(BIO_get_data(bio));
+        BIO_clear_retry_flags(bio);
+
+        ssize_t n = ::send(state->fd, buf, static_cast<size_t>(len), MSG_NOSIGNAL);
+        if (n < 0) {
+            if (retriable(errno)) BIO_set_retry_write(bio);
+            return -1;
+        }
+        return static_cast<int>(n);
+    }
+
+    long rx_ctrl(BIO* bio, int cmd, long, void* ptr) {
+        auto* state = static_cast<SocketState*>(BIO_get_data(bio));
+        switch (cmd) {
+            case BIO_C_GET_FD:
+                if (ptr) *static_cast<int*>(ptr) = state->fd;
+                return state->fd;
+            case BIO_CTRL_EOF:
+                return state->eof ? 1 : 0;
+            case BIO_CTRL_FLUSH:
+                return 1;
+            default:
+                return 0;
+        }
+    }
+
+    int rx_destroy(BIO* bio) {
+        delete static_cast<SocketState*>(BIO_get_data(bio));
+        BIO_set_data(bio, nullptr);
+        return 1;
+    }
+
+    BIO_METHOD* rx_method() {
+        static BIO_METHOD* method = nullptr;
+        static std::once_flag once;
+        std::call_once(once, [] {
+            method = BIO_meth_new(BIO_get_new_index() | BIO_TYPE_SOURCE_SINK | BIO_TYPE_DESCRIPTOR,
+                                  "socket with rx timestamps");
+            if (!method) return;
+            BIO_meth_set_read(method, rx_read);
+            BIO_meth_set_write(method, rx_write);
+            BIO_meth_set_ctrl(method, rx_ctrl);
+            BIO_meth_set_destroy(method, rx_destroy);
+        });
+        return method;
+    }
+}
+
+bool enable_rx_timestamps(int fd) {
+    int one = 1;
+    return setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &one, sizeof(one)) == 0;
+}
+
+bio_st* new_rx_timestamp_bio(int fd, int64_t* last_rx_ns) {
+    BIO_METHOD* method = rx_method();
+    if (!method) return nullptr;
+
+    BIO* bio = BIO_new(method);
+    if (!bio) return nullptr;
+    BIO_set_data(bio, new SocketState{fd, last_rx_ns});
+    BIO_set_init(bio, 1);
+    return bio;
+}
+
+Timestamp steady_from_realtime_ns(int64_t realtime_ns, Timestamp steady_now) {
+    int64_t wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        wall_now().time_since_epoch()).count();
+    int64_t age_ns = wall_ns - realtime_ns;
+    if (age_ns <= 0) return steady_now;  // Clock stepped back under us
+    return steady_now - Duration(age_ns);
+}
+
+} // namespace arb
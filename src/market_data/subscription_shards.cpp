@@ -0,0 +1,168 @@
+#include "market_data/subscription_shards.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace arb {
+
+namespace {
+    // Drop one occurrence; true if it was there
+    bool erase_one(std::vector<std::string>& tokens, const std::string& token_id) {
+        auto it = std::find(tokens.begin(), tokens.end(), token_id);
+        if (it == tokens.end()) return false;
+        tokens.erase(it);
+        return true;
+    }
+}
+
+SubscriptionShards::SubscriptionShards(size_t shards, Key key, size_t batch_size, size_t slack)
+    : key_(key)
+    , batch_size_(std::max<size_t>(batch_size, 1))
+    , slack_(slack)
+    , shards_(std::max<size_t>(shards, 1))
+    , added_(shards_.size())
+    , removed_(shards_.size())
+{
+}
+
+std::optional<SubscriptionShards::Key> SubscriptionShards::key_from_string(const std::string& s) {
+    if (s == "market") return Key::MARKET;
+    if (s == "token") return Key::TOKEN;
+    return std::nullopt;
+}
+
+void SubscriptionShards::add(const std::string& token_id, const std::string& market) {
+    if (token_group_.count(token_id)) return;
+
+    const std::string& group_key = key_ == Key::MARKET && !market.empty() ? market : token_id;
+    auto [it, created] = groups_.try_emplace(group_key);
+    Group& group = it->second;
+    if (created) {
+        group.shard = emptiest();
+        shards_[group.shard].groups.emplace(group_key, &group);
+    }
+
+    group.tokens.push_back(token_id);
+    shards_[group.shard].tokens++;
+    token_group_.emplace(token_id, group_key);
+
+    // Re-adding a token removed since the last commit cancels the removal
+    if (!erase_one(removed_[group.shard], token_id)) {
+        added_[group.shard].push_back(token_id);
+    }
+}
+
+void SubscriptionShards::remove(const std::string& token_id) {
+    auto it = token_group_.find(token_id);
+    if (it == token_group_.end()) return;
+
+    auto group_it = groups_.find(it->second);
+    Group& group = group_it->second;
+    size_t shard = group.shard;
+    erase_one(group.tokens, token_id);
+    shards_[shard].tokens--;
+    if (group.tokens.empty()) {
+        shards_[shard].groups.erase(group_it->first);
+        groups_.erase(group_it);
+    }
+    token_group_.erase(it);
+
+    // Never sent: nothing to take back
+    if (!erase_one(added_[shard], token_id)) {
+        removed_[shard].push_back(token_id);
+    }
+}
+
+std::vector<SubscriptionShards::Batch> SubscriptionShards::commit() {
+    rebalance();
+
+    std::vector<Batch> out;
+    for (size_t shard = 0; shard < shards_.size(); ++shard) {
+        append_batches(shard, true, added_[shard], out);
+        added_[shard].clear();
+    }
+    for (size_t shard = 0; shard < shards_.size(); ++shard) {
+        append_batches(shard, false, removed_[shard], out);
+        removed_[shard].clear();
+    }
+    return out;
+}
+
+std::vector<SubscriptionShards::Batch> SubscriptionShards::resubscribe(size_t shard) const {
+    std::vector<std::string> tokens;
+    tokens.reserve(shards_[shard].tokens);
+    for (const auto& [group_key, group] : shards_[shard].groups) {
+        tokens.insert(tokens.end(), group->tokens.begin(), group->tokens.end());
+    }
+
+    std::vector<Batch> out;
+    append_batches(shard, true, tokens, out);
+    return out;
+}
+
+std::optional<size_t> SubscriptionShards::shard_of(const std::string& token_id) const {
+    auto it = token_group_.find(token_id);
+    if (it == token_group_.end()) return std::nullopt;
+    return groups_.at(it->second).shard;
+}
+
+size_t SubscriptionShards::emptiest() const {
+    size_t best = 0;
+    for (size_t shard = 1; shard < shards_.size(); ++shard) {
+        if (shards_[shard].tokens < shards_[best].tokens) best = shard;
+    }
+    return best;
+}
+
+size_t SubscriptionShards::fullest() const {
+    size_t best = 0;
+    for (size_t shard = 1; shard < shards_.size(); ++shard) {
+        if (shards_[shard].tokens > shards_[best].tokens) best = shard;
+    }
+    return best;
+}
+
+void SubscriptionShards::rebalance() {
+    while (true) {
+        size_t from = fullest();
+        size_t to = emptiest();
+        size_t gap = shards_[from].tokens - shards_[to].tokens;
+        if (gap <= slack_) return;
+
+        // Moving g tokens leaves a gap of |gap - 2g|: take the group closest to half
+        std::string best_key;
+        size_t best_residual = gap;
+        for (const auto& [group_key, group] : shards_[from].groups) {
+            size_t g = group->tokens.size();
+            size_t residual = static_cast<size_t>(std::llabs(static_cast<long long>(gap) - 2 * static_cast<long long>(g)));
+            if (residual < best_residual) {
+                best_residual = residual;
+                best_key = group_key;
+            }
+        }
+        if (best_key.empty()) return;  // Every group is too big to help
+
+        Group* group = shards_[from].groups.at(best_key);
+        shards_[from].groups.erase(best_key);
+        shards_[from].tokens -= group->tokens.size();
+        shards_[to].groups.emplace(best_key, group);
+        shards_[to].tokens += group->tokens.size();
+        group->shard = to;
+        groups_moved_++;
+
+        for (const auto& token_id : group->tokens) {
+            if (!erase_one(added_[from], token_id)) removed_[from].push_back(token_id);
+            if (!erase_one(removed_[to], token_id)) added_[to].push_back(token_id);
+        }
+    }
+}
+
+void SubscriptionShards::append_batches(size_t shard, bool subscribe,
+                                        const std::vector<std::string>& tokens,
+                                        std::vector<Batch>& out) const {
+    for (size_t i = 0; i < tokens.size(); i += batch_size_) {
+        size_t end = std::min(tokens.size(), i + batch_size_);
+        out.push_back({shard, subscribe, {tokens.begin() + i, tokens.begin() + end}});
+    }
+}
+
+} // namespace arb
@@ -0,0 +1,61 @@
+#include "market_data/tick_ladder.hpp"
+#include <algorithm>
+
+namespace arb {
+
+TickLadder::TickLadder(bool descending, Price tick_size)
+    : descending_(descending)
+    , ticks_per_unit_(std::round(1.0 / tick_size))
+    , sizes_(static_cast<size_t>(ticks_per_unit_), 0.0)
+{
+}
+
+bool TickLadder::set(Price price, Size size) {
+    int tick = to_tick(price);
+    if (tick < 0) return false;
+
+    if (size <= 0.0) {
+        if (sizes_[tick] > 0.0) {
+            remove_at(tick);
+        }
+        return true;
+    }
+
+    if (sizes_[tick] <= 0.0) {
+        ++count_;
+        if (best_ < 0 || better(tick, best_)) best_ = tick;
+        if (worst_ < 0 || better(worst_, tick)) worst_ = tick;
+    }
+    sizes_[tick] = size;
+    return true;
+}
+
+void TickLadder::clear() {
+    std::fill(sizes_.begin(), sizes_.end(), 0.0);
+    best_ = -1;
+    worst_ = -1;
+    count_ = 0;
+}
+
+void TickLadder::remove_at(int tick) {
+    sizes_[tick] = 0.0;
+    --count_;
+
+    if (count_ == 0) {
+        best_ = -1;
+        worst_ = -1;
+        return;
+    }
+
+    // Walk the cursor inward until it lands on a populated tick. Both
+    // cursors are bounded by each other, so the scan never leaves the range.
+    const int toward_worse = descending_ ? -1 : 1;
+    if (tick == best_) {
+        while (sizes_[best_] <= 0.0) best_ += toward_worse;
+    }
+    if (tick == worst_) {
+        while (sizes_[worst_] <= 0.0) worst_ -= toward_worse;
+    }
+}
+
+} // namespace arb
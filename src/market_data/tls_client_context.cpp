@@ -0,0 +1,78 @@
+#include "market_data/tls_client_context.hpp"
+#include <openssl/ssl.h>
+#include <csignal>
+#include <map>
+#include <memory>
+
+namespace arb {
+
+TlsClientContext* TlsClientContext::for_endpoint(const std::string& host, int port) {
+    static std::once_flag init;
+    std::call_once(init, [] {
+        OPENSSL_init_ssl(0, nullptr);
+        // SSL writes go through write(2); a reset peer must not kill the process
+        std::signal(SIGPIPE, SIG_IGN);
+    });
+
+    static std::map<std::string, std::unique_ptr<TlsClientContext>> contexts;
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto& context = contexts[host + ":" + std::to_string(port)];
+    if (!context) {
+        context.reset(new TlsClientContext(host));
+        if (!context->ctx_) {
+            context.reset();
+            return nullptr;
+        }
+    }
+    return context.get();
+}
+
+TlsClientContext::TlsClientContext(const std::string& host)
+    : host_(host)
+{
+    ctx_ = SSL_CTX_new(TLS_client_method());
+    if (!ctx_) return;
+
+    SSL_CTX_set_mode(ctx_, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+    // Sessions are kept here, not in OpenSSL's internal client cache
+    SSL_CTX_set_session_cache_mode(ctx_, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ctx_, &TlsClientContext::on_new_session);
+    SSL_CTX_set_app_data(ctx_, this);
+}
+
+TlsClientContext::~TlsClientContext() {
+    if (session_) SSL_SESSION_free(session_);
+    if (ctx_) SSL_CTX_free(ctx_);
+}
+
+ssl_st* TlsClientContext::new_ssl() {
+    SSL* ssl = SSL_new(ctx_);
+    if (!ssl) return nullptr;
+    SSL_set_tlsext_host_name(ssl, host_.c_str());
+
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    if (session_) {
+        SSL_set_session(ssl, session_);  // Takes its own reference
+    }
+    return ssl;
+}
+
+bool TlsClientContext::has_session() const {
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    return session_ != nullptr;
+}
+
+int TlsClientContext::on_new_session(ssl_st* ssl, ssl_session_st* session) {
+    auto* self = static_cast<TlsClientContext*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+    if (!self || !SSL_SESSION_is_resumable(session)) return 0;
+
+    std::lock_guard<std::mutex> lock(self->session_mutex_);
+    if (self->session_) SSL_SESSION_free(self->session_);
+    self->session_ = session;
+    self->sessions_received_++;
+    return 1;  // We keep the reference
+}
+
+} // namespace arb
@@ -0,0 +1,269 @@
+#include "market_data/ws_client_base.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cctype>
+
+namespace arb {
+
+namespace {
+    // The feed is as good as its best connection
+    int status_rank(ConnectionStatus s) {
+        switch (s) {
+            case ConnectionStatus::CONNECTED: return 4;
+            case ConnectionStatus::RECONNECTING: return 3;
+            case ConnectionStatus::CONNECTING: return 2;
+            case ConnectionStatus::ERROR: return 1;
+            case ConnectionStatus::DISCONNECTED: return 0;
+        }
+        return 0;
+    }
+
+    bool worse(ConnectionStatus a, ConnectionStatus b) {
+        return status_rank(a) < status_rank(b);
+    }
+
+    // Metric names are lower case: "binance.wire_to_parse"
+    std::string lower_case(std::string s) {
+        std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+        return s;
+    }
+}
+
+WebSocketClientBase::WebSocketClientBase(const std::string& url, const std::string& name, int connections,
+                                         int shards)
+    : url_(url)
+    , name_(name)
+    , latency_(lower_case(name))
+    , per_shard_(static_cast<size_t>(std::max(1, connections)))
+{
+    size_t shard_count = static_cast<size_t>(std::max(1, shards));
+    path_status_.assign(shard_count * per_shard_, ConnectionStatus::DISCONNECTED);
+
+    for (size_t s = 0; s < shard_count; ++s) {
+        auto shard = std::make_unique<Shard>();
+        if (s == 0) {
+            shard->loop = &EventLoop::instance();
+        } else {
+            shard->own_loop = std::make_unique<EventLoop>();
+            shard->loop = shard->own_loop.get();
+        }
+        shard->first_path = s * per_shard_;
+        if (per_shard_ > 1) {
+            shard->dedup.emplace(per_shard_);
+        }
+
+        std::string shard_name = shard_count == 1 ? name : name + "-" + std::to_string(s + 1);
+        for (size_t k = 0; k < per_shard_; ++k) {
+            size_t path = shard->first_path + k;
+            std::string path_name = per_shard_ == 1 ? shard_name : shard_name + "#" + std::to_string(k + 1);
+            auto ws = std::make_unique<WsConnection>(*shard->loop, url, path_name);
+            ws->set_open_callback([this, s, path] {
+                Shard& opening = *shards_[s];
+                opening.opening_path = path;
+                on_open(s);
+                opening.opening_path.reset();
+            });
+            ws->set_message_callback([this, path](std::string_view msg, Timestamp recv_time) {
+                dispatch(path, msg, recv_time);
+            });
+            ws->set_status_callback([this, path](ConnectionStatus st) { on_path_status(path, st); });
+            ws->set_error_callback([this](const std::string& error) {
+                if (on_error_) on_error_(error);
+            });
+            ws_.push_back(std::move(ws));
+        }
+        shards_.push_back(std::move(shard));
+    }
+}
+
+WebSocketClientBase::~WebSocketClientBase() {
+    // Derived clients disconnect in their own destructors; this only covers
+    // direct use, before the callbacks above lose their target
+    wanted_ = false;
+    for (auto& ws : ws_) ws->stop();
+}
+
+void WebSocketClientBase::connect() {
+    if (status_.load() != ConnectionStatus::DISCONNECTED &&
+        status_.load() != ConnectionStatus::ERROR) {
+        spdlog::warn("{} already running", name_);
+        return;
+    }
+
+    EventLoop::instance().start(feed_thread_cpu_);
+    for (auto& shard : shards_) {
+        if (shard->own_loop) shard->own_loop->start();
+    }
+    wanted_ = true;
+    for (size_t path = 0; path < ws_.size(); ++path) {
+        ws_[path]->set_reconnect_policy(reconnect_delay_ms_, max_reconnect_attempts_);
+        ws_[path]->set_address_index(spread_addresses_ ? path % per_shard_ : 0);
+        ws_[path]->set_rx_timestamps(rx_timestamps_);
+        ws_[path]->start();
+    }
+}
+
+void WebSocketClientBase::disconnect() {
+    wanted_ = false;
+    for (auto& ws : ws_) ws->stop();
+    for (auto& shard : shards_) shard->down_since_ns = 0;
+    std::lock_guard<std::mutex> lock(status_mutex_);
+    set_status(ConnectionStatus::DISCONNECTED);
+}
+
+void WebSocketClientBase::reconnect() {
+    for (auto& ws : ws_) {
+        ws->stop();
+        ws->set_reconnect_policy(reconnect_delay_ms_, max_reconnect_attempts_);
+        ws->start();
+    }
+}
+
+bool WebSocketClientBase::send(std::string_view message) {
+    // Inside on_open(), on the loop thread of the shard that opened
+    for (size_t s = 0; s < shards_.size(); ++s) {
+        if (shards_[s]->loop->in_loop_thread() && shards_[s]->opening_path) return send(s, message);
+    }
+
+    bool sent = false;
+    for (auto& ws : ws_) {
+        sent |= ws->send_text(message);
+    }
+    return sent;
+}
+
+bool WebSocketClientBase::send(size_t shard, std::string_view message) {
+    const Shard& target = *shards_[shard];
+
+    // opening_path is loop-thread state; other threads always broadcast
+    if (target.loop->in_loop_thread() && target.opening_path) {
+        return ws_[*target.opening_path]->send_text(message);
+    }
+
+    bool sent = false;
+    for (size_t k = 0; k < per_shard_; ++k) {
+        sent |= ws_[target.first_path + k]->send_text(message);
+    }
+    return sent;
+}
+
+bool WebSocketClientBase::other_connection_open(size_t shard) const {
+    const Shard& target = *shards_[shard];
+    std::lock_guard<std::mutex> lock(status_mutex_);
+    for (size_t path = target.first_path; path < target.first_path + per_shard_; ++path) {
+        if (target.opening_path && path == *target.opening_path) continue;
+        if (path_status_[path] == ConnectionStatus::CONNECTED) return true;
+    }
+    return false;
+}
+
+void WebSocketClientBase::dispatch(size_t path, std::string_view msg, Timestamp recv_time) {
+    size_t s = path / per_shard_;
+    Shard& shard = *shards_[s];
+    if (shard.dedup && !shard.dedup->accept(path - shard.first_path, msg, recv_time)) return;
+    if (shard.down_since_ns.load(std::memory_order_relaxed) != 0) end_feed_gap(shard, recv_time);
+
+    Timestamp start = now();
+    handle_message(s, msg, recv_time);
+    int64_t parse_ns = (now() - start).count();
+
+    // Only this shard's loop thread writes its counters
+    shard.messages.fetch_add(1, std::memory_order_relaxed);
+    shard.parse_ns_total.fetch_add(parse_ns, std::memory_order_relaxed);
+    if (parse_ns > shard.parse_ns_max.load(std::memory_order_relaxed)) {
+        shard.parse_ns_max.store(parse_ns, std::memory_order_relaxed);
+    }
+}
+
+void WebSocketClientBase::on_path_status(size_t path, ConnectionStatus s) {
+    Shard& shard = *shards_[path / per_shard_];
+    std::lock_guard<std::mutex> lock(status_mutex_);
+    path_status_[path] = s;
+
+    // A shard is as good as its best connection, the feed as its worst shard
+    auto first = path_status_.begin() + static_cast<std::ptrdiff_t>(shard.first_path);
+    ConnectionStatus shard_status = *std::max_element(first, first + static_cast<std::ptrdiff_t>(per_shard_), worse);
+    if (shard_status != shard.status) {
+        // The shard's last open connection just went: dark until a message arrives
+        if (shard.status == ConnectionStatus::CONNECTED && wanted_.load() && shard.down_since_ns.load() == 0) {
+            shard.down_since_ns = now().time_since_epoch().count();
+        }
+        shard.status = shard_status;
+    }
+
+    ConnectionStatus feed = shards_.front()->status;
+    for (const auto& other : shards_) {
+        if (worse(other->status, feed)) feed = other->status;
+    }
+    if (feed != status_.load()) set_status(feed);
+}
+
+void WebSocketClientBase::end_feed_gap(Shard& shard, Timestamp recv_time) {
+    Timestamp down_since(Timestamp::duration(shard.down_since_ns.exchange(0)));
+    Duration gap = recv_time - down_since;
+
+    int64_t gap_us = std::chrono::duration_cast<std::chrono::microseconds>(gap).count();
+    shard.feed_gaps++;
+    feed_gaps_++;
+    last_feed_gap_us_ = gap_us;
+    // Shards end their gaps on different threads
+    int64_t longest = max_feed_gap_us_.load();
+    while (gap_us > longest && !max_feed_gap_us_.compare_exchange_weak(longest, gap_us)) {}
+    spdlog::info("{}: feed resumed {} ms after going down", ws_[shard.first_path]->name(), gap_us / 1000);
+    if (on_feed_gap_) on_feed_gap_(gap);
+}
+
+void WebSocketClientBase::handle_message(size_t, std::string_view msg, Timestamp recv_time) {
+    if (on_message_) on_message_(msg, recv_time);
+}
+
+void WebSocketClientBase::set_status(ConnectionStatus s) {
+    status_ = s;
+    if (on_status_) on_status_(s);
+}
+
+int64_t WebSocketClientBase::messages_received() const {
+    int64_t applied = 0;
+    for (const auto& shard : shards_) applied += shard->messages.load();
+    return applied;
+}
+
+int64_t WebSocketClientBase::bytes_received() const {
+    int64_t bytes = 0;
+    for (const auto& ws : ws_) bytes += ws->bytes_received();
+    return bytes;
+}
+
+Timestamp WebSocketClientBase::last_message_time() const {
+    Timestamp latest{};
+    for (const auto& ws : ws_) latest = std::max(latest, ws->last_message_time());
+    return latest;
+}
+
+FeedShardStats WebSocketClientBase::shard_stats(size_t shard) const {
+    const Shard& source = *shards_[shard];
+    FeedShardStats s;
+    s.messages = source.messages.load();
+    s.parse_ns_total = source.parse_ns_total.load();
+    s.parse_ns_max = source.parse_ns_max.load();
+    s.feed_gaps = source.feed_gaps.load();
+    return s;
+}
+
+FeedPathStats WebSocketClientBase::path_stats(size_t path) const {
+    const Shard& shard = *shards_[path / per_shard_];
+    if (shard.dedup) return shard.dedup->path_stats(path - shard.first_path);
+    FeedPathStats s;
+    s.messages = s.wins = ws_[path]->messages_received();
+    return s;
+}
+
+int64_t WebSocketClientBase::duplicates_dropped() const {
+    int64_t dropped = 0;
+    for (const auto& shard : shards_) {
+        if (shard->dedup) dropped += shard->dedup->duplicates();
+    }
+    return dropped;
+}
+
+} // namespace arb
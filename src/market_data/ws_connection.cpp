@@ -0,0 +1,680 @@
+#include "market_data/ws_connection.hpp"
+#include "market_data/rx_timestamp_bio.hpp"
+#include "market_data/tls_client_context.hpp"
+#include <spdlog/spdlog.h>
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <random>
+#include <thread>
+
+namespace arb {
+
+namespace {
+    // Cap per SSL_read; a TLS record carries at most 16KB of plaintext anyway
+    constexpr size_t MAX_READ = 64 * 1024;
+    constexpr size_t COALESCE_LIMIT = 16 * 1024;      // One TLS record
+    constexpr size_t MAX_SPARE_SEGMENTS = 4;
+
+    constexpr size_t MAX_UPGRADE_RESPONSE = 16 * 1024;
+    // A session must stay up this long before its drop counts as a fresh
+    // start; shorter ones keep counting attempts so a flapping peer backs off
+    constexpr auto MIN_STABLE_SESSION = std::chrono::seconds(5);
+
+    std::string create_ws_handshake(const std::string& host, const std::string& path) {
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        std::uniform_int_distribution<> dis(0, 255);
+
+        std::string key;
+        for (int i = 0; i < 16; i++) {
+            key += static_cast<char>(dis(gen));
+        }
+
+        static const char* b64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string encoded_key;
+        for (size_t i = 0; i < key.size(); i += 3) {
+            uint32_t n = static_cast<uint8_t>(key[i]) << 16;
+            if (i + 1 < key.size()) n |= static_cast<uint8_t>(key[i + 1]) << 8;
+            if (i + 2 < key.size()) n |= static_cast<uint8_t>(key[i + 2]);
+            encoded_key += b64[(n >> 18) & 0x3F];
+            encoded_key += b64[(n >> 12) & 0x3F];
+            encoded_key += (i + 1 < key.size()) ? b64[(n >> 6) & 0x3F] : '=';
+            encoded_key += (i + 2 < key.size()) ? b64[n & 0x3F] : '=';
+        }
+
+        std::string request = "GET " + path + " HTTP/1.1\r\n";
+        request += "Host: " + host + "\r\n";
+        request += "Upgrade: websocket\r\n";
+        request += "Connection: Upgrade\r\n";
+        request += "Sec-WebSocket-Key: " + encoded_key + "\r\n";
+        request += "Sec-WebSocket-Version: 13\r\n";
+        request += "\r\n";
+        return request;
+    }
+
+    uint64_t random_seed() {
+        std::random_device rd;
+        return (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+
+    std::string ssl_error_string() {
+        unsigned long err = ERR_get_error();
+        if (err == 0) return strerror(errno);
+        char buf[256];
+        ERR_error_string_n(err, buf, sizeof(buf));
+        return buf;
+    }
+}
+
+bool parse_ws_url(const std::string& url, WsEndpoint& out) {
+    std::string_view rest(url);
+    WsEndpoint ep;
+    if (rest.substr(0, 6) == "wss://") {
+        ep.tls = true;
+        ep.port = 443;
+        rest.remove_prefix(6);
+    } else if (rest.substr(0, 5) == "ws://") {
+        ep.tls = false;
+        ep.port = 80;
+        rest.remove_prefix(5);
+    } else {
+        return false;
+    }
+
+    size_t slash = rest.find('/');
+    std::string_view authority = rest.substr(0, slash);
+    ep.path = slash == std::string_view::npos ? "/" : std::string(rest.substr(slash));
+
+    size_t colon = authority.rfind(':');
+    if (colon != std::string_view::npos) {
+        std::string_view port = authority.substr(colon + 1);
+        if (port.empty() || port.size() > 5) return false;
+        int value = 0;
+        for (char c : port) {
+            if (c < '0' || c > '9') return false;
+            value = value * 10 + (c - '0');
+        }
+        if (value == 0 || value > 65535) return false;
+        ep.port = value;
+        authority = authority.substr(0, colon);
+    }
+    if (authority.empty()) return false;
+    ep.host = std::string(authority);
+
+    out = std::move(ep);
+    return true;
+}
+
+WsConnection::WsConnection(EventLoop& loop, const std::string& url, const std::string& name)
+    : loop_(loop)
+    , name_(name)
+    , encoder_(random_seed())
+    , alive_(std::make_shared<AliveToken>())
+{
+    valid_url_ = parse_ws_url(url, endpoint_);
+    if (!valid_url_) {
+        spdlog::error("{}: invalid WebSocket URL: {}", name_, url);
+    } else if (!endpoint_.tls) {
+        // Every venue we talk to is wss://; plain ws:// is not implemented
+        spdlog::error("{}: only wss:// URLs are supported: {}", name_, url);
+        valid_url_ = false;
+    } else {
+        // Built now so the first connect doesn't pay for it
+        tls_ = TlsClientContext::for_endpoint(endpoint_.host, endpoint_.port);
+    }
+}
+
+WsConnection::~WsConnection() {
+    stop();
+    // After this no resolver thread can post, so the loop may go right after us
+    loop_.run_sync([this] {
+        std::lock_guard<std::mutex> lock(alive_->mutex);
+        alive_->alive = false;
+    });
+}
+
+void WsConnection::set_reconnect_policy(int delay_ms, int max_attempts) {
+    reconnect_delay_ms_ = delay_ms;
+    max_reconnect_attempts_ = max_attempts;
+}
+
+void WsConnection::set_status(ConnectionStatus s) {
+    status_ = s;
+    if (on_status_) on_status_(s);
+}
+
+void WsConnection::start() {
+    loop_.post([this] {
+        if (wanted_) return;
+        wanted_ = true;
+        attempts_ = 0;
+        set_status(ConnectionStatus::CONNECTING);
+        begin_connect();
+    });
+}
+
+void WsConnection::stop() {
+    loop_.run_sync([this] {
+        if (!wanted_) return;
+        wanted_ = false;
+        dropped_at_ = Timestamp{};  // A requested stop is not a feed gap
+        if (state_ == State::OPEN) {
+            queue_close(WS_CLOSE_NORMAL);  // Best-effort: the reply is not awaited
+            disconnects_++;
+        }
+        teardown();
+        set_status(ConnectionStatus::DISCONNECTED);
+    });
+}
+
+bool WsConnection::send_text(std::string_view message) {
+    if (status_.load() != ConnectionStatus::CONNECTED) return false;
+
+    if (loop_.in_loop_thread()) {
+        if (state_ != State::OPEN) return false;
+        queue_frame(message, 0x01);
+        return true;
+    }
+
+    // Masked here into the outbox; only the first frame of a batch posts
+    bool first;
+    {
+        std::lock_guard<std::mutex> lock(outbox_mutex_);
+        first = outbox_.empty();
+        encoder_.encode(message, 0x01, outbox_);
+    }
+    if (first) loop_.post([this] { drain_outbox(); });
+    return true;
+}
+
+void WsConnection::drain_outbox() {
+    // Swap a recycled segment in, so the outbox keeps a warm buffer too
+    std::string frames = spare_segment();
+    {
+        std::lock_guard<std::mutex> lock(outbox_mutex_);
+        frames.swap(outbox_);
+    }
+    if (state_ != State::OPEN || frames.empty()) {
+        recycle_segment(std::move(frames));
+        return;
+    }
+    tx_queue_.push_back(std::move(frames));
+    flush_tx();
+}
+
+void WsConnection::begin_connect() {
+    if (!wanted_) return;
+    if (!valid_url_ || !tls_) {
+        fail(valid_url_ ? "failed to create SSL context" : "invalid URL");
+        return;
+    }
+
+    state_ = State::RESOLVING;
+    ResolverCache::Address cached;
+    if (ResolverCache::instance().lookup(endpoint_.host, endpoint_.port, cached, address_index_)) {
+        on_resolved(generation_, true, cached);
+        return;
+    }
+
+    uint64_t generation = generation_;
+    std::weak_ptr<AliveToken> alive = alive_;
+    EventLoop* loop = &loop_;
+    std::string host = endpoint_.host;
+    int port = endpoint_.port;
+    size_t index = address_index_;
+
+    // getaddrinfo blocks; keep it off the loop so other feeds keep flowing
+    std::thread([this, loop, alive, generation, host, port, index] {
+        ResolverCache::Address addr;
+        bool ok = ResolverCache::instance().resolve(host, port, addr, index);
+
+        auto token = alive.lock();
+        if (!token) return;
+        // Held across post(): the destructor can't finish, nor the loop go, meanwhile
+        std::lock_guard<std::mutex> lock(token->mutex);
+        if (!token->alive) return;
+        loop->post([this, alive, generation, ok, addr] {
+            auto live = alive.lock();
+            if (!live) return;
+            {
+                std::lock_guard<std::mutex> lock(live->mutex);
+                if (!live->alive) return;
+            }
+            on_resolved(generation, ok, addr);
+        });
+    }).detach();
+}
+
+void WsConnection::on_resolved(uint64_t generation, bool ok, const ResolverCache::Address& addr) {
+    if (generation != generation_ || state_ != State::RESOLVING) return;
+    if (!ok) {
+        fail("failed to resolve host " + endpoint_.host);
+        return;
+    }
+    addr_ = addr;
+
+    fd_ = socket(addr_.addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) {
+        fail(std::string("failed to create socket: ") + strerror(errno));
+        return;
+    }
+    int one = 1;
+    setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fd_stamped_ = rx_timestamps_ && enable_rx_timestamps(fd_);
+    if (rx_timestamps_ && !fd_stamped_) {
+        spdlog::debug("{}: SO_TIMESTAMPNS unavailable, timing reads in user space", name_);
+    }
+
+    int rc = ::connect(fd_, reinterpret_cast<const sockaddr*>(&addr_.addr), addr_.len);
+    if (rc < 0 && errno != EINPROGRESS) {
+        fail(std::string("failed to connect: ") + strerror(errno));
+        return;
+    }
+
+    state_ = State::CONNECTING;
+    armed_events_ = EPOLLOUT;
+    if (!loop_.add(fd_, armed_events_, [this](uint32_t events) { on_io(events); })) {
+        fail("failed to register socket");
+        return;
+    }
+    if (rc == 0) finish_tcp_connect();
+}
+
+void WsConnection::arm(uint32_t events) {
+    if (fd_ < 0 || events == armed_events_) return;
+    armed_events_ = events;
+    loop_.modify(fd_, events);
+}
+
+void WsConnection::on_io(uint32_t events) {
+    switch (state_) {
+        case State::CONNECTING:
+            finish_tcp_connect();
+            break;
+        case State::TLS_HANDSHAKE:
+            continue_tls_handshake();
+            break;
+        case State::WS_HANDSHAKE:
+        case State::OPEN:
+            if (events & EPOLLOUT) flush_tx();
+            if (fd_ >= 0 && (events & (EPOLLIN | EPOLLHUP | EPOLLERR))) read_available();
+            break;
+        default:
+            break;
+    }
+}
+
+void WsConnection::finish_tcp_connect() {
+    int err = 0;
+    socklen_t len = sizeof(err);
+    getsockopt(fd_, SOL_SOCKET, SO_ERROR, &err, &len);
+    if (err != 0) {
+        fail(std::string("failed to connect: ") + strerror(err));
+        return;
+    }
+
+    ssl_ = tls_->new_ssl();
+    if (!ssl_) {
+        fail("SSL_new failed");
+        return;
+    }
+    // Read through recvmsg() so the kernel's receive stamp survives TLS
+    BIO* bio = fd_stamped_ ? new_rx_timestamp_bio(fd_, &kernel_rx_ns_) : nullptr;
+    if (bio) {
+        SSL_set_bio(ssl_, bio, bio);
+    } else {
+        SSL_set_fd(ssl_, fd_);
+    }
+    SSL_set_connect_state(ssl_);
+
+    state_ = State::TLS_HANDSHAKE;
+    continue_tls_handshake();
+}
+
+void WsConnection::continue_tls_handshake() {
+    ERR_clear_error();  // SSL_get_error reads this thread's queue
+    int rc = SSL_connect(ssl_);
+    if (rc == 1) {
+        if (SSL_session_reused(ssl_)) tls_resumptions_++;
+        state_ = State::WS_HANDSHAKE;
+        tx_queue_.push_back(create_ws_handshake(endpoint_.host, endpoint_.path));
+        arm(EPOLLIN);
+        flush_tx();
+        return;
+    }
+
+    switch (SSL_get_error(ssl_, rc)) {
+        case SSL_ERROR_WANT_READ:
+            arm(EPOLLIN);
+            break;
+        case SSL_ERROR_WANT_WRITE:
+            arm(EPOLLIN | EPOLLOUT);
+            break;
+        default:
+            fail("SSL handshake failed: " + ssl_error_string());
+            break;
+    }
+}
+
+void WsConnection::flush_tx() {
+    // One SSL_write per segment straight from its buffer; nothing is joined
+    while (!tx_queue_.empty() && ssl_) {
+        std::string& segment = tx_queue_.front();
+        ERR_clear_error();
+        int n = SSL_write(ssl_, segment.data() + tx_offset_, static_cast<int>(segment.size() - tx_offset_));
+        if (n > 0) {
+            tx_offset_ += static_cast<size_t>(n);
+            if (tx_offset_ == segment.size()) {
+                recycle_segment(std::move(segment));
+                tx_queue_.pop_front();
+                tx_offset_ = 0;
+            }
+            continue;
+        }
+        int err = SSL_get_error(ssl_, n);
+        if (err == SSL_ERROR_WANT_WRITE || err == SSL_ERROR_WANT_READ) {
+            arm(EPOLLIN | EPOLLOUT);
+            return;
+        }
+        fail("SSL write failed: " + ssl_error_string());
+        return;
+    }
+    if (ssl_) arm(EPOLLIN);
+}
+
+void WsConnection::queue_frame(std::string_view payload, uint8_t opcode) {
+    // Small frames share the tail segment unless SSL_write is already working
+    // on it (a retried write must see the same bytes)
+    if (tx_queue_.size() < 2 || tx_queue_.back().size() >= COALESCE_LIMIT) {
+        tx_queue_.push_back(spare_segment());
+    }
+    encoder_.encode(payload, opcode, tx_queue_.back());
+    flush_tx();
+}
+
+std::string WsConnection::spare_segment() {
+    if (tx_spare_.empty()) {
+        std::string segment;
+        segment.reserve(COALESCE_LIMIT);
+        return segment;
+    }
+    std::string segment = std::move(tx_spare_.back());
+    tx_spare_.pop_back();
+    return segment;
+}
+
+void WsConnection::recycle_segment(std::string&& segment) {
+    if (tx_spare_.size() >= MAX_SPARE_SEGMENTS) return;
+    segment.clear();
+    tx_spare_.push_back(std::move(segment));
+}
+
+void WsConnection::read_available() {
+    // Drain until WANT_READ: SSL may hold whole records that epoll can't see
+    while (ssl_) {
+        char handshake_chunk[4096];
+        char* dst = handshake_chunk;
+        size_t space = sizeof(handshake_chunk);
+        if (state_ == State::OPEN) {
+            WsFrameDecoder::Space free = rx_.write_space();
+            dst = free.data;
+            space = std::min(free.size, MAX_READ);
+        }
+
+        ERR_clear_error();
+        int n = SSL_read(ssl_, dst, static_cast<int>(space));
+        if (n > 0) {
+            bytes_received_ += n;
+            Timestamp recv_time = now();
+            if (kernel_rx_ns_ != 0) {
+                recv_time = steady_from_realtime_ns(kernel_rx_ns_, recv_time);
+                kernel_stamped_reads_++;
+            }
+
+            if (state_ == State::OPEN) {
+                rx_.commit(static_cast<size_t>(n));
+            } else {
+                upgrade_.append(dst, static_cast<size_t>(n));
+                if (!parse_upgrade_response()) return;
+            }
+            if (state_ == State::OPEN) parse_frames(recv_time);
+            continue;
+        }
+
+        switch (SSL_get_error(ssl_, n)) {
+            case SSL_ERROR_WANT_READ:
+                return;
+            case SSL_ERROR_WANT_WRITE:
+                arm(EPOLLIN | EPOLLOUT);
+                return;
+            case SSL_ERROR_ZERO_RETURN:
+                fail("connection closed by peer");
+                return;
+            default:
+                fail("SSL read failed: " + ssl_error_string());
+                return;
+        }
+    }
+}
+
+bool WsConnection::parse_upgrade_response() {
+    size_t end = upgrade_.find("\r\n\r\n");
+    if (end == std::string::npos) {
+        if (upgrade_.size() > MAX_UPGRADE_RESPONSE) {
+            fail("WebSocket handshake response too large");
+            return false;
+        }
+        return true;  // Wait for the rest of the headers
+    }
+
+    std::string_view status_line(upgrade_.data(), upgrade_.find("\r\n"));
+    if (status_line.find(" 101") == std::string_view::npos) {
+        fail("WebSocket handshake failed: " + std::string(status_line));
+        return false;
+    }
+
+    // Frames may arrive in the same record as the response headers
+    rx_.append(std::string_view(upgrade_).substr(end + 4));
+    upgrade_.clear();
+    state_ = State::OPEN;
+    opened_at_ = now();
+    connects_++;
+    spdlog::info("{} WebSocket connected", name_);
+    set_status(ConnectionStatus::CONNECTED);
+    if (on_open_) on_open_();
+    return state_ == State::OPEN;
+}
+
+void WsConnection::parse_frames(Timestamp recv_time) {
+    const uint64_t generation = generation_;
+    WsFrame frame;
+
+    for (;;) {
+        WsFrameDecoder::Result result = rx_.next(frame);
+        if (result == WsFrameDecoder::Result::NEED_MORE) return;
+        if (result == WsFrameDecoder::Result::ERROR) {
+            protocol_error(WS_CLOSE_TOO_BIG, rx_.error());
+            return;
+        }
+
+        frames_received_++;
+        if (!handle_frame(frame, recv_time)) return;
+        // A callback may have stopped or restarted the connection
+        if (generation != generation_ || state_ != State::OPEN) return;
+    }
+}
+
+// Returns false once the connection has been torn down
+bool WsConnection::handle_frame(const WsFrame& frame, Timestamp recv_time) {
+    switch (messages_.on_frame(frame)) {
+        case WsMessageAssembler::Action::NONE:
+            return true;
+        case WsMessageAssembler::Action::MESSAGE:
+            if (messages_.fragmented()) fragmented_messages_++;
+            deliver(messages_.payload(), recv_time);
+            return true;
+        case WsMessageAssembler::Action::PING:
+            pings_received_++;
+            queue_frame(messages_.payload(), 0x0A);
+            return state_ == State::OPEN;
+        case WsMessageAssembler::Action::CLOSE:
+            if (messages_.close_code() != 0) {
+                spdlog::info("{}: server closed connection, replying {} {}",
+                             name_, messages_.close_code(), messages_.payload());
+                queue_close(messages_.close_code());
+            } else {
+                spdlog::info("{}: server closed connection", name_);
+                queue_frame(std::string_view(), 0x08);
+            }
+            // A failed echo has already torn the connection down
+            if (state_ == State::OPEN) fail("closed by server");
+            return false;
+        case WsMessageAssembler::Action::ERROR:
+            protocol_error(messages_.close_code(), messages_.error());
+            return false;
+    }
+    return false;
+}
+
+void WsConnection::deliver(std::string_view payload, Timestamp recv_time) {
+    messages_received_++;
+    last_message_ns_ = recv_time.time_since_epoch().count();
+    if (dropped_at_ != Timestamp{}) end_feed_gap(recv_time);
+    if (on_message_) on_message_(payload, recv_time);
+}
+
+void WsConnection::end_feed_gap(Timestamp recv_time) {
+    Duration gap = recv_time - dropped_at_;
+    dropped_at_ = Timestamp{};
+
+    int64_t gap_us = std::chrono::duration_cast<std::chrono::microseconds>(gap).count();
+    feed_gaps_++;
+    last_feed_gap_us_ = gap_us;
+    if (gap_us > max_feed_gap_us_.load()) max_feed_gap_us_ = gap_us;  // Loop thread is the only writer
+    spdlog::info("{}: feed resumed {} ms after the drop", name_, gap_us / 1000);
+    if (on_feed_gap_) on_feed_gap_(gap);
+}
+
+void WsConnection::queue_close(uint16_t code) {
+    char payload[2] = {static_cast<char>(code >> 8), static_cast<char>(code & 0xFF)};
+    queue_frame(std::string_view(payload, sizeof(payload)), 0x08);
+}
+
+void WsConnection::protocol_error(uint16_t code, const std::string& reason) {
+    if (state_ == State::OPEN) {
+        queue_close(code);
+        if (state_ != State::OPEN) return;
+    }
+    fail(reason);
+}
+
+WsConnectionStats WsConnection::stats() const {
+    WsConnectionStats s;
+    s.messages_received = messages_received_.load();
+    s.frames_received = frames_received_.load();
+    s.bytes_received = bytes_received_.load();
+    s.fragmented_messages = fragmented_messages_.load();
+    s.pings_received = pings_received_.load();
+    s.connects = connects_.load();
+    s.disconnects = disconnects_.load();
+    s.tls_resumptions = tls_resumptions_.load();
+    s.kernel_stamped_reads = kernel_stamped_reads_.load();
+    s.feed_gaps = feed_gaps_.load();
+    s.last_feed_gap_us = last_feed_gap_us_.load();
+    s.max_feed_gap_us = max_feed_gap_us_.load();
+    return s;
+}
+
+void WsConnection::fail(const std::string& reason) {
+    bool was_open = state_ == State::OPEN;
+    if (was_open) {
+        disconnects_++;
+        if (dropped_at_ == Timestamp{}) dropped_at_ = now();
+    }
+    // The cached address may have moved; resolve afresh on the next attempt
+    if (state_ == State::CONNECTING) {
+        ResolverCache::instance().invalidate(endpoint_.host, endpoint_.port);
+    }
+    teardown();
+    if (!wanted_) return;
+
+    spdlog::warn("{}: {}", name_, reason);
+    set_status(ConnectionStatus::RECONNECTING);
+
+    // A drop after a good session reconnects at once; failed attempts and
+    // sessions that die young back off
+    if (was_open && now() - opened_at_ >= MIN_STABLE_SESSION) {
+        attempts_ = 0;
+        state_ = State::BACKOFF;
+        backoff_timer_ = loop_.run_after(std::chrono::milliseconds(0), [this] {
+            backoff_timer_ = 0;
+            begin_connect();
+        });
+        return;
+    }
+
+    attempts_++;
+    if (attempts_ > max_reconnect_attempts_) {
+        spdlog::error("{}: max reconnect attempts reached", name_);
+        wanted_ = false;
+        dropped_at_ = Timestamp{};
+        set_status(ConnectionStatus::ERROR);
+        if (on_error_) on_error_("Max reconnect attempts reached");
+        return;
+    }
+
+    // The first retry goes at once (a stale address was just dropped above);
+    // only repeated failures back off
+    int delay = attempts_ == 1 ? 0 : reconnect_delay_ms_ * (1 << std::min(attempts_ - 2, 5));
+    spdlog::info("{}: reconnecting in {}ms (attempt {})", name_, delay, attempts_);
+    state_ = State::BACKOFF;
+    backoff_timer_ = loop_.run_after(std::chrono::milliseconds(delay), [this] {
+        backoff_timer_ = 0;
+        begin_connect();
+    });
+}
+
+void WsConnection::teardown() {
+    generation_++;
+    if (backoff_timer_) {
+        loop_.cancel_timer(backoff_timer_);
+        backoff_timer_ = 0;
+    }
+    if (fd_ >= 0) {
+        loop_.remove(fd_);
+    }
+    if (ssl_) {
+        // Non-blocking: sends our close_notify if the socket takes it, never waits
+        SSL_shutdown(ssl_);
+        SSL_free(ssl_);
+        ssl_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+    fd_stamped_ = false;
+    kernel_rx_ns_ = 0;
+    armed_events_ = 0;
+    upgrade_.clear();
+    rx_.clear();
+    messages_.clear();
+    tx_queue_.clear();
+    tx_offset_ = 0;
+    {
+        // Frames meant for the session that just ended
+        std::lock_guard<std::mutex> lock(outbox_mutex_);
+        outbox_.clear();
+    }
+    state_ = State::IDLE;
+}
+
+} // namespace arb
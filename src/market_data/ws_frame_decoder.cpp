@@ -0,0 +1,231 @@
+#include "market_data/ws_frame_decoder.hpp"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace arb {
+
+namespace {
+    size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+}
+
+WsFrameDecoder::WsFrameDecoder(size_t initial_capacity, uint64_t max_payload)
+    : buf_(round_up_pow2(std::max<size_t>(initial_capacity, 16)))
+    , mask_(buf_.size() - 1)
+    , max_payload_(max_payload)
+{
+}
+
+WsFrameDecoder::Space WsFrameDecoder::write_space() {
+    if (size_ == buf_.size()) {
+        grow(buf_.size() * 2);
+    }
+    size_t tail = (head_ + size_) & mask_;
+    size_t contiguous = std::min(buf_.size() - size_, buf_.size() - tail);
+    return Space{buf_.data() + tail, contiguous};
+}
+
+void WsFrameDecoder::commit(size_t n) {
+    size_ += n;
+}
+
+void WsFrameDecoder::append(std::string_view data) {
+    while (!data.empty()) {
+        Space space = write_space();
+        size_t n = std::min(space.size, data.size());
+        std::memcpy(space.data, data.data(), n);
+        commit(n);
+        data.remove_prefix(n);
+    }
+}
+
+void WsFrameDecoder::clear() {
+    head_ = 0;
+    size_ = 0;
+    error_.clear();
+}
+
+void WsFrameDecoder::grow(size_t min_capacity) {
+    std::vector<char> bigger(round_up_pow2(min_capacity));
+    size_t first = std::min(size_, buf_.size() - head_);
+    std::memcpy(bigger.data(), buf_.data() + head_, first);
+    std::memcpy(bigger.data() + first, buf_.data(), size_ - first);
+    buf_.swap(bigger);
+    mask_ = buf_.size() - 1;
+    head_ = 0;
+}
+
+WsFrameDecoder::Result WsFrameDecoder::next(WsFrame& frame) {
+    if (!error_.empty()) return Result::ERROR;
+    if (size_ < 2) return Result::NEED_MORE;
+
+    uint8_t b0 = byte_at(0);
+    uint8_t b1 = byte_at(1);
+    bool masked = (b1 & 0x80) != 0;
+    uint64_t payload_len = b1 & 0x7F;
+    size_t header_len = 2;
+
+    if (payload_len == 126) {
+        if (size_ < 4) return Result::NEED_MORE;
+        payload_len = (static_cast<uint64_t>(byte_at(2)) << 8) | byte_at(3);
+        header_len = 4;
+    } else if (payload_len == 127) {
+        if (size_ < 10) return Result::NEED_MORE;
+        payload_len = 0;
+        for (size_t i = 0; i < 8; i++) {
+            payload_len = (payload_len << 8) | byte_at(2 + i);
+        }
+        header_len = 10;
+    }
+    if (payload_len > max_payload_) {
+        error_ = "frame too large: " + std::to_string(payload_len);
+        return Result::ERROR;
+    }
+
+    size_t mask_offset = header_len;
+    if (masked) header_len += 4;
+
+    size_t total = header_len + static_cast<size_t>(payload_len);
+    if (total > buf_.size()) {
+        grow(total);
+        return Result::NEED_MORE;
+    }
+    if (size_ < total) return Result::NEED_MORE;
+
+    size_t len = static_cast<size_t>(payload_len);
+    size_t start = (head_ + header_len) & mask_;
+    char* payload;
+    if (start + len <= buf_.size()) {
+        payload = buf_.data() + start;
+    } else {
+        size_t first = buf_.size() - start;
+        scratch_.resize(len);
+        std::memcpy(scratch_.data(), buf_.data() + start, first);
+        std::memcpy(scratch_.data() + first, buf_.data(), len - first);
+        payload = scratch_.data();
+        wrapped_frames_++;
+    }
+
+    if (masked) {
+        uint8_t key[4] = {byte_at(mask_offset), byte_at(mask_offset + 1),
+                          byte_at(mask_offset + 2), byte_at(mask_offset + 3)};
+        for (size_t i = 0; i < len; i++) {
+            payload[i] ^= key[i & 3];
+        }
+    }
+
+    frame.opcode = b0 & 0x0F;
+    frame.fin = (b0 & 0x80) != 0;
+    frame.rsv = (b0 >> 4) & 0x07;
+    frame.payload = std::string_view(payload, len);
+
+    // The bytes stay intact until the next write, so the view outlives this
+    head_ = (head_ + total) & mask_;
+    size_ -= total;
+    if (size_ == 0) head_ = 0;  // Empty: restart at the front for a full contiguous read
+    return Result::FRAME;
+}
+
+WsMessageAssembler::WsMessageAssembler(size_t max_message)
+    : max_message_(max_message)
+{
+}
+
+void WsMessageAssembler::clear() {
+    fragments_.clear();
+    fragment_opcode_ = 0;
+    payload_ = {};
+}
+
+bool WsMessageAssembler::valid_close_code(uint16_t code) {
+    // 1004-1006 and 1015 are reserved and never sent; 3000-4999 belong to
+    // libraries and applications
+    if (code >= 1000 && code <= 1003) return true;
+    if (code >= 1007 && code <= 1014) return true;
+    return code >= 3000 && code <= 4999;
+}
+
+WsMessageAssembler::Action WsMessageAssembler::fail(uint16_t code, std::string reason) {
+    close_code_ = code;
+    error_ = std::move(reason);
+    return Action::ERROR;
+}
+
+WsMessageAssembler::Action WsMessageAssembler::on_frame(const WsFrame& frame) {
+    payload_ = {};
+    fragmented_ = false;
+
+    if (frame.rsv != 0) {
+        return fail(WS_CLOSE_PROTOCOL_ERROR, "reserved bits set without an extension");
+    }
+
+    if (frame.opcode >= 0x08) {
+        // Control frames may interleave with fragments but are never fragmented
+        if (!frame.fin || frame.payload.size() > 125) {
+            return fail(WS_CLOSE_PROTOCOL_ERROR, "invalid control frame");
+        }
+        switch (frame.opcode) {
+            case 0x08:
+                if (frame.payload.empty()) {
+                    close_code_ = 0;
+                    return Action::CLOSE;
+                }
+                if (frame.payload.size() == 1) {
+                    return fail(WS_CLOSE_PROTOCOL_ERROR, "close frame with a one-byte payload");
+                }
+                close_code_ = static_cast<uint16_t>(
+                    (static_cast<uint8_t>(frame.payload[0]) << 8) | static_cast<uint8_t>(frame.payload[1]));
+                payload_ = frame.payload.substr(2);
+                // Echo the peer's code unless it may not appear on the wire
+                if (!valid_close_code(close_code_)) close_code_ = WS_CLOSE_PROTOCOL_ERROR;
+                return Action::CLOSE;
+            case 0x09:
+                payload_ = frame.payload;
+                return Action::PING;
+            case 0x0A:
+                return Action::NONE;  // Pong - ignore
+            default:
+                return fail(WS_CLOSE_PROTOCOL_ERROR, "unknown control opcode " + std::to_string(frame.opcode));
+        }
+    }
+
+    if (frame.opcode == 0x00) {
+        if (fragment_opcode_ == 0) {
+            return fail(WS_CLOSE_PROTOCOL_ERROR, "continuation frame without a message");
+        }
+        if (fragments_.size() + frame.payload.size() > max_message_) {
+            return fail(WS_CLOSE_TOO_BIG, "fragmented message too large");
+        }
+        fragments_.append(frame.payload);
+        if (!frame.fin) return Action::NONE;
+
+        fragment_opcode_ = 0;
+        fragmented_ = true;
+        payload_ = fragments_;
+        return Action::MESSAGE;
+    }
+
+    if (frame.opcode != 0x01 && frame.opcode != 0x02) {
+        return fail(WS_CLOSE_PROTOCOL_ERROR, "unknown opcode " + std::to_string(frame.opcode));
+    }
+    if (fragment_opcode_ != 0) {
+        return fail(WS_CLOSE_PROTOCOL_ERROR, "data frame inside a fragmented message");
+    }
+    if (frame.payload.size() > max_message_) {
+        return fail(WS_CLOSE_TOO_BIG, "message too large");
+    }
+    if (!frame.fin) {
+        fragment_opcode_ = frame.opcode;
+        fragments_.assign(frame.payload);
+        return Action::NONE;
+    }
+
+    payload_ = frame.payload;
+    return Action::MESSAGE;
+}
+
+} // namespace arb
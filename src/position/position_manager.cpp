@@ -1,21 +1,26 @@
 #include "position/position_manager.hpp"
+#include "common/symbol_registry.hpp"
 #include <spdlog/spdlog.h>
 
 namespace arb {
 
 void PositionManager::record_fill(const Fill& fill) {
+    TokenHandle token = token_handle_of(fill);
+    MarketHandle market = market_handle_of(fill);
+
     std::lock_guard<std::mutex> lock(mutex_);
 
-    auto it = positions_.find(fill.token_id);
+    auto it = positions_.find(token);
 
     if (it == positions_.end()) {
         // Create new position
         Position pos;
         pos.token_id = fill.token_id;
         pos.market_id = fill.market_id;
+        pos.token_handle = token;
+        pos.market_handle = market;
         pos.first_entry = now();
-        positions_[fill.token_id] = pos;
-        it = positions_.find(fill.token_id);
+        it = positions_.emplace(token, std::move(pos)).first;
     }
 
     Position& pos = it->second;
@@ -68,9 +73,13 @@ void PositionManager::apply_fill_to_position(Position& pos, const Fill& fill) {
 }
 
 void PositionManager::mark_to_market(const std::string& token_id, Price mark_price) {
+    mark_to_market(SymbolRegistry::instance().find_token(token_id), mark_price);
+}
+
+void PositionManager::mark_to_market(TokenHandle token, Price mark_price) {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    auto it = positions_.find(token_id);
+    auto it = positions_.find(token);
     if (it == positions_.end()) return;
 
     Position& pos = it->second;
@@ -84,8 +93,12 @@ void PositionManager::mark_to_market(const std::string& token_id, Price mark_pri
 }
 
 std::optional<Position> PositionManager::get_position(const std::string& token_id) const {
+    return get_position(SymbolRegistry::instance().find_token(token_id));
+}
+
+std::optional<Position> PositionManager::get_position(TokenHandle token) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = positions_.find(token_id);
+    auto it = positions_.find(token);
     if (it != positions_.end()) {
         return it->second;
     }
@@ -113,10 +126,12 @@ std::vector<Position> PositionManager::get_open_positions() const {
 }
 
 std::vector<Position> PositionManager::get_positions_for_market(const std::string& market_id) const {
+    MarketHandle market = SymbolRegistry::instance().find_market(market_id);
     std::lock_guard<std::mutex> lock(mutex_);
     std::vector<Position> result;
+    if (market == NO_SYMBOL) return result;
     for (const auto& [id, pos] : positions_) {
-        if (pos.market_id == market_id) {
+        if (pos.market_handle == market) {
             result.push_back(pos);
         }
     }
@@ -166,11 +181,14 @@ Notional PositionManager::net_exposure() const {
 
 void PositionManager::record_settlement(const std::string& market_id,
                                          const std::string& winning_token_id) {
+    MarketHandle market = SymbolRegistry::instance().find_market(market_id);
+    TokenHandle winner = SymbolRegistry::instance().find_token(winning_token_id);
+
     std::lock_guard<std::mutex> lock(mutex_);
 
-    for (auto& [id, pos] : positions_) {
-        if (pos.market_id == market_id) {
-            if (id == winning_token_id) {
+    for (auto& [token, pos] : positions_) {
+        if (market != NO_SYMBOL && pos.market_handle == market) {
+            if (token == winner) {
                 // Position settles to $1 per share
                 double pnl = pos.size * (1.0 - pos.avg_entry_price) - pos.total_fees;
                 pos.realized_pnl += pnl;
@@ -217,7 +235,10 @@ void PositionManager::restore_from_snapshot(const Snapshot& snapshot) {
 
     positions_.clear();
     for (const auto& pos : snapshot.positions) {
-        positions_[pos.token_id] = pos;
+        Position restored = pos;
+        restored.token_handle = token_handle_of(pos);
+        restored.market_handle = market_handle_of(pos);
+        positions_[restored.token_handle] = restored;
     }
 
     total_realized_pnl_ = snapshot.realized_pnl;
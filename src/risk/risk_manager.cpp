@@ -1,4 +1,5 @@
 #include "risk/risk_manager.hpp"
+#include "common/symbol_registry.hpp"
 #include <spdlog/spdlog.h>
 #include <fmt/format.h>
 #include <algorithm>
@@ -38,7 +39,7 @@ RiskManager::CheckResult RiskManager::check_order(const Signal& signal, Notional
     }
 
     // Check position limit
-    auto pos_check = check_position_limit(signal.market_id);
+    auto pos_check = check_position_limit(market_handle_of(signal));
     if (!pos_check.allowed) {
         return pos_check;
     }
@@ -55,6 +56,10 @@ RiskManager::CheckResult RiskManager::check_order(const Signal& signal, Notional
 }
 
 RiskManager::CheckResult RiskManager::check_position_limit(const std::string& market_id) const {
+    return check_position_limit(SymbolRegistry::instance().find_market(market_id));
+}
+
+RiskManager::CheckResult RiskManager::check_position_limit(MarketHandle market) const {
     CheckResult result;
 
     std::lock_guard<std::mutex> lock(position_mutex_);
@@ -67,13 +72,12 @@ RiskManager::CheckResult RiskManager::check_position_limit(const std::string& ma
     }
 
     // Check exposure per market
-    auto it = market_exposure_.find(market_id);
-    if (it != market_exposure_.end()) {
-        if (it->second >= config_.max_exposure_per_market) {
-            result.reason = fmt::format("Market exposure limit reached for {}: ${:.2f}",
-                                        market_id, config_.max_exposure_per_market);
-            return result;
-        }
+    if (market < market_exposure_.size() &&
+        market_exposure_[market] >= config_.max_exposure_per_market) {
+        result.reason = fmt::format("Market exposure limit reached for {}: ${:.2f}",
+                                    SymbolRegistry::instance().market_name(market),
+                                    config_.max_exposure_per_market);
+        return result;
     }
 
     result.allowed = true;
@@ -97,20 +101,26 @@ void RiskManager::record_fill(const Fill& fill) {
     std::lock_guard<std::mutex> lock(position_mutex_);
 
     // Update market exposure
+    MarketHandle market = market_handle_of(fill);
+    if (market >= market_exposure_.size()) {
+        market_exposure_.resize(market + 1, 0.0);
+    }
+
     double notional = fill.size * fill.price;
+    double& exposure = market_exposure_[market];
     if (fill.side == Side::BUY) {
-        market_exposure_[fill.market_id] += notional;
+        exposure += notional;
         open_positions_++;
     } else {
-        market_exposure_[fill.market_id] -= notional;
-        if (market_exposure_[fill.market_id] <= 0) {
-            market_exposure_.erase(fill.market_id);
+        exposure -= notional;
+        if (exposure <= 0) {
+            exposure = 0.0;
             open_positions_ = std::max(0, open_positions_ - 1);
         }
     }
 
     spdlog::debug("Position update: market={}, exposure=${:.2f}, open_positions={}",
-                  fill.market_id, market_exposure_[fill.market_id], open_positions_);
+                  fill.market_id, exposure, open_positions_);
 }
 
 void RiskManager::record_pnl(double realized_pnl) {
@@ -132,16 +142,19 @@ void RiskManager::record_pnl(double realized_pnl) {
 double RiskManager::current_exposure() const {
     std::lock_guard<std::mutex> lock(position_mutex_);
     double total = 0.0;
-    for (const auto& [market, exposure] : market_exposure_) {
+    for (double exposure : market_exposure_) {
         total += exposure;
     }
     return total;
 }
 
 double RiskManager::exposure_for_market(const std::string& market_id) const {
+    return exposure_for_market(SymbolRegistry::instance().find_market(market_id));
+}
+
+double RiskManager::exposure_for_market(MarketHandle market) const {
     std::lock_guard<std::mutex> lock(position_mutex_);
-    auto it = market_exposure_.find(market_id);
-    return (it != market_exposure_.end()) ? it->second : 0.0;
+    return market < market_exposure_.size() ? market_exposure_[market] : 0.0;
 }
 
 int RiskManager::open_position_count() const {
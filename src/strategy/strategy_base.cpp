@@ -1,4 +1,5 @@
 #include "strategy/strategy_base.hpp"
+#include "common/fixed_point.hpp"
 #include <spdlog/spdlog.h>
 #include <fmt/format.h>
 #include <cmath>
@@ -26,7 +27,8 @@ double UnderpricingStrategy::calculate_position_fee(double price) {
     // fee = price * (1 - price) * FEE_RATE
     // Maximum fee at price = $0.50 (~$0.0156 per share)
     // Zero fee at extremes ($0.01 and $0.99)
-    return price * (1.0 - price) * POLYMARKET_FEE_RATE;
+    // Evaluated on the integer price grid so replays reproduce it exactly
+    return fixed_fee_per_share(price, POLYMARKET_PRICE_SCALE);
 }
 
 double UnderpricingStrategy::calculate_edge(double yes_ask, double no_ask, double /* fee_rate_bps - unused */) const {
@@ -37,26 +39,27 @@ double UnderpricingStrategy::calculate_edge(double yes_ask, double no_ask, doubl
     // CORRECT FEE CALCULATION (Polymarket parabolic formula):
     // Fee is charged per position based on: price * (1 - price) * 6.24%
     // We pay fees on BOTH the YES and NO positions!
-
-    double total_cost = yes_ask + no_ask;
-    double payout = 1.0;
-
-    // Calculate fees for both positions
-    double yes_fee = calculate_position_fee(yes_ask);
-    double no_fee = calculate_position_fee(no_ask);
-    double total_fees = yes_fee + no_fee;
-
-    // Net edge = payout - cost - fees
-    double edge = payout - total_cost - total_fees;
-
-    // Convert to cents (multiply by 100)
-    return edge * 100.0;
+    //
+    // Net edge = payout (1.0) - cost - fees, computed exactly in integer ticks
+    // and converted to cents once, so the same prices always give the same bits.
+    return fixed_pair_edge_cents(POLYMARKET_PRICE_SCALE.to_ticks(yes_ask),
+                                 POLYMARKET_PRICE_SCALE.to_ticks(no_ask),
+                                 POLYMARKET_PRICE_SCALE);
 }
 
 bool UnderpricingStrategy::is_profitable(double edge_cents) const {
     return edge_cents >= config_.min_edge_cents;
 }
 
+bool UnderpricingStrategy::prefilter(const MarketTable& table,
+                                     std::vector<MarketHandle>& candidates) const {
+    if (!enabled_) return false;
+
+    // Same best-ask edge as calculate_edge(); evaluate() re-checks spreads and sizes
+    table.scan_underpriced(POLYMARKET_FEE_RATE_PPM, config_.min_edge_cents, candidates);
+    return true;
+}
+
 std::vector<Signal> UnderpricingStrategy::evaluate(
     const BinaryMarketBook& book,
     const BtcPrice& btc_price,
@@ -66,25 +69,26 @@ std::vector<Signal> UnderpricingStrategy::evaluate(
 
     if (!enabled_) return signals;
 
+    // Both legs from one instant, no book locks
+    BinaryBookSnapshot snap = book.snapshot();
+
     // Check if we have liquidity on both sides
-    if (!book.has_liquidity()) {
+    if (!snap.has_liquidity()) {
         return signals;
     }
 
-    auto yes_ask = book.yes_book().best_ask();
-    auto no_ask = book.no_book().best_ask();
-
-    if (!yes_ask || !no_ask) return signals;
+    const PriceLevel& yes_ask = snap.yes.asks[0];
+    const PriceLevel& no_ask = snap.no.asks[0];
 
     // Calculate edge with correct parabolic fee formula
-    double edge_cents = calculate_edge(yes_ask->price, no_ask->price, 0 /* unused */);
-    double yes_fee = calculate_position_fee(yes_ask->price);
-    double no_fee = calculate_position_fee(no_ask->price);
+    double edge_cents = calculate_edge(yes_ask.price, no_ask.price, 0 /* unused */);
+    double yes_fee = calculate_position_fee(yes_ask.price);
+    double no_fee = calculate_position_fee(no_ask.price);
     double total_fees = yes_fee + no_fee;
 
     // Check spread constraints
-    double yes_spread = book.yes_book().spread();
-    double no_spread = book.no_book().spread();
+    double yes_spread = snap.yes.spread();
+    double no_spread = snap.no.spread();
 
     if (yes_spread > config_.max_spread_to_trade || no_spread > config_.max_spread_to_trade) {
         spdlog::debug("S2: Spread too wide - YES: {:.4f}, NO: {:.4f}", yes_spread, no_spread);
@@ -92,32 +96,42 @@ std::vector<Signal> UnderpricingStrategy::evaluate(
     }
 
     if (is_profitable(edge_cents)) {
-        // Determine size based on available liquidity
-        Size max_size = std::min(yes_ask->size, no_ask->size);
+        // Walk both ask ladders for the largest size whose marginal edge
+        // still clears min_edge_cents, not just the best-level size
+        PairedSweep sweep = snap.paired_ask_sweep(POLYMARKET_FEE_RATE_PPM, config_.min_edge_cents);
+        if (sweep.size <= 0.0) return signals;
+        Size max_size = sweep.size;
+        double avg_edge_cents = sweep.avg_edge_cents();
 
         // Create signals for both sides
         Signal yes_signal;
         yes_signal.strategy_name = name_;
         yes_signal.market_id = book.market_id();
-        yes_signal.token_id = book.yes_book().symbol();
+        yes_signal.market_handle = book.market_handle();
+        yes_signal.token_id = book.yes_token_id();
+        yes_signal.token_handle = book.yes_token();
         yes_signal.side = Side::BUY;
-        yes_signal.target_price = yes_ask->price;
+        yes_signal.target_price = sweep.yes_worst_price;
         yes_signal.target_size = max_size;
-        yes_signal.expected_edge = edge_cents;
+        yes_signal.expected_edge = avg_edge_cents;
         yes_signal.confidence = std::min(1.0, edge_cents / 10.0);  // Higher edge = higher confidence
         yes_signal.generated_at = now_time;
-        yes_signal.reason = fmt::format("YES={:.2f}+NO={:.2f}={:.4f}, fees={:.4f}, edge={:.2f}c",
-                                        yes_ask->price, no_ask->price,
-                                        yes_ask->price + no_ask->price, total_fees, edge_cents);
+        yes_signal.reason = fmt::format("YES={:.2f}+NO={:.2f}={:.4f}, fees={:.4f}, edge={:.2f}c, "
+                                        "size={:.2f} over {}+{} levels, avg edge={:.2f}c",
+                                        yes_ask.price, no_ask.price,
+                                        yes_ask.price + no_ask.price, total_fees, edge_cents,
+                                        max_size, sweep.yes_levels, sweep.no_levels, avg_edge_cents);
 
         Signal no_signal;
         no_signal.strategy_name = name_;
         no_signal.market_id = book.market_id();
-        no_signal.token_id = book.no_book().symbol();
+        no_signal.market_handle = book.market_handle();
+        no_signal.token_id = book.no_token_id();
+        no_signal.token_handle = book.no_token();
         no_signal.side = Side::BUY;
-        no_signal.target_price = no_ask->price;
+        no_signal.target_price = sweep.no_worst_price;
         no_signal.target_size = max_size;
-        no_signal.expected_edge = edge_cents;
+        no_signal.expected_edge = avg_edge_cents;
         no_signal.confidence = yes_signal.confidence;
         no_signal.generated_at = now_time;
         no_signal.reason = yes_signal.reason;
@@ -223,16 +237,14 @@ std::vector<Signal> StaleOddsStrategy::evaluate(
         return signals;
     }
 
-    if (!book.has_liquidity()) {
+    BinaryBookSnapshot snap = book.snapshot(1);
+
+    if (!snap.has_liquidity()) {
         return signals;
     }
 
-    auto yes_ask = book.yes_book().best_ask();
-    auto no_ask = book.no_book().best_ask();
-    auto yes_bid = book.yes_book().best_bid();
-    auto no_bid = book.no_book().best_bid();
-
-    if (!yes_ask || !no_ask || !yes_bid || !no_bid) return signals;
+    const PriceLevel& yes_ask = snap.yes.asks[0];
+    const PriceLevel& no_ask = snap.no.asks[0];
 
     // Detect BTC move
     double btc_move_bps = detect_btc_move_bps();
@@ -243,7 +255,7 @@ std::vector<Signal> StaleOddsStrategy::evaluate(
     }
 
     // Calculate implied vs expected probability
-    double current_implied_yes = calculate_implied_prob(yes_ask->price, no_ask->price);
+    double current_implied_yes = calculate_implied_prob(yes_ask.price, no_ask.price);
     double expected_yes = calculate_expected_prob(btc_move_bps, current_implied_yes);
 
     double prob_diff = expected_yes - current_implied_yes;
@@ -259,24 +271,27 @@ std::vector<Signal> StaleOddsStrategy::evaluate(
     Signal signal;
     signal.strategy_name = name_;
     signal.market_id = book.market_id();
+    signal.market_handle = book.market_handle();
     signal.generated_at = now_time;
     signal.confidence = std::min(1.0, std::abs(prob_diff) / 0.10);  // Scale to confidence
 
     if (prob_diff > 0.02) {
         // Expected YES probability higher than market implies -> buy YES
-        signal.token_id = book.yes_book().symbol();
+        signal.token_id = book.yes_token_id();
+        signal.token_handle = book.yes_token();
         signal.side = Side::BUY;
-        signal.target_price = yes_ask->price;
-        signal.target_size = yes_ask->size;
+        signal.target_price = yes_ask.price;
+        signal.target_size = yes_ask.size;
         signal.expected_edge = prob_diff * 100.0;  // Convert to cents per dollar
         signal.reason = fmt::format("BTC moved +{:.1f}bps, market stale. Expected YES={:.2f}, Implied={:.2f}",
                                     btc_move_bps, expected_yes, current_implied_yes);
     } else if (prob_diff < -0.02) {
         // Expected YES probability lower than market implies -> buy NO
-        signal.token_id = book.no_book().symbol();
+        signal.token_id = book.no_token_id();
+        signal.token_handle = book.no_token();
         signal.side = Side::BUY;
-        signal.target_price = no_ask->price;
-        signal.target_size = no_ask->size;
+        signal.target_price = no_ask.price;
+        signal.target_size = no_ask.size;
         signal.expected_edge = -prob_diff * 100.0;
         signal.reason = fmt::format("BTC moved {:.1f}bps, market stale. Expected NO higher, Implied YES={:.2f}",
                                     btc_move_bps, current_implied_yes);
@@ -353,7 +368,9 @@ std::vector<Signal> MarketMakingStrategy::evaluate(
     Signal bid_signal;
     bid_signal.strategy_name = name_;
     bid_signal.market_id = book.market_id();
-    bid_signal.token_id = book.yes_book().symbol();
+    bid_signal.market_handle = book.market_handle();
+    bid_signal.token_id = book.yes_token_id();
+    bid_signal.token_handle = book.yes_token();
     bid_signal.side = Side::BUY;
     bid_signal.target_price = bid_price;
     bid_signal.target_size = 1.0;  // Minimum size
@@ -366,7 +383,9 @@ std::vector<Signal> MarketMakingStrategy::evaluate(
     Signal ask_signal;
     ask_signal.strategy_name = name_;
     ask_signal.market_id = book.market_id();
-    ask_signal.token_id = book.yes_book().symbol();
+    ask_signal.market_handle = book.market_handle();
+    ask_signal.token_id = book.yes_token_id();
+    ask_signal.token_handle = book.yes_token();
     ask_signal.side = Side::SELL;
     ask_signal.target_price = ask_price;
     ask_signal.target_size = 1.0;
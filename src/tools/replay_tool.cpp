@@ -5,6 +5,7 @@
 #include <spdlog/spdlog.h>
 
 #include "common/types.hpp"
+#include "common/fixed_point.hpp"
 #include "config/config.hpp"
 #include "market_data/order_book.hpp"
 #include "strategy/strategy_base.hpp"
@@ -30,7 +31,7 @@ struct ReplayStats {
 };
 
 void run_replay(const std::string& input_file, const std::string& strategy_name,
-                const StrategyConfig& config, bool verbose) {
+                const StrategyConfig& config, const ConnectionConfig& conn_config, bool verbose) {
     spdlog::info("Starting replay from: {}", input_file);
 
     // Create strategy
@@ -50,6 +51,11 @@ void run_replay(const std::string& input_file, const std::string& strategy_name,
     BtcPrice btc_price;
     ReplayStats stats;
 
+    // Same grid the live feed parses onto, so replays match it bit-for-bit
+    auto book_price = [&](Price p) {
+        return conn_config.fixed_point_prices ? POLYMARKET_PRICE_SCALE.snap(p) : p;
+    };
+
     // Read and process file
     std::ifstream file(input_file);
     if (!file.is_open()) {
@@ -73,7 +79,8 @@ void run_replay(const std::string& input_file, const std::string& strategy_name,
                 btc_price.mid = (btc_price.bid + btc_price.ask) / 2.0;
                 btc_price.timestamp = now();
             }
-            else if (event_type == "book" || event_type == "polymarket") {
+            else if (event_type == "book" || event_type == "polymarket" ||
+                     event_type == "price_change") {
                 // Update order book
                 std::string market_id = j.value("market_id", j.value("condition_id", ""));
                 std::string asset_id = j.value("asset_id", j.value("token_id", ""));
@@ -82,7 +89,9 @@ void run_replay(const std::string& input_file, const std::string& strategy_name,
 
                 // Create book if needed
                 if (books.find(market_id) == books.end()) {
-                    books[market_id] = std::make_unique<BinaryMarketBook>(market_id);
+                    books[market_id] = std::make_unique<BinaryMarketBook>(
+                        market_id, order_book_impl_from_string(conn_config.order_book_impl),
+                        conn_config.price_tick_size);
                 }
 
                 BinaryMarketBook* book = books[market_id].get();
@@ -93,31 +102,49 @@ void run_replay(const std::string& input_file, const std::string& strategy_name,
 
                 OrderBook* target = is_yes ? &book->yes_book() : &book->no_book();
 
-                // Apply updates
-                std::vector<PriceLevel> bids, asks;
-
-                if (j.contains("bids")) {
-                    for (const auto& bid : j["bids"]) {
-                        PriceLevel level;
-                        level.price = bid.value("price", 0.0);
-                        level.size = bid.value("size", 0.0);
-                        if (level.price > 0) bids.push_back(level);
+                bool top_moved = true;
+
+                if (event_type == "price_change") {
+                    // Incremental update: {"changes": [{"side", "price", "size"}]}
+                    std::vector<LevelDelta> deltas;
+                    if (j.contains("changes")) {
+                        for (const auto& change : j["changes"]) {
+                            LevelDelta delta;
+                            std::string side = change.value("side", "");
+                            delta.side = (side == "BUY" || side == "buy") ? Side::BUY : Side::SELL;
+                            delta.price = book_price(change.value("price", 0.0));
+                            delta.size = change.value("size", 0.0);
+                            if (delta.price > 0) deltas.push_back(delta);
+                        }
+                    }
+                    top_moved = target->apply_deltas(deltas).top_changed();
+                } else {
+                    // Apply updates
+                    std::vector<PriceLevel> bids, asks;
+
+                    if (j.contains("bids")) {
+                        for (const auto& bid : j["bids"]) {
+                            PriceLevel level;
+                            level.price = book_price(bid.value("price", 0.0));
+                            level.size = bid.value("size", 0.0);
+                            if (level.price > 0) bids.push_back(level);
+                        }
                     }
-                }
 
-                if (j.contains("asks")) {
-                    for (const auto& ask : j["asks"]) {
-                        PriceLevel level;
-                        level.price = ask.value("price", 0.0);
-                        level.size = ask.value("size", 0.0);
-                        if (level.price > 0) asks.push_back(level);
+                    if (j.contains("asks")) {
+                        for (const auto& ask : j["asks"]) {
+                            PriceLevel level;
+                            level.price = book_price(ask.value("price", 0.0));
+                            level.size = ask.value("size", 0.0);
+                            if (level.price > 0) asks.push_back(level);
+                        }
                     }
-                }
 
-                target->apply_snapshot(bids, asks);
+                    target->apply_snapshot(bids, asks);
+                }
 
-                // Evaluate strategy
-                if (book->has_liquidity()) {
+                // Evaluate strategy (deltas that left the top untouched can't create a signal)
+                if (top_moved && book->has_liquidity()) {
                     auto signals = strategy->evaluate(*book, btc_price, now());
 
                     for (const auto& signal : signals) {
@@ -230,7 +257,7 @@ int main(int argc, char* argv[]) {
     }
 
     // Run replay
-    run_replay(input_file, strategy, config.strategy, verbose);
+    run_replay(input_file, strategy, config.strategy, config.connection, verbose);
 
     return 0;
 }
@@ -11,8 +11,11 @@ namespace arb {
 LatencyHistogram::LatencyHistogram(const std::string& name, size_t max_samples)
     : name_(name)
     , max_samples_(max_samples)
+    , samples_ns_(std::make_unique<std::atomic<int64_t>[]>(max_samples))
 {
-    samples_ns_.reserve(max_samples);
+    for (size_t i = 0; i < max_samples_; ++i) {
+        samples_ns_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+    }
 }
 
 void LatencyHistogram::record(Duration d) {
@@ -20,66 +23,70 @@ void LatencyHistogram::record(Duration d) {
 }
 
 void LatencyHistogram::record_ns(int64_t ns) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    if (max_samples_ == 0) return;
 
-    samples_ns_.push_back(ns);
-    count_++;
+    // Once full, each claim overwrites the oldest sample in place
+    uint64_t slot = next_.fetch_add(1, std::memory_order_relaxed) % max_samples_;
+    samples_ns_[slot].store(ns, std::memory_order_relaxed);
+}
 
-    // Trim if over capacity
-    if (samples_ns_.size() > max_samples_) {
-        samples_ns_.erase(samples_ns_.begin());
+std::vector<int64_t> LatencyHistogram::samples() const {
+    std::vector<int64_t> out;
+    out.reserve(max_samples_);
+    for (size_t i = 0; i < max_samples_; ++i) {
+        int64_t ns = samples_ns_[i].load(std::memory_order_relaxed);
+        if (ns != EMPTY_SLOT) out.push_back(ns);
     }
+    return out;
 }
 
-int64_t LatencyHistogram::percentile(double p) const {
-    // Assumes mutex is held
-    if (samples_ns_.empty()) return 0;
+int64_t LatencyHistogram::percentile(std::vector<int64_t> samples, double p) {
+    if (samples.empty()) return 0;
 
-    std::vector<int64_t> sorted = samples_ns_;
-    std::sort(sorted.begin(), sorted.end());
-
-    size_t idx = static_cast<size_t>((p / 100.0) * (sorted.size() - 1));
-    return sorted[idx];
+    size_t idx = static_cast<size_t>((p / 100.0) * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+    return samples[idx];
 }
 
 Duration LatencyHistogram::p50() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return Duration(percentile(50.0));
+    return Duration(percentile(samples(), 50.0));
 }
 
 Duration LatencyHistogram::p95() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return Duration(percentile(95.0));
+    return Duration(percentile(samples(), 95.0));
 }
 
 Duration LatencyHistogram::p99() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return Duration(percentile(99.0));
+    return Duration(percentile(samples(), 99.0));
 }
 
 Duration LatencyHistogram::min() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (samples_ns_.empty()) return Duration::zero();
-    return Duration(*std::min_element(samples_ns_.begin(), samples_ns_.end()));
+    std::vector<int64_t> s = samples();
+    if (s.empty()) return Duration::zero();
+    return Duration(*std::min_element(s.begin(), s.end()));
 }
 
 Duration LatencyHistogram::max() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (samples_ns_.empty()) return Duration::zero();
-    return Duration(*std::max_element(samples_ns_.begin(), samples_ns_.end()));
+    std::vector<int64_t> s = samples();
+    if (s.empty()) return Duration::zero();
+    return Duration(*std::max_element(s.begin(), s.end()));
 }
 
 Duration LatencyHistogram::mean() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (samples_ns_.empty()) return Duration::zero();
-    int64_t sum = std::accumulate(samples_ns_.begin(), samples_ns_.end(), 0LL);
-    return Duration(sum / samples_ns_.size());
+    std::vector<int64_t> s = samples();
+    if (s.empty()) return Duration::zero();
+    int64_t sum = std::accumulate(s.begin(), s.end(), 0LL);
+    return Duration(sum / static_cast<int64_t>(s.size()));
 }
 
+// Samples recorded while this runs may survive it
 void LatencyHistogram::reset() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    samples_ns_.clear();
-    count_ = 0;
+    for (size_t i = 0; i < max_samples_; ++i) {
+        samples_ns_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+    }
+    next_.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
 }
 
 std::string LatencyHistogram::summary() const {
@@ -164,6 +171,19 @@ LatencyHistogram& MetricsRegistry::histogram(const std::string& name) {
     return *it->second;
 }
 
+void MetricsRegistry::attach(LatencyHistogram& histogram) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    attached_[histogram.name()] = &histogram;
+}
+
+void MetricsRegistry::detach(const LatencyHistogram& histogram) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = attached_.find(histogram.name());
+    if (it != attached_.end() && it->second == &histogram) {
+        attached_.erase(it);
+    }
+}
+
 std::string MetricsRegistry::to_json() const {
     std::lock_guard<std::mutex> lock(mutex_);
 
@@ -182,13 +202,19 @@ std::string MetricsRegistry::to_json() const {
     j["gauges"] = gauges_json;
 
     nlohmann::json histograms_json;
-    for (const auto& [name, hist] : histograms_) {
+    auto export_histogram = [&](const std::string& name, const LatencyHistogram& hist) {
         nlohmann::json h;
-        h["count"] = hist->count();
-        h["p50_us"] = std::chrono::duration_cast<std::chrono::microseconds>(hist->p50()).count();
-        h["p95_us"] = std::chrono::duration_cast<std::chrono::microseconds>(hist->p95()).count();
-        h["p99_us"] = std::chrono::duration_cast<std::chrono::microseconds>(hist->p99()).count();
+        h["count"] = hist.count();
+        h["p50_us"] = std::chrono::duration_cast<std::chrono::microseconds>(hist.p50()).count();
+        h["p95_us"] = std::chrono::duration_cast<std::chrono::microseconds>(hist.p95()).count();
+        h["p99_us"] = std::chrono::duration_cast<std::chrono::microseconds>(hist.p99()).count();
         histograms_json[name] = h;
+    };
+    for (const auto& [name, hist] : histograms_) {
+        export_histogram(name, *hist);
+    }
+    for (const auto& [name, hist] : attached_) {
+        export_histogram(name, *hist);
     }
     j["histograms"] = histograms_json;
 
@@ -206,6 +232,9 @@ void MetricsRegistry::reset_all() {
     for (auto& [name, hist] : histograms_) {
         hist->reset();
     }
+    for (auto& [name, hist] : attached_) {
+        hist->reset();
+    }
 }
 
 // ScopedLatency implementation
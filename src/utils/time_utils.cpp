@@ -119,6 +119,12 @@ Duration time_to_next_15m() {
     return std::chrono::seconds(secs_to_wait);
 }
 
+WallClock next_15m_boundary(WallClock t) {
+    constexpr auto period = std::chrono::minutes(15);
+    auto since_epoch = t.time_since_epoch();
+    return WallClock(since_epoch - since_epoch % period + period);
+}
+
 Duration time_until(WallClock target) {
     auto now_tp = std::chrono::system_clock::now();
     if (target <= now_tp) {
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace arb::test {
+
+/**
+ * Minimal keep-alive HTTP/1.1 server on 127.0.0.1 for REST client tests.
+ *
+ * One thread per accepted connection; each request goes to the handler,
+ * which may run concurrently for different connections. The default
+ * handler echoes "<METHOD> <target> <body>" with status 200, or 404 for
+ * targets containing "/missing".
+ */
+class LoopbackHttpServer {
+public:
+    struct Request {
+        std::string method;
+        std::string target;   // Path and query
+        std::string headers;  // Raw header block, request line included
+        std::string body;
+    };
+
+    struct Reply {
+        int status{200};
+        std::string body;
+    };
+
+    using Handler = std::function<Reply(const Request&)>;
+
+    explicit LoopbackHttpServer(Handler handler = echo) : handler_(std::move(handler)) {
+        listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        listen(listen_fd_, 16);
+
+        socklen_t len = sizeof(addr);
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+
+        accept_thread_ = std::thread([this] { accept_loop(); });
+    }
+
+    ~LoopbackHttpServer() {
+        shutdown(listen_fd_, SHUT_RDWR);
+        close(listen_fd_);
+        accept_thread_.join();
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int fd : client_fds_) shutdown(fd, SHUT_RDWR);
+        for (auto& t : client_threads_) t.join();
+        for (int fd : client_fds_) close(fd);
+    }
+
+    LoopbackHttpServer(const LoopbackHttpServer&) = delete;
+    LoopbackHttpServer& operator=(const LoopbackHttpServer&) = delete;
+
+    std::string base_url() const { return "http://127.0.0.1:" + std::to_string(port_); }
+    std::string url(const std::string& path) const { return base_url() + path; }
+
+    int accepted() const { return accepted_.load(); }
+    int requests() const { return requests_.load(); }
+    std::string last_header_block() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return last_headers_;
+    }
+
+    static Reply echo(const Request& req) {
+        int status = req.target.find("/missing") != std::string::npos ? 404 : 200;
+        return {status, req.method + " " + req.target + " " + req.body};
+    }
+
+private:
+    Handler handler_;
+    int listen_fd_{-1};
+    int port_{0};
+    std::thread accept_thread_;
+    std::atomic<int> accepted_{0};
+    std::atomic<int> requests_{0};
+
+    std::mutex mutex_;
+    std::vector<int> client_fds_;
+    std::vector<std::thread> client_threads_;
+    std::string last_headers_;
+
+    void accept_loop() {
+        while (true) {
+            int fd = accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) return;
+            accepted_++;
+            std::lock_guard<std::mutex> lock(mutex_);
+            client_fds_.push_back(fd);
+            client_threads_.emplace_back([this, fd] { serve(fd); });
+        }
+    }
+
+    void serve(int fd) {
+        std::string buffer;
+        char chunk[4096];
+        while (true) {
+            size_t header_end;
+            while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) return;
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+
+            Request req;
+            req.headers = buffer.substr(0, header_end);
+
+            size_t content_length = 0;
+            auto cl = req.headers.find("Content-Length: ");
+            if (cl != std::string::npos) {
+                content_length = std::strtoul(req.headers.c_str() + cl + 16, nullptr, 10);
+            }
+            while (buffer.size() < header_end + 4 + content_length) {
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) return;
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+            req.body = buffer.substr(header_end + 4, content_length);
+            buffer.erase(0, header_end + 4 + content_length);
+
+            // "GET /path HTTP/1.1"
+            std::string request_line = req.headers.substr(0, req.headers.find("\r\n"));
+            size_t method_end = request_line.find(' ');
+            req.method = request_line.substr(0, method_end);
+            req.target = request_line.substr(method_end + 1, request_line.rfind(' ') - method_end - 1);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                last_headers_ = req.headers;
+            }
+            requests_++;
+
+            Reply reply = handler_(req);
+            std::string response = "HTTP/1.1 " + std::to_string(reply.status) + " X\r\n"
+                                   "Content-Length: " + std::to_string(reply.body.size()) + "\r\n"
+                                   "Connection: keep-alive\r\n\r\n" + reply.body;
+            if (send(fd, response.data(), response.size(), MSG_NOSIGNAL) < 0) return;
+        }
+    }
+};
+
+} // namespace arb::test
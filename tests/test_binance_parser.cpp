@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <random>
+#include <string>
+#include "market_data/binance_parser.hpp"
+
+using namespace arb;
+
+namespace {
+
+bool same_double(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+void expect_same(const BinanceTick& fast, const BinanceTick& json, const std::string& msg) {
+    EXPECT_EQ(fast.kind, json.kind) << msg;
+    EXPECT_EQ(fast.update_id, json.update_id) << msg;
+    EXPECT_EQ(fast.symbol(), json.symbol()) << msg;
+    EXPECT_TRUE(same_double(fast.bid, json.bid)) << msg;
+    EXPECT_TRUE(same_double(fast.bid_qty, json.bid_qty)) << msg;
+    EXPECT_TRUE(same_double(fast.ask, json.ask)) << msg;
+    EXPECT_TRUE(same_double(fast.ask_qty, json.ask_qty)) << msg;
+    EXPECT_TRUE(same_double(fast.price, json.price)) << msg;
+    EXPECT_TRUE(same_double(fast.qty, json.qty)) << msg;
+    EXPECT_EQ(fast.event_time_ms, json.event_time_ms) << msg;
+}
+
+std::string random_decimal(std::mt19937_64& gen) {
+    std::uniform_int_distribution<int> int_digits(1, 7);
+    std::uniform_int_distribution<int> frac_digits(0, 10);
+    std::uniform_int_distribution<int> digit(0, 9);
+    std::string s;
+    int n = int_digits(gen);
+    for (int i = 0; i < n; ++i) s += static_cast<char>('0' + digit(gen));
+    int f = frac_digits(gen);
+    if (f > 0) {
+        s += '.';
+        for (int i = 0; i < f; ++i) s += static_cast<char>('0' + digit(gen));
+    }
+    return s;
+}
+
+}
+
+TEST(BinanceParserTest, ParsesBookTicker) {
+    std::string msg = R"({"u":400900217,"s":"BNBUSDT","b":"25.35190000","B":"31.21000000",)"
+                      R"("a":"25.36520000","A":"40.66000000"})";
+    BinanceTick tick;
+    ASSERT_TRUE(parse_binance_message(msg, nullptr, tick));
+    EXPECT_EQ(tick.kind, BinanceTick::Kind::BOOK_TICKER);
+    EXPECT_EQ(tick.update_id, 400900217);
+    EXPECT_EQ(tick.symbol(), "BNBUSDT");
+    EXPECT_DOUBLE_EQ(tick.bid, 25.3519);
+    EXPECT_DOUBLE_EQ(tick.bid_qty, 31.21);
+    EXPECT_DOUBLE_EQ(tick.ask, 25.3652);
+    EXPECT_DOUBLE_EQ(tick.ask_qty, 40.66);
+    EXPECT_EQ(tick.event_time_ms, 0);
+}
+
+TEST(BinanceParserTest, ParsesTradeWithNumericOrderIds) {
+    // Trade events reuse "b"/"a" for order ids; they must not look like a ticker
+    std::string msg = R"({"e":"trade","E":1672515782136,"s":"BTCUSDT","t":12345,"p":"42000.10",)"
+                      R"("q":"0.015","b":88,"a":50,"T":1672515782136,"m":true,"M":true})";
+    BinanceTick tick;
+    ASSERT_TRUE(parse_binance_message(msg, nullptr, tick));
+    EXPECT_EQ(tick.kind, BinanceTick::Kind::TRADE);
+    EXPECT_EQ(tick.update_id, 12345);
+    EXPECT_EQ(tick.event_time_ms, 1672515782136);
+    EXPECT_DOUBLE_EQ(tick.price, 42000.10);
+    EXPECT_DOUBLE_EQ(tick.qty, 0.015);
+}
+
+TEST(BinanceParserTest, SubscriptionAckIsNotATick) {
+    BinanceTick tick;
+    ASSERT_TRUE(parse_binance_message(R"({"result":null,"id":1})", nullptr, tick));
+    EXPECT_EQ(tick.kind, BinanceTick::Kind::NONE);
+}
+
+TEST(BinanceParserTest, DeclinesWhatOnlyTheDomPathHandles) {
+    BinanceTick tick;
+    // Escaped string, exponent, nested value, truncated frame
+    EXPECT_FALSE(parse_binance_message(R"({"s":"BTC\/USDT","b":"1","a":"2"})", nullptr, tick));
+    EXPECT_FALSE(parse_binance_message(R"({"b":"1e2","a":"2"})", nullptr, tick));
+    EXPECT_FALSE(parse_binance_message(R"({"data":{"b":"1","a":"2"}})", nullptr, tick));
+    EXPECT_FALSE(parse_binance_message(R"({"b":"1","a":"2")", nullptr, tick));
+
+    ASSERT_TRUE(parse_binance_message_json(R"({"s":"BTC\/USDT","b":"1e2","a":"2"})", nullptr, tick));
+    EXPECT_EQ(tick.symbol(), "BTC/USDT");
+    EXPECT_DOUBLE_EQ(tick.bid, 100.0);
+}
+
+TEST(BinanceParserTest, FixedPointScaleSnapsPrices) {
+    FixedScale scale = FixedScale::from_decimals(2);
+    BinanceTick tick;
+    ASSERT_TRUE(parse_binance_message(R"({"b":"42000.104","a":"42000.105"})", &scale, tick));
+    EXPECT_EQ(tick.bid, 42000.10);
+    EXPECT_EQ(tick.ask, 42000.11);
+}
+
+TEST(BinanceParserTest, FuzzMatchesNlohmannPath) {
+    std::mt19937_64 gen(20240611);
+    std::uniform_int_distribution<int> coin(0, 1);
+    std::uniform_int_distribution<int64_t> ids(0, 9'000'000'000'000LL);
+    FixedScale scale = FixedScale::from_decimals(2);
+
+    for (int i = 0; i < 20'000; ++i) {
+        std::string msg;
+        if (coin(gen)) {
+            msg = "{\"u\":" + std::to_string(ids(gen)) + ",\"s\":\"BTCUSDT\"" +
+                  ",\"b\":\"" + random_decimal(gen) + "\",\"B\":\"" + random_decimal(gen) + "\"" +
+                  ",\"a\":\"" + random_decimal(gen) + "\",\"A\":\"" + random_decimal(gen) + "\"";
+            if (coin(gen)) msg += ",\"E\":" + std::to_string(ids(gen));
+            msg += "}";
+        } else {
+            msg = "{\"e\":\"trade\",\"E\":" + std::to_string(ids(gen)) + ",\"s\":\"BTCUSDT\"" +
+                  ",\"t\":" + std::to_string(ids(gen)) +
+                  ",\"p\":\"" + random_decimal(gen) + "\",\"q\":\"" + random_decimal(gen) + "\"" +
+                  ",\"b\":" + std::to_string(ids(gen)) + ",\"a\":" + std::to_string(ids(gen)) +
+                  ",\"T\":" + std::to_string(ids(gen)) + ",\"m\":true,\"M\":false}";
+        }
+        if (coin(gen)) {
+            // Whitespace between tokens must not matter either
+            for (size_t pos = msg.find(','); pos != std::string::npos; pos = msg.find(',', pos + 3)) {
+                msg.replace(pos, 1, " , ");
+            }
+        }
+
+        const FixedScale* use_scale = coin(gen) ? &scale : nullptr;
+        BinanceTick fast;
+        BinanceTick json;
+        ASSERT_TRUE(parse_binance_message(msg, use_scale, fast)) << msg;
+        ASSERT_TRUE(parse_binance_message_json(msg, use_scale, json)) << msg;
+        expect_same(fast, json, msg);
+    }
+}
+
+TEST(BinanceParserTest, DecimalMatchesStod) {
+    std::mt19937_64 gen(7);
+    for (int i = 0; i < 100'000; ++i) {
+        std::string text = random_decimal(gen);
+        double value = 0.0;
+        ASSERT_TRUE(parse_decimal(text, value)) << text;
+        ASSERT_TRUE(same_double(value, std::stod(text))) << text;
+    }
+    // Past 15 significant digits the strtod fallback takes over
+    for (const char* text : {"123456789012345678", "0.12345678901234567890", "99999999999999999.5"}) {
+        double value = 0.0;
+        ASSERT_TRUE(parse_decimal(text, value)) << text;
+        EXPECT_TRUE(same_double(value, std::stod(text))) << text;
+    }
+    double value = 0.0;
+    EXPECT_FALSE(parse_decimal("", value));
+    EXPECT_FALSE(parse_decimal(".", value));
+    EXPECT_FALSE(parse_decimal("1.2.3", value));
+    EXPECT_FALSE(parse_decimal("12345678901234567.8.9", value));
+    EXPECT_FALSE(parse_decimal("1e5", value));
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "common/spsc_ring.hpp"
+#include "market_data/book_handoff.hpp"
+
+using namespace arb;
+using namespace std::chrono_literals;
+
+TEST(SpscRingTest, WrapsAndReportsFull) {
+    SpscRing<int> ring(3);  // Rounded up to 4
+    EXPECT_EQ(ring.capacity(), 4u);
+
+    int out = 0;
+    EXPECT_FALSE(ring.pop(out));
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 4; ++i) EXPECT_TRUE(ring.push(round * 10 + i));
+        EXPECT_FALSE(ring.push(99));
+        EXPECT_EQ(ring.size(), 4u);
+        for (int i = 0; i < 4; ++i) {
+            ASSERT_TRUE(ring.pop(out));
+            EXPECT_EQ(out, round * 10 + i);
+        }
+        EXPECT_FALSE(ring.pop(out));
+    }
+}
+
+TEST(SpscRingTest, CrossThreadOrderIsPreserved) {
+    SpscRing<int> ring(64);
+    constexpr int COUNT = 100000;
+
+    std::thread producer([&] {
+        for (int i = 0; i < COUNT; ++i) {
+            while (!ring.push(i)) std::this_thread::yield();
+        }
+    });
+
+    // A third thread reading size() must never see it wrap past capacity
+    std::atomic<bool> done{false};
+    size_t max_seen = 0;
+    std::thread observer([&] {
+        while (!done.load(std::memory_order_relaxed)) max_seen = std::max(max_seen, ring.size());
+    });
+
+    int expected = 0;
+    int out = 0;
+    while (expected < COUNT) {
+        if (!ring.pop(out)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(out, expected);
+        ++expected;
+    }
+    producer.join();
+    done = true;
+    observer.join();
+    EXPECT_LE(max_seen, ring.capacity());
+}
+
+TEST(BookHandoffTest, BurstsConflateToOneEventPerMarket) {
+    BookHandoff handoff;
+    for (int i = 0; i < 5; ++i) handoff.publish(7);
+    handoff.publish(3);
+    handoff.publish(7);
+
+    std::vector<MarketHandle> changed;
+    EXPECT_FALSE(handoff.drain(changed));
+    EXPECT_EQ(changed, (std::vector<MarketHandle>{3, 7}));
+
+    // Drained markets queue again on their next update
+    changed.clear();
+    handoff.publish(7);
+    EXPECT_FALSE(handoff.drain(changed));
+    EXPECT_EQ(changed, std::vector<MarketHandle>{7});
+
+    BookHandoffStats stats = handoff.stats();
+    EXPECT_EQ(stats.published, 8);
+    EXPECT_EQ(stats.delivered, 3);
+    EXPECT_DOUBLE_EQ(stats.conflation_ratio(), 8.0 / 3.0);
+    EXPECT_EQ(stats.depth, 0u);
+    EXPECT_EQ(stats.max_depth, 2u);
+}
+
+TEST(BookHandoffTest, FullRingFallsBackToAFullPass) {
+    BookHandoff handoff(2);
+    handoff.publish(1);
+    handoff.publish(2);
+    handoff.publish(3);  // No room
+
+    std::vector<MarketHandle> changed;
+    EXPECT_TRUE(handoff.drain(changed));
+    EXPECT_EQ(changed.size(), 2u);
+    EXPECT_EQ(handoff.stats().overflows, 1);
+
+    // The overflowed market was not left marked as queued
+    changed.clear();
+    handoff.publish(3);
+    EXPECT_FALSE(handoff.drain(changed));
+    EXPECT_EQ(changed, std::vector<MarketHandle>{3});
+}
+
+TEST(BookHandoffTest, PublishAllRequestsAFullPass) {
+    BookHandoff handoff;
+    handoff.publish_all();
+    handoff.publish_all();
+
+    std::vector<MarketHandle> changed;
+    EXPECT_TRUE(handoff.drain(changed));
+    EXPECT_FALSE(handoff.drain(changed));
+    EXPECT_EQ(handoff.stats().full_passes, 1);
+}
+
+TEST(BookHandoffTest, PublishWakesTheWaiter) {
+    BookHandoff handoff;
+    EXPECT_FALSE(handoff.wait(1ms));
+
+    std::thread producer([&] {
+        std::this_thread::sleep_for(20ms);
+        handoff.publish(42);
+    });
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(handoff.wait(5s));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 2s);
+    producer.join();
+
+    std::vector<MarketHandle> changed;
+    handoff.drain(changed);
+    EXPECT_EQ(changed, std::vector<MarketHandle>{42});
+}
+
+TEST(BookHandoffTest, EveryProducerThreadIsDrained) {
+    BookHandoff handoff;
+    constexpr MarketHandle MARKETS = 500;
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; ++t) {
+        producers.emplace_back([&, t] {
+            for (MarketHandle m = 1; m <= MARKETS; ++m) {
+                if (m % 4 == static_cast<MarketHandle>(t)) handoff.publish(m);
+            }
+        });
+    }
+    for (auto& p : producers) p.join();
+
+    std::vector<MarketHandle> changed;
+    EXPECT_FALSE(handoff.drain(changed));
+    EXPECT_EQ(changed.size(), MARKETS);
+    EXPECT_TRUE(std::is_sorted(changed.begin(), changed.end()));
+}
+
+TEST(BookHandoffTest, ExitedProducersGiveTheirRingsBack) {
+    BookHandoff handoff;
+
+    // Well over 64 threads in all, like one listing pass per boundary
+    MarketHandle next = 1;
+    for (int round = 0; round < 5; ++round) {
+        std::vector<std::thread> producers;
+        for (int t = 0; t < 40; ++t) {
+            producers.emplace_back([&handoff, m = next++] { handoff.publish(m); });
+        }
+        for (auto& p : producers) p.join();
+
+        std::vector<MarketHandle> changed;
+        EXPECT_FALSE(handoff.drain(changed));
+        ASSERT_EQ(changed.size(), 40u);
+        EXPECT_EQ(changed.front(), next - 40);
+        EXPECT_EQ(changed.back(), next - 1);
+    }
+    EXPECT_EQ(handoff.stats().overflows, 0);
+    EXPECT_EQ(handoff.stats().full_passes, 0);
+}
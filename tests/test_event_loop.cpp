@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstring>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+#include "market_data/event_loop.hpp"
+#include "market_data/resolver_cache.hpp"
+#include "market_data/tls_client_context.hpp"
+#include "market_data/ws_connection.hpp"
+
+using namespace arb;
+using namespace std::chrono_literals;
+
+TEST(EventLoopTest, PostRunsOnLoopThread) {
+    EventLoop loop;
+    loop.start();
+
+    std::promise<bool> ran;
+    loop.post([&] { ran.set_value(loop.in_loop_thread()); });
+    auto result = ran.get_future();
+    ASSERT_EQ(result.wait_for(2s), std::future_status::ready);
+    EXPECT_TRUE(result.get());
+    EXPECT_FALSE(loop.in_loop_thread());
+
+    loop.stop();
+}
+
+TEST(EventLoopTest, TimersFireInDeadlineOrderAndCancel) {
+    EventLoop loop;
+    loop.start();
+
+    std::vector<int> order;
+    std::promise<void> done;
+    loop.run_sync([&] {
+        loop.run_after(30ms, [&] { order.push_back(3); done.set_value(); });
+        loop.run_after(10ms, [&] { order.push_back(1); });
+        auto cancelled = loop.run_after(5ms, [&] { order.push_back(99); });
+        loop.run_after(20ms, [&] { order.push_back(2); });
+        loop.cancel_timer(cancelled);
+    });
+
+    ASSERT_EQ(done.get_future().wait_for(2s), std::future_status::ready);
+    loop.run_sync([&] { EXPECT_EQ(order, (std::vector<int>{1, 2, 3})); });
+
+    loop.stop();
+}
+
+TEST(EventLoopTest, DispatchesReadinessAndAllowsSelfRemoval) {
+    EventLoop loop;
+    loop.start();
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    std::atomic<int> calls{0};
+    std::promise<char> got;
+    loop.run_sync([&] {
+        loop.add(fds[0], EPOLLIN, [&](uint32_t events) {
+            char c = 0;
+            if ((events & EPOLLIN) && read(fds[0], &c, 1) == 1) {
+                calls++;
+                loop.remove(fds[0]);  // Destroys this callback's registration
+                got.set_value(c);
+            }
+        });
+    });
+    EXPECT_EQ(loop.fd_count(), 1u);
+
+    ASSERT_EQ(write(fds[1], "x", 1), 1);
+    auto value = got.get_future();
+    ASSERT_EQ(value.wait_for(2s), std::future_status::ready);
+    EXPECT_EQ(value.get(), 'x');
+
+    // Removed: further writes are not dispatched
+    ASSERT_EQ(write(fds[1], "y", 1), 1);
+    std::this_thread::sleep_for(20ms);
+    loop.run_sync([] {});
+    EXPECT_EQ(calls.load(), 1);
+    EXPECT_EQ(loop.fd_count(), 0u);
+
+    loop.stop();
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(EventLoopTest, RunSyncInlineWhenStopped) {
+    EventLoop loop;
+    bool ran = false;
+    loop.run_sync([&] { ran = true; });
+    EXPECT_TRUE(ran);
+}
+
+TEST(EventLoopTest, RunSyncRacingStopAlwaysRuns) {
+    EventLoop loop;
+    std::atomic<int> ran{0};
+    constexpr int ROUNDS = 200;
+    for (int i = 0; i < ROUNDS; ++i) {
+        loop.start();
+        std::thread caller([&] { loop.run_sync([&] { ran++; }); });
+        loop.stop();
+        caller.join();
+    }
+    EXPECT_EQ(ran.load(), ROUNDS);
+}
+
+TEST(WsConnectionTest, ParsesWebSocketUrls) {
+    WsEndpoint ep;
+    ASSERT_TRUE(parse_ws_url("wss://stream.binance.com:9443/ws/btcusdt@bookTicker", ep));
+    EXPECT_EQ(ep.host, "stream.binance.com");
+    EXPECT_EQ(ep.port, 9443);
+    EXPECT_EQ(ep.path, "/ws/btcusdt@bookTicker");
+    EXPECT_TRUE(ep.tls);
+
+    ASSERT_TRUE(parse_ws_url("wss://ws-subscriptions-clob.polymarket.com/ws/market", ep));
+    EXPECT_EQ(ep.port, 443);
+    EXPECT_EQ(ep.path, "/ws/market");
+
+    ASSERT_TRUE(parse_ws_url("ws://localhost", ep));
+    EXPECT_FALSE(ep.tls);
+    EXPECT_EQ(ep.port, 80);
+    EXPECT_EQ(ep.path, "/");
+
+    EXPECT_FALSE(parse_ws_url("https://example.com/ws", ep));
+    EXPECT_FALSE(parse_ws_url("wss://:443/ws", ep));
+    EXPECT_FALSE(parse_ws_url("wss://host:99999/ws", ep));
+}
+
+TEST(WsConnectionTest, GivesUpAfterMaxReconnectAttempts) {
+    EventLoop loop;
+    loop.start();
+
+    WsConnection conn(loop, "not-a-url", "test");
+    conn.set_reconnect_policy(1, 2);
+
+    std::promise<void> gave_up;
+    std::atomic<int> reconnecting{0};
+    conn.set_status_callback([&](ConnectionStatus s) {
+        if (s == ConnectionStatus::RECONNECTING) reconnecting++;
+    });
+    conn.set_error_callback([&](const std::string&) { gave_up.set_value(); });
+    conn.start();
+
+    ASSERT_EQ(gave_up.get_future().wait_for(2s), std::future_status::ready);
+    EXPECT_EQ(conn.status(), ConnectionStatus::ERROR);
+    EXPECT_EQ(reconnecting.load(), 3);  // Initial attempt + 2 retries
+    EXPECT_FALSE(conn.send_text("{}"));
+
+    conn.stop();
+    loop.stop();
+}
+
+TEST(WsConnectionTest, FirstRetryIsImmediate) {
+    EventLoop loop;
+    loop.start();
+
+    WsConnection conn(loop, "not-a-url", "test");
+    conn.set_reconnect_policy(1000, 1);  // Only the immediate retry fits in the wait below
+
+    std::promise<void> gave_up;
+    conn.set_error_callback([&](const std::string&) { gave_up.set_value(); });
+    conn.start();
+
+    EXPECT_EQ(gave_up.get_future().wait_for(500ms), std::future_status::ready);
+
+    conn.stop();
+    loop.stop();
+}
+
+TEST(ResolverCacheTest, ResolvesOnceThenServesFromMemory) {
+    ResolverCache cache;
+    cache.set_refresh_interval(0ms);
+
+    ResolverCache::Address addr;
+    EXPECT_FALSE(cache.lookup("127.0.0.1", 9443, addr));
+    ASSERT_TRUE(cache.resolve("127.0.0.1", 9443, addr));
+    EXPECT_EQ(addr.addr.ss_family, AF_INET);
+    EXPECT_EQ(ntohs(reinterpret_cast<const sockaddr_in&>(addr.addr).sin_port), 9443);
+
+    ResolverCache::Address cached;
+    ASSERT_TRUE(cache.lookup("127.0.0.1", 9443, cached));
+    EXPECT_EQ(cached.len, addr.len);
+    EXPECT_FALSE(cache.lookup("127.0.0.1", 443, cached));  // Keyed by port too
+    EXPECT_EQ(cache.hits(), 1);
+    EXPECT_EQ(cache.misses(), 2);
+
+    cache.invalidate("127.0.0.1", 9443);
+    EXPECT_FALSE(cache.lookup("127.0.0.1", 9443, cached));
+}
+
+TEST(ResolverCacheTest, IndexPicksAmongResolvedAddresses) {
+    ResolverCache cache;
+    cache.set_refresh_interval(0ms);
+
+    // A literal resolves to one address; every index wraps onto it
+    ResolverCache::Address first, third;
+    ASSERT_TRUE(cache.resolve("127.0.0.1", 443, first, 0));
+    ASSERT_TRUE(cache.lookup("127.0.0.1", 443, third, 2));
+    EXPECT_EQ(first.len, third.len);
+    EXPECT_EQ(std::memcmp(&first.addr, &third.addr, first.len), 0);
+}
+
+TEST(ResolverCacheTest, BackgroundRefreshKeepsEntriesCurrent) {
+    ResolverCache cache;
+    cache.set_refresh_interval(10ms);
+
+    ResolverCache::Address addr;
+    ASSERT_TRUE(cache.resolve("127.0.0.1", 443, addr));
+    auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (cache.refreshes() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(5ms);
+    }
+    EXPECT_GT(cache.refreshes(), 0);
+    EXPECT_TRUE(cache.lookup("127.0.0.1", 443, addr));
+}
+
+TEST(TlsClientContextTest, OneContextPerEndpoint) {
+    TlsClientContext* a = TlsClientContext::for_endpoint("stream.binance.com", 9443);
+    ASSERT_NE(a, nullptr);
+    EXPECT_EQ(TlsClientContext::for_endpoint("stream.binance.com", 9443), a);
+    EXPECT_NE(TlsClientContext::for_endpoint("stream.binance.com", 443), a);
+    EXPECT_FALSE(a->has_session());
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "strategy/strategy_base.hpp"
 #include "config/config.hpp"
+#include "common/fixed_point.hpp"
 
 using namespace arb;
 
@@ -151,3 +152,56 @@ TEST_F(FeeCalculationTest, MinimumUnderpricingForProfit) {
     // This should be close to zero (might be slightly positive or negative)
     EXPECT_LT(std::abs(edge_breakeven), 1.0);  // Within 1 cent of break-even
 }
+
+// ============================================================================
+// Fixed-point prices: exact wire parsing and integer edge math
+// ============================================================================
+
+TEST(FixedPointTest, ParseDecimalExactly) {
+    Ticks ticks = 0;
+    ASSERT_TRUE(parse_fixed("0.455", POLYMARKET_PRICE_SCALE, ticks));
+    EXPECT_EQ(ticks, 4550);
+    ASSERT_TRUE(parse_fixed("42000.1", FixedScale::from_decimals(2), ticks));
+    EXPECT_EQ(ticks, 4200010);
+    ASSERT_TRUE(parse_fixed("-1.5", FixedScale::from_decimals(1), ticks));
+    EXPECT_EQ(ticks, -15);
+    ASSERT_TRUE(parse_fixed(".5", POLYMARKET_PRICE_SCALE, ticks));
+    EXPECT_EQ(ticks, 5000);
+
+    // Digits beyond the scale round half-up
+    ASSERT_TRUE(parse_fixed("0.12345", POLYMARKET_PRICE_SCALE, ticks));
+    EXPECT_EQ(ticks, 1235);
+    ASSERT_TRUE(parse_fixed("0.12344999", POLYMARKET_PRICE_SCALE, ticks));
+    EXPECT_EQ(ticks, 1234);
+
+    EXPECT_FALSE(parse_fixed("", POLYMARKET_PRICE_SCALE, ticks));
+    EXPECT_FALSE(parse_fixed("1e-3", POLYMARKET_PRICE_SCALE, ticks));
+    EXPECT_FALSE(parse_fixed("0.4x", POLYMARKET_PRICE_SCALE, ticks));
+    EXPECT_FALSE(parse_fixed("99999999999999999999", POLYMARKET_PRICE_SCALE, ticks));
+
+    // Overflow through the fractional digits, not the integer part
+    EXPECT_FALSE(parse_fixed("922337203685477580.1234", POLYMARKET_PRICE_SCALE, ticks));
+    EXPECT_FALSE(parse_fixed("-922337203685477580.1", POLYMARKET_PRICE_SCALE, ticks));
+    ASSERT_TRUE(parse_fixed("92233720368547.758", POLYMARKET_PRICE_SCALE, ticks));
+    EXPECT_EQ(ticks, 922337203685477580);
+}
+
+TEST(FixedPointTest, ParsedPriceMatchesLiteral) {
+    Price price = 0.0;
+    ASSERT_TRUE(parse_fixed_price("0.45", POLYMARKET_PRICE_SCALE, price));
+    EXPECT_EQ(price, 0.45);  // Bit-identical to the nearest double
+    ASSERT_TRUE(parse_fixed_price("0.070", POLYMARKET_PRICE_SCALE, price));
+    EXPECT_EQ(price, 0.07);
+}
+
+TEST(FixedPointTest, IntegerEdgeMatchesFormula) {
+    // 0.40 + 0.45: fees 0.014976 + 0.015444, edge 11.958c
+    Ticks yes = POLYMARKET_PRICE_SCALE.to_ticks(0.40);
+    Ticks no = POLYMARKET_PRICE_SCALE.to_ticks(0.45);
+    EXPECT_EQ(fixed_pair_edge(yes, no, POLYMARKET_PRICE_SCALE), 11'958'000'000'000);
+    EXPECT_DOUBLE_EQ(fixed_pair_edge_cents(yes, no, POLYMARKET_PRICE_SCALE), 11.958);
+
+    // Sub-cent noise in the input double lands on the same ticks
+    EXPECT_EQ(POLYMARKET_PRICE_SCALE.to_ticks(0.1 + 0.2), POLYMARKET_PRICE_SCALE.to_ticks(0.3));
+    EXPECT_DOUBLE_EQ(fixed_fee_per_share(0.50, POLYMARKET_PRICE_SCALE), 0.0156);
+}
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <openssl/bio.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "market_data/feed_latency.hpp"
+#include "market_data/rx_timestamp_bio.hpp"
+
+using namespace arb;
+using namespace std::chrono_literals;
+
+namespace {
+    // Connected loopback TCP pair; both -1 on failure
+    void tcp_pair(int& client, int& server) {
+        client = server = -1;
+        int listener = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (bind(listener, reinterpret_cast<sockaddr*>(&addr), len) == 0 && listen(listener, 1) == 0 &&
+            getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len) == 0) {
+            client = socket(AF_INET, SOCK_STREAM, 0);
+            if (connect(client, reinterpret_cast<sockaddr*>(&addr), len) == 0) {
+                server = accept(listener, nullptr, nullptr);
+            }
+        }
+        close(listener);
+    }
+
+    int64_t wall_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(wall_now().time_since_epoch()).count();
+    }
+}
+
+TEST(ClockOffsetEstimatorTest, TracksTheWindowMinimum) {
+    ClockOffsetEstimator offset(60s, 6);
+    Timestamp t0{1000h};  // On an interval boundary
+    EXPECT_FALSE(offset.offset_ns(t0).has_value());
+
+    offset.add(5'000'000, t0);
+    offset.add(3'000'000, t0 + 1s);
+    offset.add(9'000'000, t0 + 2s);
+    EXPECT_EQ(offset.offset_ns(t0 + 2s), 3'000'000);
+
+    // Skew can make the sample negative
+    offset.add(-2'000'000, t0 + 30s);
+    EXPECT_EQ(offset.offset_ns(t0 + 30s), -2'000'000);
+}
+
+TEST(ClockOffsetEstimatorTest, OldSamplesAgeOut) {
+    ClockOffsetEstimator offset(60s, 6);
+    Timestamp t0{1000h};  // On an interval boundary
+
+    offset.add(1'000'000, t0);
+    offset.add(4'000'000, t0 + 50s);
+    EXPECT_EQ(offset.offset_ns(t0 + 55s), 1'000'000);
+    EXPECT_EQ(offset.offset_ns(t0 + 80s), 4'000'000);
+    EXPECT_FALSE(offset.offset_ns(t0 + 200s).has_value());
+}
+
+TEST(RxTimestampBioTest, ReadsCarryTheKernelStamp) {
+    int client = -1, server = -1;
+    tcp_pair(client, server);
+    ASSERT_GE(server, 0);
+    ASSERT_TRUE(enable_rx_timestamps(client));
+
+    int64_t stamp = 0;
+    BIO* bio = new_rx_timestamp_bio(client, &stamp);
+    ASSERT_NE(bio, nullptr);
+
+    // The kernel turns stamping on lazily, so the first packets after the
+    // setsockopt can arrive unstamped
+    int64_t before = 0;
+    for (int attempt = 0; attempt < 100 && stamp == 0; ++attempt) {
+        if (attempt > 0) std::this_thread::sleep_for(1ms);
+        before = wall_ns();
+        ASSERT_EQ(write(server, "hello", 5), 5);
+        char buf[16] = {};
+        ASSERT_EQ(BIO_read(bio, buf, sizeof(buf)), 5);
+        EXPECT_EQ(std::memcmp(buf, "hello", 5), 0);
+    }
+    ASSERT_NE(stamp, 0);
+    EXPECT_GE(stamp, before);
+    EXPECT_LE(stamp, wall_ns());
+    EXPECT_EQ(BIO_get_fd(bio, nullptr), client);
+    BIO_free(bio);
+
+    close(client);
+    close(server);
+}
+
+TEST(RxTimestampBioTest, KernelStampMapsOntoTheSteadyClock) {
+    Timestamp t = now();
+    EXPECT_EQ(steady_from_realtime_ns(wall_ns() + 1'000'000'000, t), t);  // Never in the future
+
+    Timestamp earlier = steady_from_realtime_ns(wall_ns() - 5'000'000, t);
+    EXPECT_LE(earlier, t - 5ms);
+    EXPECT_GT(earlier, t - 1s);
+}
+
+TEST(FeedLatencyTest, SplitsTheMessagePath) {
+    FeedLatency latency("test_feed");
+    Timestamp wire = now();
+    int64_t exchange_ms = wall_ns() / 1'000'000 - 20;
+
+    latency.record(wire, wire + 40us, wire + 50us, exchange_ms);
+    latency.record(wire, wire + 40us, wire + 50us, 0);  // No event time: exchange leg skipped
+
+    EXPECT_EQ(latency.wire_to_parse().count(), 2);
+    EXPECT_EQ(latency.wire_to_parse().p50(), 40us);
+    EXPECT_EQ(latency.parse_to_book().p50(), 10us);
+    EXPECT_EQ(latency.exchange_to_local().count(), 1);
+    EXPECT_GE(latency.exchange_to_local().p50(), 19ms);
+    ASSERT_TRUE(latency.clock_offset_ns().has_value());
+    EXPECT_GE(*latency.clock_offset_ns(), 19'000'000);
+}
+
+TEST(FeedLatencyTest, RecordsFromManyThreadsWithoutLosingSamples) {
+    FeedLatency latency("test_feed_threads");
+    Timestamp wire = now();
+
+    std::vector<std::thread> feeds;
+    for (int t = 0; t < 4; ++t) {
+        feeds.emplace_back([&] {
+            for (int i = 0; i < 2000; ++i) latency.record(wire, wire + 40us, wire + 50us, 0);
+        });
+    }
+    for (auto& feed : feeds) feed.join();
+
+    EXPECT_EQ(latency.wire_to_parse().count(), 8000);
+    EXPECT_EQ(latency.parse_to_book().count(), 8000);
+    EXPECT_EQ(latency.wire_to_parse().min(), 40us);
+    EXPECT_EQ(latency.wire_to_parse().max(), 40us);
+}
+
+TEST(FeedLatencyTest, SameNamedFeedsKeepTheirOwnSamples) {
+    FeedLatency first("test_feed_shared");
+    Timestamp wire = now();
+    first.record(wire, wire + 40us, wire + 50us, 0);
+    {
+        FeedLatency second("test_feed_shared");
+        second.record(wire, wire + 40us, wire + 50us, 0);
+        second.record(wire, wire + 40us, wire + 50us, 0);
+        EXPECT_EQ(second.wire_to_parse().count(), 2);
+        EXPECT_NE(MetricsRegistry::instance().to_json().find("test_feed_shared.wire_to_parse"),
+                  std::string::npos);
+    }
+    EXPECT_EQ(first.wire_to_parse().count(), 1);
+}
+
+TEST(FeedLatencyTest, ExportsOnlyWhileAlive) {
+    {
+        FeedLatency latency("test_feed_export");
+        EXPECT_NE(MetricsRegistry::instance().to_json().find("test_feed_export.parse_to_book"),
+                  std::string::npos);
+    }
+    EXPECT_EQ(MetricsRegistry::instance().to_json().find("test_feed_export"), std::string::npos);
+}
+
+TEST(LatencyHistogramTest, KeepsOnlyTheLatestSamples) {
+    LatencyHistogram histogram("ring", 4);
+    for (int64_t ns = 1; ns <= 10; ++ns) histogram.record_ns(ns);
+
+    EXPECT_EQ(histogram.count(), 10);
+    EXPECT_EQ(histogram.min().count(), 7);
+    EXPECT_EQ(histogram.max().count(), 10);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0);
+    EXPECT_EQ(histogram.p50(), Duration::zero());
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include "market_data/first_arrival_filter.hpp"
+
+using namespace arb;
+using namespace std::chrono_literals;
+
+TEST(FirstArrivalFilterTest, FirstCopyWinsAndLateCopiesAreDropped) {
+    FirstArrivalFilter filter(2);
+    Timestamp t0 = now();
+
+    EXPECT_TRUE(filter.accept(0, R"({"u":1,"b":"100.0"})", t0));
+    EXPECT_FALSE(filter.accept(1, R"({"u":1,"b":"100.0"})", t0 + 300us));
+    EXPECT_TRUE(filter.accept(1, R"({"u":2,"b":"100.5"})", t0 + 1ms));
+    EXPECT_FALSE(filter.accept(0, R"({"u":2,"b":"100.5"})", t0 + 1ms + 100us));
+
+    FeedPathStats a = filter.path_stats(0);
+    FeedPathStats b = filter.path_stats(1);
+    EXPECT_EQ(a.messages, 2);
+    EXPECT_EQ(a.wins, 1);
+    EXPECT_DOUBLE_EQ(a.win_rate(), 0.5);
+    EXPECT_EQ(b.late, 1);
+    EXPECT_DOUBLE_EQ(b.mean_lag_us(), 300.0);
+    EXPECT_DOUBLE_EQ(a.mean_lag_us(), 100.0);
+    EXPECT_EQ(filter.duplicates(), 2);
+}
+
+TEST(FirstArrivalFilterTest, ReplayOnTheSameConnectionIsDropped) {
+    FirstArrivalFilter filter(2);
+    Timestamp t0 = now();
+
+    EXPECT_TRUE(filter.accept(0, R"({"u":7})", t0));
+    EXPECT_FALSE(filter.accept(0, R"({"u":7})", t0 + 1s));
+    EXPECT_EQ(filter.path_stats(0).late, 0);  // Not a race lost to another path
+    EXPECT_EQ(filter.duplicates(), 1);
+}
+
+TEST(FirstArrivalFilterTest, EvictedKeysOnlyLetLateCopiesThrough) {
+    FirstArrivalFilter filter(2, 4);
+    Timestamp t0 = now();
+
+    // Far more distinct messages than slots: every fresh one still passes
+    for (int i = 0; i < 64; ++i) {
+        EXPECT_TRUE(filter.accept(0, "msg-" + std::to_string(i), t0));
+    }
+    EXPECT_EQ(filter.path_stats(0).wins, 64);
+
+    // A copy whose key was evicted is applied again rather than lost
+    int passed = 0;
+    for (int i = 0; i < 64; ++i) {
+        passed += filter.accept(1, "msg-" + std::to_string(i), t0) ? 1 : 0;
+    }
+    EXPECT_GE(passed, 60);
+}
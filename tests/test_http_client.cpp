@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "market_data/http_client.hpp"
+#include "loopback_http_server.hpp"
+
+using namespace arb;
+
+using EchoServer = test::LoopbackHttpServer;
+
+TEST(HttpClientTest, SequentialRequestsReuseOneConnection) {
+    EchoServer server;
+    HttpClient client;
+
+    for (int i = 0; i < 5; ++i) {
+        HttpResponse response = client.get(server.url("/book?i=" + std::to_string(i)));
+        EXPECT_EQ(response.status, 200);
+        EXPECT_EQ(response.body, "GET /book?i=" + std::to_string(i) + " ");
+    }
+
+    HttpClientStats stats = client.stats();
+    EXPECT_EQ(stats.requests, 5);
+    EXPECT_EQ(stats.connects, 1);
+    EXPECT_EQ(stats.handles, 1);
+    EXPECT_EQ(server.accepted(), 1);
+}
+
+TEST(HttpClientTest, PostSendsBodyAndHeadersOnPooledConnection) {
+    EchoServer server;
+    HttpClient client;
+
+    client.get(server.url("/warm"));
+    HttpResponse response = client.post(server.url("/order"), R"({"size":"5"})",
+                                        {"Content-Type: application/json", "POLY_API_KEY: abc"});
+    EXPECT_EQ(response.status, 200);
+    EXPECT_EQ(response.body, R"(POST /order {"size":"5"})");
+    EXPECT_NE(server.last_header_block().find("POLY_API_KEY: abc"), std::string::npos);
+
+    // A GET after a POST on the same handle must not resend the body
+    response = client.get(server.url("/after"));
+    EXPECT_EQ(response.body, "GET /after ");
+    EXPECT_EQ(server.last_header_block().find("POLY_API_KEY"), std::string::npos);
+
+    EXPECT_EQ(client.stats().connects, 1);
+}
+
+TEST(HttpClientTest, ErrorStatusIsReturnedNotThrown) {
+    EchoServer server;
+    HttpClient client;
+
+    HttpResponse response = client.get(server.url("/missing"));
+    EXPECT_EQ(response.status, 404);
+    EXPECT_EQ(client.stats().failures, 0);
+}
+
+TEST(HttpClientTest, TransportFailureThrows) {
+    HttpClientOptions options;
+    options.timeout_ms = 2000;
+    HttpClient client(options);
+
+    // Bind then close to get a loopback port with nothing listening
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    close(fd);
+
+    std::string url = "http://127.0.0.1:" + std::to_string(ntohs(addr.sin_port)) + "/";
+    EXPECT_THROW(client.get(url), std::runtime_error);
+    EXPECT_EQ(client.stats().failures, 1);
+}
+
+TEST(HttpClientTest, ConcurrentCallersGetTheirOwnHandles) {
+    EchoServer server;
+    HttpClient client;
+
+    constexpr int THREADS = 4;
+    constexpr int REQUESTS = 20;
+    std::atomic<int> ok{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < REQUESTS; ++i) {
+                std::string path = "/t" + std::to_string(t) + "/" + std::to_string(i);
+                if (client.get(server.url(path)).body == "GET " + path + " ") ok++;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ(ok.load(), THREADS * REQUESTS);
+    HttpClientStats stats = client.stats();
+    EXPECT_LE(stats.handles, THREADS);
+    EXPECT_LE(stats.connects, THREADS);  // Each handle keeps its own connection
+}
+
+TEST(HttpClientTest, GetManyCompletesEveryUrlWithinConcurrencyLimit) {
+    EchoServer server;
+    HttpClient client;
+
+    std::vector<std::string> urls;
+    for (int i = 0; i < 12; ++i) urls.push_back(server.url("/book?token_id=" + std::to_string(i)));
+
+    HttpBatchOptions batch;
+    batch.max_concurrency = 3;
+    std::vector<std::string> bodies(urls.size());
+    int errors = 0;
+    client.get_many(urls, {"Accept: application/json"}, batch,
+                    [&](size_t i, HttpResponse& response, const std::string& error) {
+        if (!error.empty() || response.status != 200) errors++;
+        bodies[i] = std::move(response.body);
+    });
+
+    EXPECT_EQ(errors, 0);
+    for (size_t i = 0; i < urls.size(); ++i) {
+        EXPECT_EQ(bodies[i], "GET /book?token_id=" + std::to_string(i) + " ");
+    }
+    EXPECT_LE(server.accepted(), 3);
+    EXPECT_EQ(client.stats().requests, 12);
+
+    // The batch's handles go back to the pool, and the next batch runs on
+    // the same connections
+    EXPECT_LE(client.stats().handles, 3);
+    client.get_many(urls, {}, batch, [&](size_t, HttpResponse&, const std::string& error) {
+        if (!error.empty()) errors++;
+    });
+    EXPECT_EQ(errors, 0);
+    EXPECT_LE(server.accepted(), 3);
+    EXPECT_LE(client.stats().handles, 3);
+}
+
+TEST(HttpClientTest, GetManyHonoursRateLimitAndReportsFailures) {
+    EchoServer server;
+    HttpClient client;
+
+    std::vector<std::string> urls;
+    for (int i = 0; i < 5; ++i) urls.push_back(server.url("/" + std::to_string(i)));
+    urls.push_back("http://127.0.0.1:1/unreachable");
+
+    HttpBatchOptions batch;
+    batch.max_concurrency = 8;
+    batch.max_rate = 50.0;  // One start per 20 ms
+
+    size_t completed = 0;
+    std::vector<size_t> failed;
+    auto start = std::chrono::steady_clock::now();
+    client.get_many(urls, {}, batch, [&](size_t i, HttpResponse&, const std::string& error) {
+        completed++;
+        if (!error.empty()) failed.push_back(i);
+    });
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(completed, urls.size());
+    EXPECT_EQ(failed, (std::vector<size_t>{5}));
+    EXPECT_GE(elapsed, std::chrono::milliseconds(100));  // Five gaps between six starts
+}
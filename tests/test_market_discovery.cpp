@@ -0,0 +1,282 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "market_data/market_discovery.hpp"
+#include "market_data/polymarket_client.hpp"
+#include "utils/time_utils.hpp"
+#include "loopback_http_server.hpp"
+
+using namespace arb;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Gamma /markets and CLOB /book on one loopback server
+class FakePolymarket {
+public:
+    FakePolymarket()
+        : server_([this](const test::LoopbackHttpServer::Request& req) { return handle(req); }) {}
+
+    void set_markets(std::vector<nlohmann::json> markets) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        markets_ = std::move(markets);
+    }
+    void set_listing_fails(bool fails) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        listing_fails_ = fails;
+    }
+    void set_book_delay(std::chrono::milliseconds delay) { book_delay_ms_ = delay.count(); }
+
+    std::string base_url() const { return server_.base_url(); }
+
+    static nlohmann::json market(const std::string& id, const std::string& question,
+                                 const std::string& end_date = "", const std::string& start_date = "") {
+        nlohmann::json m = {
+            {"conditionId", id},
+            {"question", question},
+            {"slug", id},
+            {"active", true},
+            {"tokens", {{{"outcome", "Yes"}, {"token_id", id + "-yes"}},
+                        {{"outcome", "No"}, {"token_id", id + "-no"}}}}
+        };
+        if (!end_date.empty()) m["endDate"] = end_date;
+        if (!start_date.empty()) m["eventStartTime"] = start_date;
+        return m;
+    }
+
+private:
+    test::LoopbackHttpServer server_;
+    std::mutex mutex_;
+    std::vector<nlohmann::json> markets_;
+    bool listing_fails_{false};
+    std::atomic<int64_t> book_delay_ms_{0};
+
+    static size_t query_value(const std::string& target, const std::string& key) {
+        auto pos = target.find(key + "=");
+        return pos == std::string::npos ? 0 : std::stoul(target.substr(pos + key.size() + 1));
+    }
+
+    test::LoopbackHttpServer::Reply handle(const test::LoopbackHttpServer::Request& req) {
+        if (req.target.rfind("/book", 0) == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(book_delay_ms_.load()));
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (req.target.rfind("/markets", 0) == 0) {
+            if (listing_fails_) return {500, "{}"};
+            size_t limit = query_value(req.target, "limit");
+            size_t offset = query_value(req.target, "offset");
+            nlohmann::json page = nlohmann::json::array();
+            for (size_t i = offset; i < markets_.size() && i < offset + limit; ++i) {
+                page.push_back(markets_[i]);
+            }
+            return {200, page.dump()};
+        }
+        if (req.target.rfind("/book", 0) == 0) {
+            std::string token = req.target.substr(req.target.find("token_id=") + 9);
+            return {200, R"({"asset_id":")" + token + R"(","timestamp":"1700000000000",)"
+                         R"("bids":[{"price":"0.45","size":"10"}],"asks":[{"price":"0.48","size":"10"}]})"};
+        }
+        return {404, ""};
+    }
+};
+
+class MarketDiscoveryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        config_.polymarket_gamma_url = fake_.base_url();
+        config_.polymarket_rest_url = fake_.base_url();
+        config_.discovery_page_size = 2;  // Force paging
+        config_.bootstrap_rate_limit = 0;
+        client_ = std::make_unique<PolymarketClient>(config_);
+    }
+
+    static std::vector<std::string> ids(const MarketSet& set) {
+        std::vector<std::string> out;
+        for (const auto& m : set.markets) out.push_back(m.condition_id);
+        return out;
+    }
+
+    FakePolymarket fake_;
+    ConnectionConfig config_;
+    std::unique_ptr<PolymarketClient> client_;
+};
+
+} // namespace
+
+TEST_F(MarketDiscoveryTest, FirstPassPagesFiltersAndBootstraps) {
+    fake_.set_markets({FakePolymarket::market("disc-a", "BTC up 15m"),
+                       FakePolymarket::market("disc-b", "Election winner"),
+                       FakePolymarket::market("disc-c", "btc down 15m")});
+    MarketDiscovery discovery(*client_, "btc.*15m", config_);
+
+    DiscoveryResult result = discovery.refresh();
+    EXPECT_TRUE(result.ok);
+    EXPECT_EQ(result.listed, 2u);
+    EXPECT_EQ(result.added, 2u);
+    EXPECT_EQ(result.bootstrap.loaded, 4u);
+    EXPECT_EQ(result.bootstrap.markets_ready, 2u);
+
+    auto set = discovery.current();
+    EXPECT_EQ(discovery.version(), set->version);
+    EXPECT_EQ(ids(*set), (std::vector<std::string>{"disc-a", "disc-c"}));
+    ASSERT_EQ(set->books.size(), 2u);
+    BinaryBookSnapshot snap = set->books[0]->snapshot(1);
+    EXPECT_TRUE(snap.has_liquidity());
+}
+
+TEST_F(MarketDiscoveryTest, LaterPassesAddNewAndDropGoneOrExpired) {
+    fake_.set_markets({FakePolymarket::market("disc-d", "BTC 15m one"),
+                       FakePolymarket::market("disc-e", "BTC 15m two")});
+    MarketDiscovery discovery(*client_, "", config_);
+    discovery.refresh();
+    uint64_t first_version = discovery.version();
+
+    // Unchanged listing publishes nothing
+    DiscoveryResult result = discovery.refresh();
+    EXPECT_EQ(result.added + result.removed, 0u);
+    EXPECT_EQ(discovery.version(), first_version);
+
+    fake_.set_markets({FakePolymarket::market("disc-e", "BTC 15m two", "2000-01-01T00:00:00Z"),
+                       FakePolymarket::market("disc-f", "BTC 15m three", "2099-01-01T00:00:00Z")});
+    result = discovery.refresh();
+    EXPECT_EQ(result.added, 1u);
+    EXPECT_EQ(result.removed, 1u);  // disc-e expired; disc-d missed one listing only
+    EXPECT_GT(discovery.version(), first_version);
+    EXPECT_EQ(ids(*discovery.current()), (std::vector<std::string>{"disc-d", "disc-f"}));
+
+    result = discovery.refresh();
+    EXPECT_EQ(result.removed, 1u);  // disc-d gone from two listings in a row
+    EXPECT_EQ(ids(*discovery.current()), (std::vector<std::string>{"disc-f"}));
+    EXPECT_EQ(discovery.markets_removed(), 2);
+}
+
+TEST_F(MarketDiscoveryTest, MarketSkippedByOnePassKeepsItsBook) {
+    fake_.set_markets({FakePolymarket::market("disc-l", "BTC 15m one"),
+                       FakePolymarket::market("disc-m", "BTC 15m two")});
+    MarketDiscovery discovery(*client_, "", config_);
+    discovery.refresh();
+    uint64_t version = discovery.version();
+
+    // Paging shifted under the pass and disc-l fell between pages
+    fake_.set_markets({FakePolymarket::market("disc-m", "BTC 15m two")});
+    DiscoveryResult result = discovery.refresh();
+    EXPECT_EQ(result.removed, 0u);
+    EXPECT_EQ(discovery.version(), version);
+
+    // Back on the next pass: the miss count starts over
+    fake_.set_markets({FakePolymarket::market("disc-l", "BTC 15m one"),
+                       FakePolymarket::market("disc-m", "BTC 15m two")});
+    discovery.refresh();
+    fake_.set_markets({FakePolymarket::market("disc-m", "BTC 15m two")});
+    result = discovery.refresh();
+    EXPECT_EQ(result.removed, 0u);
+    EXPECT_EQ(ids(*discovery.current()), (std::vector<std::string>{"disc-l", "disc-m"}));
+    EXPECT_TRUE(client_->get_market_book("disc-l")->snapshot(1).has_liquidity());
+}
+
+TEST_F(MarketDiscoveryTest, FailedListingKeepsKnownMarkets) {
+    fake_.set_markets({FakePolymarket::market("disc-g", "BTC 15m")});
+    MarketDiscovery discovery(*client_, "", config_);
+    discovery.refresh();
+    uint64_t version = discovery.version();
+
+    fake_.set_listing_fails(true);
+    DiscoveryResult result = discovery.refresh();
+    EXPECT_FALSE(result.ok);
+    EXPECT_EQ(result.removed, 0u);
+    EXPECT_EQ(discovery.version(), version);
+    EXPECT_EQ(discovery.current()->markets.size(), 1u);
+    EXPECT_EQ(discovery.failed_refreshes(), 1);
+}
+
+TEST_F(MarketDiscoveryTest, BackgroundPassPublishesNewMarkets) {
+    config_.discovery_interval_ms = 20;
+    fake_.set_markets({FakePolymarket::market("disc-h", "BTC 15m")});
+    MarketDiscovery discovery(*client_, "", config_);
+    discovery.refresh();
+    uint64_t version = discovery.version();
+    discovery.start();
+
+    fake_.set_markets({FakePolymarket::market("disc-h", "BTC 15m"),
+                       FakePolymarket::market("disc-i", "BTC 15m next")});
+    auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (discovery.version() == version && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(5ms);
+    }
+    discovery.stop();
+
+    EXPECT_EQ(ids(*discovery.current()), (std::vector<std::string>{"disc-h", "disc-i"}));
+}
+
+TEST_F(MarketDiscoveryTest, UpcomingWindowIsWarmedAndSwappedInAtOpen) {
+    config_.discovery_interval_ms = 0;
+    config_.rollover_lead_ms = 0;
+    auto boundary = time_utils::to_iso8601(wall_now() + 400ms);
+    auto later = time_utils::to_iso8601(wall_now() + 1h);
+    fake_.set_markets({FakePolymarket::market("disc-j", "BTC 15m now", boundary),
+                       FakePolymarket::market("disc-k", "BTC 15m next", later, boundary)});
+
+    MarketDiscovery discovery(*client_, "", config_);
+    std::atomic<int> ready{0};
+    discovery.set_ready_callback([&](const Market& market, Duration) {
+        if (market.condition_id == "disc-k") ready++;
+    });
+
+    DiscoveryResult result = discovery.refresh();
+    EXPECT_EQ(result.added, 2u);
+    EXPECT_EQ(result.pending, 1u);
+    EXPECT_EQ(discovery.pending_markets(), 1u);
+    EXPECT_EQ(ids(*discovery.current()), (std::vector<std::string>{"disc-j"}));
+    EXPECT_TRUE(client_->get_market_book("disc-k")->snapshot(1).has_liquidity());  // Warm before open
+
+    uint64_t version = discovery.version();
+    discovery.start();
+    auto deadline = std::chrono::steady_clock::now() + 3s;
+    while (ready.load() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(5ms);
+    }
+    discovery.stop();
+
+    // The ending and the opening market swap in one publish
+    EXPECT_EQ(discovery.version(), version + 1);
+    EXPECT_EQ(ids(*discovery.current()), (std::vector<std::string>{"disc-k"}));
+    EXPECT_EQ(ready.load(), 1);
+    EXPECT_EQ(discovery.markets_opened(), 1);
+    EXPECT_GE(discovery.last_open_to_ready_ms(), 0);
+    EXPECT_LT(discovery.last_open_to_ready_ms(), 250);
+}
+
+TEST_F(MarketDiscoveryTest, SlowBootstrapDoesNotHoldUpAnOpen) {
+    config_.discovery_interval_ms = 20;
+    config_.rollover_lead_ms = 0;
+    auto opens = time_utils::to_iso8601(wall_now() + 300ms);
+    auto later = time_utils::to_iso8601(wall_now() + 1h);
+    fake_.set_markets({FakePolymarket::market("disc-n", "BTC 15m next", later, opens)});
+
+    MarketDiscovery discovery(*client_, "", config_);
+    discovery.refresh();
+    ASSERT_EQ(discovery.pending_markets(), 1u);
+
+    // The next pass finds a new market whose books take far longer to load
+    fake_.set_book_delay(1500ms);
+    fake_.set_markets({FakePolymarket::market("disc-n", "BTC 15m next", later, opens),
+                       FakePolymarket::market("disc-o", "BTC 15m other", later)});
+    auto started = std::chrono::steady_clock::now();
+    discovery.start();
+
+    auto deadline = started + 3s;
+    while (discovery.markets_opened() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(5ms);
+    }
+    auto opened_after = std::chrono::steady_clock::now() - started;
+    discovery.stop();
+
+    EXPECT_EQ(discovery.markets_opened(), 1);
+    EXPECT_LT(opened_after, 1s);  // Well before disc-o's bootstrap finished
+    EXPECT_EQ(ids(*discovery.current()), (std::vector<std::string>{"disc-n", "disc-o"}));
+}
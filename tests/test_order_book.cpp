@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "market_data/order_book.hpp"
+#include "market_data/market_table.hpp"
 #include <thread>
 
 using namespace arb;
@@ -119,6 +120,22 @@ TEST_F(OrderBookTest, ApplySnapshot_ReplacesBook) {
     EXPECT_DOUBLE_EQ(best_ask->price, 103.0);
 }
 
+TEST_F(OrderBookTest, ApplySnapshot_FromLevelList) {
+    book_->update_bid(100.0, 1.0);
+    book_->update_ask(105.0, 1.0);
+
+    std::vector<LevelDelta> levels = {
+        {Side::BUY, 102.0, 5.0}, {Side::BUY, 101.0, 3.0}, {Side::BUY, 99.0, 0.0},
+        {Side::SELL, 104.0, 2.0}, {Side::SELL, 103.0, 4.0}
+    };
+    book_->apply_snapshot(levels);
+
+    EXPECT_EQ(book_->top_bids(10).size(), 2u);  // Zero-size level skipped
+    EXPECT_DOUBLE_EQ(book_->best_bid()->price, 102.0);
+    EXPECT_DOUBLE_EQ(book_->best_ask()->price, 103.0);
+    EXPECT_DOUBLE_EQ(book_->ask_depth(2), 6.0);
+}
+
 TEST_F(OrderBookTest, BidDepth_SumsCorrectly) {
     book_->update_bid(100.0, 5.0);
     book_->update_bid(99.0, 3.0);
@@ -161,16 +178,39 @@ TEST_F(OrderBookTest, Staleness_DetectedCorrectly) {
     EXPECT_TRUE(book_->is_stale(std::chrono::milliseconds(50)));
 }
 
-TEST_F(OrderBookTest, MaxLevels_TrimsExcess) {
+TEST_F(OrderBookTest, MaxLevels_CapsTheView) {
     auto small_book = std::make_unique<OrderBook>("SMALL", 3);
 
     small_book->update_bid(100.0, 1.0);
     small_book->update_bid(99.0, 1.0);
     small_book->update_bid(98.0, 1.0);
-    small_book->update_bid(97.0, 1.0);  // Should be trimmed
+    small_book->update_bid(97.0, 1.0);  // Kept, but below the view
 
     auto top = small_book->top_bids(10);
     EXPECT_EQ(top.size(), 3);  // Max 3 levels
+    EXPECT_DOUBLE_EQ(small_book->bid_depth(10), 3.0);
+}
+
+TEST_F(OrderBookTest, MaxLevels_DeeperLevelsReturnWhenTopIsPulled) {
+    OrderBook small("SMALL", 3);
+    std::vector<LevelDelta> ladder;
+    for (int i = 0; i < 6; ++i) {
+        ladder.push_back({Side::SELL, 101.0 + i, 10.0});
+    }
+    small.apply_snapshot(ladder, 1);
+
+    // Pull the top three asks; the three below them move up into view
+    std::vector<LevelDelta> pulls = {
+        {Side::SELL, 101.0, 0.0}, {Side::SELL, 102.0, 0.0}, {Side::SELL, 103.0, 0.0}};
+    small.apply_deltas(pulls, 2);
+
+    auto top = small.top_asks(10);
+    ASSERT_EQ(top.size(), 3u);
+    EXPECT_DOUBLE_EQ(top[0].price, 104.0);
+    EXPECT_DOUBLE_EQ(top[2].price, 106.0);
+    EXPECT_DOUBLE_EQ(small.ask_depth(10), 30.0);
+    EXPECT_DOUBLE_EQ(small.sweep(Side::BUY, 25.0).filled, 25.0);
+    EXPECT_DOUBLE_EQ(small.top_of_book().ask_depth, 30.0);
 }
 
 // BinaryMarketBook Tests
@@ -240,3 +280,571 @@ TEST_F(BinaryMarketBookTest, ImpliedProbability_FromMidPrice) {
     // YES mid = 0.60
     EXPECT_DOUBLE_EQ(book_->yes_implied_probability(), 0.60);
 }
+
+// Tick-array OrderBook Tests
+
+class TickOrderBookTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        book_ = std::make_unique<OrderBook>("TICK", 10, OrderBookImpl::TICK_ARRAY);
+    }
+
+    std::unique_ptr<OrderBook> book_;
+};
+
+TEST_F(TickOrderBookTest, MultipleLevels_SortedLikeMapBook) {
+    book_->update_bid(0.40, 1.0);
+    book_->update_bid(0.42, 2.0);
+    book_->update_bid(0.41, 3.0);
+    book_->update_ask(0.45, 1.0);
+    book_->update_ask(0.43, 2.0);
+    book_->update_ask(0.44, 3.0);
+
+    auto bids = book_->top_bids(3);
+    ASSERT_EQ(bids.size(), 3);
+    EXPECT_DOUBLE_EQ(bids[0].price, 0.42);
+    EXPECT_DOUBLE_EQ(bids[1].price, 0.41);
+    EXPECT_DOUBLE_EQ(bids[2].price, 0.40);
+
+    auto asks = book_->top_asks(3);
+    ASSERT_EQ(asks.size(), 3);
+    EXPECT_DOUBLE_EQ(asks[0].price, 0.43);
+    EXPECT_DOUBLE_EQ(asks[1].price, 0.44);
+    EXPECT_DOUBLE_EQ(asks[2].price, 0.45);
+
+    EXPECT_DOUBLE_EQ(book_->spread(), 0.43 - 0.42);
+    EXPECT_DOUBLE_EQ(book_->bid_depth(2), 5.0);
+}
+
+TEST_F(TickOrderBookTest, RemovingBest_AdvancesCursor) {
+    book_->update_ask(0.50, 1.0);
+    book_->update_ask(0.55, 2.0);
+    book_->update_ask(0.60, 3.0);
+
+    book_->update_ask(0.50, 0.0);
+    ASSERT_TRUE(book_->best_ask().has_value());
+    EXPECT_DOUBLE_EQ(book_->best_ask()->price, 0.55);
+
+    book_->update_ask(0.55, 0.0);
+    book_->update_ask(0.60, 0.0);
+    EXPECT_FALSE(book_->best_ask().has_value());
+}
+
+TEST_F(TickOrderBookTest, OffGridPrice_Rejected) {
+    book_->update_bid(0.425, 1.0);  // Between ticks
+    book_->update_bid(1.50, 1.0);   // Outside (0, 1)
+
+    EXPECT_FALSE(book_->best_bid().has_value());
+    EXPECT_EQ(book_->rejected_updates(), 2);
+}
+
+TEST_F(TickOrderBookTest, MaxLevels_ViewShowsBest) {
+    OrderBook small("SMALL", 3, OrderBookImpl::TICK_ARRAY);
+
+    small.update_bid(0.50, 1.0);
+    small.update_bid(0.49, 1.0);
+    small.update_bid(0.48, 1.0);
+    small.update_bid(0.51, 1.0);  // New best pushes 0.48 out
+
+    auto top = small.top_bids(10);
+    ASSERT_EQ(top.size(), 3);
+    EXPECT_DOUBLE_EQ(top[0].price, 0.51);
+    EXPECT_DOUBLE_EQ(top[2].price, 0.49);
+
+    small.update_bid(0.47, 1.0);  // Worse than all three, outside the view
+    EXPECT_EQ(small.top_bids(10).size(), 3);
+
+    // Pulling the best brings 0.48 back into view
+    small.update_bid(0.51, 0.0);
+    top = small.top_bids(10);
+    ASSERT_EQ(top.size(), 3);
+    EXPECT_DOUBLE_EQ(top[2].price, 0.48);
+}
+
+TEST_F(TickOrderBookTest, MatchesMapBook_OnRandomStream) {
+    OrderBook map_book("MAP", 10, OrderBookImpl::MAP);
+    uint32_t state = 12345;
+    auto next = [&state]() { state = state * 1664525u + 1013904223u; return state >> 8; };
+
+    for (int i = 0; i < 5000; ++i) {
+        Price price = static_cast<double>(1 + next() % 99) / 100.0;
+        Size size = (next() % 4 == 0) ? 0.0 : static_cast<double>(next() % 1000);
+        if (next() % 2) {
+            map_book.update_bid(price, size);
+            book_->update_bid(price, size);
+        } else {
+            map_book.update_ask(price, size);
+            book_->update_ask(price, size);
+        }
+        ASSERT_EQ(map_book.top_bids(10), book_->top_bids(10)) << "step " << i;
+        ASSERT_EQ(map_book.top_asks(10), book_->top_asks(10)) << "step " << i;
+    }
+}
+
+// Lock-free top-of-book Tests
+
+TEST_F(OrderBookTest, TopOfBook_MatchesLockedQueries) {
+    book_->update_bid(0.40, 100.0);
+    book_->update_bid(0.39, 50.0);
+    book_->update_ask(0.45, 80.0);
+    book_->set_sequence(7);
+
+    TopOfBook top = book_->top_of_book();
+    ASSERT_TRUE(top.has_liquidity());
+    EXPECT_EQ(*top.best_bid, *book_->best_bid());
+    EXPECT_EQ(*top.best_ask, *book_->best_ask());
+    EXPECT_DOUBLE_EQ(top.spread(), book_->spread());
+    EXPECT_DOUBLE_EQ(top.mid_price(), book_->mid_price());
+    EXPECT_DOUBLE_EQ(top.bid_depth, 150.0);
+    EXPECT_DOUBLE_EQ(top.ask_depth, 80.0);
+    EXPECT_EQ(top.last_update, book_->last_update_time());
+    EXPECT_EQ(top.sequence, 7u);
+}
+
+TEST_F(OrderBookTest, TopOfBook_EmptySideIsNullopt) {
+    book_->update_bid(0.40, 100.0);
+    book_->update_bid(0.40, 0.0);
+
+    TopOfBook top = book_->top_of_book();
+    EXPECT_FALSE(top.best_bid.has_value());
+    EXPECT_FALSE(top.best_ask.has_value());
+    EXPECT_FALSE(top.has_liquidity());
+    EXPECT_DOUBLE_EQ(top.spread(), 0.0);
+}
+
+TEST_F(OrderBookTest, TopOfBook_NoTornReadsUnderConcurrentWrites) {
+    std::atomic<bool> done{false};
+
+    // Every snapshot keeps bid size == ask size == sequence, so any mix of
+    // two generations shows up as a mismatch.
+    std::thread writer([&]() {
+        for (int i = 1; i <= 20000; ++i) {
+            double size = static_cast<double>(i);
+            book_->apply_snapshot({{0.40, size}}, {{0.45, size}});
+            book_->set_sequence(static_cast<uint64_t>(i));
+        }
+        done = true;
+    });
+
+    int64_t torn = 0;
+    while (!done) {
+        TopOfBook top = book_->top_of_book();
+        if (top.best_bid && top.best_ask && top.best_bid->size != top.best_ask->size) {
+            ++torn;
+        }
+    }
+    writer.join();
+
+    EXPECT_EQ(torn, 0);
+    EXPECT_DOUBLE_EQ(book_->top_of_book().best_ask->size, 20000.0);
+}
+
+TEST_F(BinaryMarketBookTest, Snapshot_CapturesBothLegs) {
+    book_->yes_book().update_bid(0.44, 100.0);
+    book_->yes_book().update_ask(0.45, 200.0);
+    book_->yes_book().update_ask(0.46, 10.0);
+    book_->no_book().update_bid(0.50, 150.0);
+    book_->no_book().update_bid(0.48, 30.0);
+    book_->no_book().update_ask(0.52, 40.0);
+    book_->yes_book().set_sequence(11);
+    book_->no_book().set_sequence(12);
+
+    BinaryBookSnapshot snap = book_->snapshot();
+    ASSERT_EQ(snap.yes.ask_count, 2);
+    EXPECT_EQ(snap.yes.asks[0], (PriceLevel{0.45, 200.0}));
+    EXPECT_EQ(snap.yes.asks[1], (PriceLevel{0.46, 10.0}));
+    EXPECT_EQ(snap.no.bid_count, 2);
+    EXPECT_EQ(snap.no.bids[0], (PriceLevel{0.50, 150.0}));
+    EXPECT_EQ(snap.yes.sequence, 11u);
+    EXPECT_EQ(snap.no.sequence, 12u);
+    EXPECT_TRUE(snap.has_liquidity());
+    EXPECT_DOUBLE_EQ(snap.sum_of_best_asks(), book_->sum_of_best_asks());
+
+    BinaryBookSnapshot top = book_->snapshot(1);
+    EXPECT_EQ(top.yes.ask_count, 1);
+    EXPECT_EQ(top.no.bid_count, 1);
+}
+
+TEST_F(BinaryMarketBookTest, Snapshot_LegsFromSameInstant) {
+    std::atomic<bool> done{false};
+
+    // YES is always written before NO, so a point-in-time view has YES equal
+    // to NO or exactly one generation ahead - never behind.
+    std::thread writer([&]() {
+        for (int i = 1; i <= 20000; ++i) {
+            double size = static_cast<double>(i);
+            book_->yes_book().apply_snapshot({{0.40, size}}, {{0.45, size}});
+            book_->no_book().apply_snapshot({{0.50, size}}, {{0.55, size}});
+        }
+        done = true;
+    });
+
+    int64_t torn = 0;
+    while (!done) {
+        BinaryBookSnapshot snap = book_->snapshot(1);
+        double lead = snap.yes.asks[0].size - snap.no.asks[0].size;
+        if (lead < 0.0 || lead > 1.0) ++torn;
+    }
+    writer.join();
+
+    EXPECT_EQ(torn, 0);
+}
+
+// Batched delta Tests
+
+TEST_F(OrderBookTest, ApplyDeltas_MatchesIndividualUpdates) {
+    OrderBook single("SINGLE", 10);
+    std::vector<LevelDelta> deltas = {
+        {Side::BUY, 0.40, 100.0},
+        {Side::BUY, 0.41, 50.0},
+        {Side::SELL, 0.45, 80.0},
+        {Side::BUY, 0.40, 0.0},
+        {Side::SELL, 0.46, 20.0},
+    };
+    for (const auto& d : deltas) {
+        if (d.side == Side::BUY) single.update_bid(d.price, d.size);
+        else single.update_ask(d.price, d.size);
+    }
+
+    book_->apply_deltas(deltas, 42);
+
+    EXPECT_EQ(book_->top_bids(10), single.top_bids(10));
+    EXPECT_EQ(book_->top_asks(10), single.top_asks(10));
+    EXPECT_EQ(book_->sequence(), 42u);
+}
+
+TEST_F(OrderBookTest, ApplyDeltas_ReportsTopChanges) {
+    book_->update_bid(0.40, 100.0);
+    book_->update_ask(0.45, 100.0);
+    book_->set_sequence(5);
+
+    // Below the top on both sides: nothing to re-evaluate
+    std::vector<LevelDelta> deep = {{Side::BUY, 0.38, 10.0}, {Side::SELL, 0.48, 10.0}};
+    DeltaResult r = book_->apply_deltas(deep);
+    EXPECT_FALSE(r.top_changed());
+    EXPECT_EQ(book_->sequence(), 5u);  // sequence 0 leaves it alone
+
+    // New best bid only
+    std::vector<LevelDelta> better_bid = {{Side::BUY, 0.41, 10.0}};
+    r = book_->apply_deltas(better_bid);
+    EXPECT_TRUE(r.bid_price_changed);
+    EXPECT_FALSE(r.ask_price_changed);
+
+    // Size change at the best ask
+    std::vector<LevelDelta> resize = {{Side::SELL, 0.45, 60.0}};
+    r = book_->apply_deltas(resize);
+    EXPECT_FALSE(r.bid_price_changed);
+    EXPECT_FALSE(r.ask_price_changed);
+    EXPECT_TRUE(r.top_size_changed);
+
+    // Add then remove the same level in one batch: net no-op at the top
+    std::vector<LevelDelta> flicker = {{Side::SELL, 0.44, 5.0}, {Side::SELL, 0.44, 0.0}};
+    r = book_->apply_deltas(flicker);
+    EXPECT_FALSE(r.top_changed());
+}
+
+TEST_F(OrderBookTest, SequencedUpdates_DropWhatTheBookIsPast) {
+    std::vector<LevelDelta> snapshot = {{Side::BUY, 0.40, 100.0}, {Side::SELL, 0.45, 100.0}};
+    EXPECT_TRUE(book_->apply_snapshot(snapshot, 100));
+    EXPECT_EQ(book_->sequence(), 100u);
+
+    // A delta sent before the snapshot
+    std::vector<LevelDelta> old_delta = {{Side::BUY, 0.42, 10.0}};
+    DeltaResult r = book_->apply_deltas(old_delta, 99);
+    EXPECT_TRUE(r.stale);
+    EXPECT_FALSE(r.top_changed());
+    EXPECT_DOUBLE_EQ(book_->best_bid()->price, 0.40);
+
+    // An older snapshot leaves the book alone; an equal or unsequenced one applies
+    std::vector<LevelDelta> other = {{Side::BUY, 0.30, 1.0}};
+    EXPECT_FALSE(book_->apply_snapshot(other, 50));
+    EXPECT_DOUBLE_EQ(book_->best_bid()->price, 0.40);
+    EXPECT_TRUE(book_->apply_snapshot(other, 100));
+    EXPECT_DOUBLE_EQ(book_->best_bid()->price, 0.30);
+    EXPECT_FALSE(book_->best_ask().has_value());
+    EXPECT_TRUE(book_->apply_snapshot(snapshot, 0));
+    EXPECT_EQ(book_->sequence(), 0u);
+}
+
+TEST_F(TickOrderBookTest, ApplyDeltas_ViewReflectsTheWholeBatch) {
+    OrderBook small("SMALL", 2, OrderBookImpl::TICK_ARRAY);
+    std::vector<LevelDelta> deltas = {
+        {Side::BUY, 0.40, 1.0},
+        {Side::BUY, 0.41, 1.0},
+        {Side::BUY, 0.42, 1.0},
+        {Side::BUY, 0.42, 0.0},  // Removing the best within the batch keeps 0.40
+    };
+    small.apply_deltas(deltas);
+
+    auto bids = small.top_bids(10);
+    ASSERT_EQ(bids.size(), 2);
+    EXPECT_DOUBLE_EQ(bids[0].price, 0.41);
+    EXPECT_DOUBLE_EQ(bids[1].price, 0.40);
+}
+
+TEST_F(OrderBookTest, ApplyDeltas_OneSidedBatchLeavesOtherSideIntact) {
+    book_->update_bid(0.40, 30.0);
+    book_->update_ask(0.45, 100.0);
+    book_->update_ask(0.47, 50.0);
+
+    std::vector<LevelDelta> deltas = {{Side::BUY, 0.41, 20.0}, {Side::BUY, 0.40, 0.0}};
+    book_->apply_deltas(deltas);
+
+    EXPECT_DOUBLE_EQ(book_->bid_depth(10), 20.0);
+    EXPECT_DOUBLE_EQ(book_->ask_depth(10), 150.0);
+    EXPECT_DOUBLE_EQ(book_->ask_notional(2), 0.45 * 100.0 + 0.47 * 50.0);
+    auto asks = book_->top_asks(10);
+    ASSERT_EQ(asks.size(), 2);
+    EXPECT_DOUBLE_EQ(asks[0].price, 0.45);
+}
+
+// Depth aggregate and sweep Tests
+
+TEST_F(OrderBookTest, DepthAndNotional_FromRunningTotals) {
+    book_->update_ask(0.50, 100.0);
+    book_->update_ask(0.52, 50.0);
+    book_->update_ask(0.55, 10.0);
+    book_->update_bid(0.48, 30.0);
+
+    EXPECT_DOUBLE_EQ(book_->ask_depth(1), 100.0);
+    EXPECT_DOUBLE_EQ(book_->ask_depth(2), 150.0);
+    EXPECT_DOUBLE_EQ(book_->ask_depth(100), 160.0);
+    EXPECT_DOUBLE_EQ(book_->ask_depth(0), 0.0);
+    EXPECT_DOUBLE_EQ(book_->ask_notional(2), 0.50 * 100.0 + 0.52 * 50.0);
+    EXPECT_DOUBLE_EQ(book_->total_depth(10), 190.0);
+
+    // Removing the best level shifts the totals
+    book_->update_ask(0.50, 0.0);
+    EXPECT_DOUBLE_EQ(book_->ask_depth(1), 50.0);
+    EXPECT_DOUBLE_EQ(book_->ask_notional(10), 0.52 * 50.0 + 0.55 * 10.0);
+}
+
+TEST_F(OrderBookTest, Sweep_CostAndVwapAcrossLevels) {
+    book_->update_ask(0.50, 100.0);
+    book_->update_ask(0.52, 50.0);
+    book_->update_bid(0.48, 40.0);
+    book_->update_bid(0.47, 60.0);
+
+    // Inside the best level
+    SweepQuote q = book_->sweep(Side::BUY, 60.0);
+    EXPECT_DOUBLE_EQ(q.filled, 60.0);
+    EXPECT_DOUBLE_EQ(q.cost, 30.0);
+    EXPECT_EQ(q.levels, 1);
+
+    // Exactly the best level, then into the second
+    EXPECT_EQ(book_->sweep(Side::BUY, 100.0).levels, 1);
+    q = book_->sweep(Side::BUY, 120.0);
+    EXPECT_DOUBLE_EQ(q.cost, 0.50 * 100.0 + 0.52 * 20.0);
+    EXPECT_DOUBLE_EQ(q.worst_price, 0.52);
+    EXPECT_EQ(q.levels, 2);
+    EXPECT_DOUBLE_EQ(book_->vwap_to_size(Side::BUY, 120.0), q.cost / 120.0);
+
+    // More than the side holds
+    q = book_->sweep(Side::BUY, 500.0);
+    EXPECT_DOUBLE_EQ(q.filled, 150.0);
+    EXPECT_FALSE(q.complete(500.0));
+
+    // SELL sweeps bids
+    q = book_->sweep(Side::SELL, 50.0);
+    EXPECT_DOUBLE_EQ(q.cost, 0.48 * 40.0 + 0.47 * 10.0);
+    EXPECT_DOUBLE_EQ(q.worst_price, 0.47);
+}
+
+TEST_F(TickOrderBookTest, Sweep_MatchesMapBook) {
+    OrderBook map_book("MAP", 10, OrderBookImpl::MAP);
+    for (int t = 1; t <= 12; ++t) {
+        map_book.update_ask((40 + t) / 100.0, 10.0 * t);
+        book_->update_ask((40 + t) / 100.0, 10.0 * t);
+    }
+
+    for (Size qty : {5.0, 10.0, 75.0, 300.0, 1000.0}) {
+        SweepQuote a = map_book.sweep(Side::BUY, qty);
+        SweepQuote b = book_->sweep(Side::BUY, qty);
+        EXPECT_DOUBLE_EQ(a.filled, b.filled) << qty;
+        EXPECT_DOUBLE_EQ(a.cost, b.cost) << qty;
+        EXPECT_EQ(a.levels, b.levels) << qty;
+    }
+}
+
+// Paired ask sweep Tests
+
+TEST(PairedSweepTest, StopsWhenMarginalEdgeFallsBelowThreshold) {
+    constexpr int64_t kFeeRate = POLYMARKET_FEE_RATE_PPM;
+    std::vector<PriceLevel> yes = {{0.40, 5.0}, {0.45, 10.0}, {0.55, 10.0}};
+    std::vector<PriceLevel> no = {{0.45, 20.0}, {0.50, 20.0}};
+
+    PairedSweep s = sweep_paired_asks(yes, no, kFeeRate, 2.0);
+    EXPECT_DOUBLE_EQ(s.size, 15.0);
+    EXPECT_DOUBLE_EQ(s.yes_cost, 0.40 * 5.0 + 0.45 * 10.0);
+    EXPECT_DOUBLE_EQ(s.no_cost, 0.45 * 15.0);
+    EXPECT_DOUBLE_EQ(s.yes_worst_price, 0.45);
+    EXPECT_DOUBLE_EQ(s.no_worst_price, 0.45);
+    EXPECT_EQ(s.yes_levels, 2);
+    EXPECT_EQ(s.no_levels, 1);
+
+    double fee_045 = 0.45 * 0.55 * 0.0624;
+    EXPECT_NEAR(s.marginal_edge_cents, (1.0 - 0.90 - 2 * fee_045) * 100.0, 1e-9);
+    EXPECT_EQ(s.marginal_edge_cents,
+              fixed_pair_edge_cents(4500, 4500, POLYMARKET_PRICE_SCALE));  // Same bits as the gate
+    EXPECT_GE(s.avg_edge_cents(), s.marginal_edge_cents);
+
+    // A higher threshold keeps only the best pair
+    PairedSweep strict = sweep_paired_asks(yes, no, kFeeRate, 10.0);
+    EXPECT_DOUBLE_EQ(strict.size, 5.0);
+}
+
+TEST(PairedSweepTest, EmptyOrUnprofitableLadder_ReturnsZero) {
+    std::vector<PriceLevel> yes = {{0.50, 10.0}};
+    std::vector<PriceLevel> no = {{0.50, 10.0}};
+    std::vector<PriceLevel> none;
+
+    EXPECT_DOUBLE_EQ(sweep_paired_asks(yes, none, POLYMARKET_FEE_RATE_PPM, 0.0).size, 0.0);
+    EXPECT_DOUBLE_EQ(sweep_paired_asks(yes, no, POLYMARKET_FEE_RATE_PPM, 0.0).size, 0.0);
+    EXPECT_DOUBLE_EQ(sweep_paired_asks(yes, no, POLYMARKET_FEE_RATE_PPM, 0.0).avg_edge_cents(), 0.0);
+}
+
+TEST(PairedSweepTest, ConsumesBothLaddersFully) {
+    std::vector<PriceLevel> yes = {{0.30, 4.0}, {0.31, 6.0}};
+    std::vector<PriceLevel> no = {{0.30, 10.0}};
+
+    PairedSweep s = sweep_paired_asks(yes, no, POLYMARKET_FEE_RATE_PPM, 2.0);
+    EXPECT_DOUBLE_EQ(s.size, 10.0);
+    EXPECT_EQ(s.yes_levels, 2);
+}
+
+TEST_F(BinaryMarketBookTest, PairedAskSweep_FromSnapshot) {
+    // 0.45 + 0.52 = 0.97, plus ~3c of fees: below a 2c edge
+    book_->yes_book().update_ask(0.45, 200.0);
+    book_->no_book().update_ask(0.52, 40.0);
+    BinaryBookSnapshot snap = book_->snapshot();
+    EXPECT_DOUBLE_EQ(snap.paired_ask_sweep(POLYMARKET_FEE_RATE_PPM, 2.0).size, 0.0);
+
+    book_->no_book().update_ask(0.40, 30.0);
+    snap = book_->snapshot();
+    PairedSweep s = snap.paired_ask_sweep(POLYMARKET_FEE_RATE_PPM, 2.0);
+    EXPECT_DOUBLE_EQ(s.size, 30.0);
+    EXPECT_DOUBLE_EQ(s.no_worst_price, 0.40);
+}
+
+TEST_F(BinaryMarketBookTest, PairedAskSweep_ReachesTheBooksViewDepth) {
+    // Every pair clears 2c, so the sweep runs as deep as the snapshot goes
+    for (int i = 0; i < 12; ++i) {
+        book_->yes_book().update_ask(0.30 + 0.01 * i, 10.0);
+        book_->no_book().update_ask(0.30 + 0.01 * i, 10.0);
+    }
+    BinaryBookSnapshot snap = book_->snapshot();
+    EXPECT_EQ(snap.yes.ask_count, BookLevels::MAX_LEVELS);
+    EXPECT_DOUBLE_EQ(book_->yes_book().ask_depth(100), 10.0 * BookLevels::MAX_LEVELS);
+
+    PairedSweep s = snap.paired_ask_sweep(POLYMARKET_FEE_RATE_PPM, 2.0);
+    EXPECT_EQ(s.yes_levels, BookLevels::MAX_LEVELS);
+    EXPECT_DOUBLE_EQ(s.size, 10.0 * BookLevels::MAX_LEVELS);
+}
+
+// ============================================================================
+// MarketTable (column-wise top of book + S2 screen)
+// ============================================================================
+
+namespace {
+
+TopOfBook make_top(Price bid, Price ask) {
+    TopOfBook top;
+    if (bid > 0) top.best_bid = PriceLevel{bid, 10.0};
+    if (ask > 0) top.best_ask = PriceLevel{ask, 20.0};
+    return top;
+}
+
+} // namespace
+
+TEST(MarketTableTest, UpdateStoresEachLeg) {
+    MarketTable table;
+    table.update(3, true, make_top(0.39, 0.40));
+    table.update(3, false, make_top(0.44, 0.45));
+
+    EXPECT_EQ(table.size(), 4u);
+    MarketTable::Row row = table.row(3);
+    EXPECT_DOUBLE_EQ(row.yes_bid, 0.39);
+    EXPECT_DOUBLE_EQ(row.yes_ask, 0.40);
+    EXPECT_DOUBLE_EQ(row.yes_ask_size, 20.0);
+    EXPECT_DOUBLE_EQ(row.no_ask, 0.45);
+
+    // Untouched rows and emptied legs read as "no ask"
+    EXPECT_DOUBLE_EQ(table.row(1).yes_ask, MarketTable::NO_ASK);
+    table.update(3, true, make_top(0.39, 0.0));
+    EXPECT_DOUBLE_EQ(table.row(3).yes_ask, MarketTable::NO_ASK);
+}
+
+TEST(MarketTableTest, UpdateFromBookCopiesBothLegs) {
+    BinaryMarketBook book("table-from-book", OrderBookImpl::TICK_ARRAY);
+    book.yes_book().apply_snapshot({{0.39, 5.0}}, {{0.40, 7.0}});
+    book.no_book().apply_snapshot({{0.44, 6.0}}, {});
+
+    MarketTable table;
+    table.update(book);
+    MarketTable::Row row = table.row(book.market_handle());
+    EXPECT_DOUBLE_EQ(row.yes_bid, 0.39);
+    EXPECT_DOUBLE_EQ(row.yes_ask, 0.40);
+    EXPECT_DOUBLE_EQ(row.yes_ask_size, 7.0);
+    EXPECT_DOUBLE_EQ(row.no_bid_size, 6.0);
+    EXPECT_DOUBLE_EQ(row.no_ask, MarketTable::NO_ASK);
+}
+
+TEST(MarketTableTest, ScanReturnsOnlyCrossingMarketsInOrder) {
+    MarketTable table;
+    table.update(1, true, make_top(0.39, 0.40));   // 0.40 + 0.45: ~12c edge
+    table.update(1, false, make_top(0.44, 0.45));
+    table.update(2, true, make_top(0.49, 0.50));   // 0.50 + 0.51: negative
+    table.update(2, false, make_top(0.50, 0.51));
+    table.update(5, true, make_top(0.29, 0.30));   // 0.30 + 0.60: ~7c edge
+    table.update(5, false, make_top(0.59, 0.60));
+    table.update(7, true, make_top(0.10, 0.11));   // NO leg has no asks
+    table.update(7, false, make_top(0.50, 0.0));
+
+    std::vector<MarketHandle> hits;
+    EXPECT_EQ(table.scan_underpriced(POLYMARKET_FEE_RATE_PPM, 2.0, hits), 2u);
+    EXPECT_EQ(hits, (std::vector<MarketHandle>{1, 5}));
+
+    // Threshold between the two edges keeps only the better market
+    hits.clear();
+    table.scan_underpriced(POLYMARKET_FEE_RATE_PPM, 10.0, hits);
+    EXPECT_EQ(hits, (std::vector<MarketHandle>{1}));
+}
+
+TEST(MarketTableTest, KernelMatchesScalarEdge) {
+    std::vector<int32_t> yes = {4000, 5000, 3000, 9900, 10000, 1};
+    std::vector<int32_t> no = {4500, 5100, 6000, 100, 10000, 1};
+    std::vector<double> edges(yes.size());
+    underpriced_edges(yes.data(), no.data(), yes.size(), POLYMARKET_PRICE_SCALE, POLYMARKET_FEE_RATE_PPM,
+                      edges.data());
+
+    for (size_t i = 0; i < yes.size(); ++i) {
+        EXPECT_EQ(edges[i], static_cast<double>(fixed_pair_edge(yes[i], no[i], POLYMARKET_PRICE_SCALE)));
+    }
+}
+
+TEST(PairedSweepTest, ThresholdExactlyAtTheEdgeAgreesWithTheGate) {
+    // 0.40 + 0.47 with fees leaves an edge just under 10c; set the
+    // threshold to exactly that edge, as the strategy's gate computes it
+    std::vector<PriceLevel> yes = {{0.40, 10.0}};
+    std::vector<PriceLevel> no = {{0.47, 10.0}};
+    double edge = fixed_pair_edge_cents(4000, 4700, POLYMARKET_PRICE_SCALE);
+
+    EXPECT_DOUBLE_EQ(sweep_paired_asks(yes, no, POLYMARKET_FEE_RATE_PPM, edge).size, 10.0);
+
+    MarketTable table;
+    table.update(1, true, make_top(0.0, 0.40));
+    table.update(1, false, make_top(0.0, 0.47));
+    std::vector<MarketHandle> hits;
+    EXPECT_EQ(table.scan_underpriced(POLYMARKET_FEE_RATE_PPM, edge, hits), 1u);
+}
+
+TEST_F(OrderBookTest, MapKeysAreExactPrices) {
+    // 0.1 + 0.2 != 0.3 as doubles, but both land on one integer key
+    book_->update_bid(0.1 + 0.2, 10.0);
+    book_->update_bid(0.3, 25.0);
+
+    auto bids = book_->top_bids(5);
+    ASSERT_EQ(bids.size(), 1u);
+    EXPECT_EQ(bids[0].price, 0.3);
+    EXPECT_DOUBLE_EQ(bids[0].size, 25.0);
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "market_data/polymarket_client.hpp"
+#include "loopback_http_server.hpp"
+
+using namespace arb;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Feeds WebSocket text straight into the client, as a shard's loop would
+class TestPolymarketClient : public PolymarketClient {
+public:
+    using PolymarketClient::PolymarketClient;
+
+    void feed(const std::string& msg) { handle_message(0, msg, now()); }
+};
+
+std::string book_msg(const std::string& token, int64_t ts, const std::string& bid, const std::string& ask) {
+    return R"({"event_type":"book","asset_id":")" + token + R"(","timestamp":")" + std::to_string(ts) +
+           R"(","bids":[{"price":")" + bid + R"(","size":"10"}],"asks":[{"price":")" + ask +
+           R"(","size":"10"}]})";
+}
+
+std::string change_msg(const std::string& token, int64_t ts, const std::string& price,
+                       const std::string& size, const std::string& best_bid, const std::string& best_ask) {
+    return R"({"event_type":"price_change","price_changes":[{"asset_id":")" + token +
+           R"(","price":")" + price + R"(","size":")" + size + R"(","side":"BUY","best_bid":")" +
+           best_bid + R"(","best_ask":")" + best_ask + R"("}],"timestamp":")" + std::to_string(ts) + R"("})";
+}
+
+}
+
+class PolymarketClientTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        config_.polymarket_rest_url = server_.base_url();
+        config_.polymarket_ws_url = "wss://127.0.0.1:9/ws";  // Nothing listens; the feed comes from feed()
+        config_.bootstrap_rate_limit = 0;
+        client_ = std::make_unique<TestPolymarketClient>(config_);
+        client_->set_book_callback([this](MarketHandle, TokenHandle) { callbacks_++; });
+    }
+
+    void TearDown() override {
+        client_->disconnect();
+    }
+
+    BinaryMarketBook* add_market(const std::string& id) {
+        Market market;
+        market.condition_id = id;
+        market.yes_outcome.token_id = id + "-yes";
+        market.no_outcome.token_id = id + "-no";
+        client_->register_market(market);
+        return client_->get_market_book(id);
+    }
+
+    // REST /book answers for resyncs
+    test::LoopbackHttpServer server_{[](const test::LoopbackHttpServer::Request& req) {
+        std::string token = req.target.substr(req.target.find("token_id=") + 9);
+        return test::LoopbackHttpServer::Reply{200, book_msg(token, 1700000003000, "0.47", "0.48")};
+    }};
+    ConnectionConfig config_;
+    std::unique_ptr<TestPolymarketClient> client_;
+    std::atomic<int> callbacks_{0};
+};
+
+TEST_F(PolymarketClientTest, DeltasMoveTheBookAndOlderOnesAreIgnored) {
+    BinaryMarketBook* book = add_market("pm-client-a");
+
+    client_->feed(book_msg("pm-client-a-yes", 1700000001000, "0.45", "0.48"));
+    ASSERT_TRUE(book->yes_book().best_bid().has_value());
+    EXPECT_DOUBLE_EQ(book->yes_book().best_bid()->price, 0.45);
+    EXPECT_EQ(callbacks_.load(), 1);
+
+    client_->feed(change_msg("pm-client-a-yes", 1700000002000, "0.46", "5", "0.46", "0.48"));
+    ASSERT_TRUE(book->yes_book().best_bid().has_value());
+    EXPECT_DOUBLE_EQ(book->yes_book().best_bid()->price, 0.46);
+    EXPECT_DOUBLE_EQ(book->yes_book().best_bid()->size, 5.0);
+    EXPECT_EQ(client_->deltas_applied(), 1);
+    EXPECT_EQ(callbacks_.load(), 2);
+
+    // Sent before the delta above: a slower connection's copy
+    client_->feed(change_msg("pm-client-a-yes", 1700000001500, "0.465", "3", "0.465", "0.48"));
+    EXPECT_DOUBLE_EQ(book->yes_book().best_bid()->price, 0.46);
+    EXPECT_EQ(client_->deltas_applied(), 1);
+    EXPECT_EQ(callbacks_.load(), 2);
+
+    EXPECT_EQ(client_->resyncs_requested(), 0);
+}
+
+TEST_F(PolymarketClientTest, TopMismatchQueuesOneResync) {
+    BinaryMarketBook* book = add_market("pm-client-b");
+    client_->connect();
+
+    client_->feed(book_msg("pm-client-b-yes", 1700000001000, "0.45", "0.48"));
+    // The exchange says the best bid is 0.47; our book has 0.46
+    client_->feed(change_msg("pm-client-b-yes", 1700000002000, "0.46", "5", "0.47", "0.48"));
+    EXPECT_EQ(client_->resyncs_requested(), 1);
+
+    // The REST snapshot replaces the diverged book
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (book->yes_book().sequence() != 1700000003000u && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    ASSERT_EQ(book->yes_book().sequence(), 1700000003000u);
+    EXPECT_DOUBLE_EQ(book->yes_book().best_bid()->price, 0.47);
+
+    // Diverging again inside RESYNC_MIN_INTERVAL doesn't queue another
+    client_->feed(change_msg("pm-client-b-yes", 1700000004000, "0.46", "5", "0.44", "0.48"));
+    client_->feed(change_msg("pm-client-b-yes", 1700000005000, "0.46", "6", "0.44", "0.48"));
+    EXPECT_EQ(client_->resyncs_requested(), 1);
+}
+
+TEST_F(PolymarketClientTest, BookCallbackMayCallBackIntoTheClient) {
+    BinaryMarketBook* book = add_market("pm-client-c");
+    std::vector<BinaryMarketBook*> seen;
+    client_->set_book_callback([&](MarketHandle market, TokenHandle) {
+        seen.push_back(client_->get_market_book(market));
+    });
+
+    client_->feed(book_msg("pm-client-c-yes", 1700000001000, "0.45", "0.48"));
+    client_->feed(change_msg("pm-client-c-yes", 1700000002000, "0.46", "5", "0.46", "0.48"));
+    client_->feed(R"({"event_type":"price_change","asset_id":"pm-client-c-no","timestamp":"1700000002000",)"
+                  R"("changes":[{"price":"0.52","size":"4","side":"SELL"}]})");
+    EXPECT_EQ(seen, (std::vector<BinaryMarketBook*>{book, book, book}));
+}
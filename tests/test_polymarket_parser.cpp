@@ -0,0 +1,322 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "common/symbol_registry.hpp"
+#include "market_data/polymarket_parser.hpp"
+
+using namespace arb;
+
+namespace {
+
+bool same_double(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+void expect_same(const PolymarketMessage& fast, const PolymarketMessage& json, const std::string& msg) {
+    EXPECT_EQ(fast.kind, json.kind) << msg;
+    EXPECT_EQ(fast.asset_id, json.asset_id) << msg;
+    EXPECT_EQ(fast.token, json.token) << msg;
+    EXPECT_EQ(fast.timestamp_ms, json.timestamp_ms) << msg;
+    EXPECT_EQ(fast.has_price_changes, json.has_price_changes) << msg;
+    EXPECT_TRUE(same_double(fast.price, json.price)) << msg;
+    EXPECT_TRUE(same_double(fast.size, json.size)) << msg;
+    EXPECT_EQ(fast.side, json.side) << msg;
+
+    ASSERT_EQ(fast.levels.size(), json.levels.size()) << msg;
+    for (size_t i = 0; i < fast.levels.size(); ++i) {
+        EXPECT_EQ(fast.levels[i].side, json.levels[i].side) << msg;
+        EXPECT_TRUE(same_double(fast.levels[i].price, json.levels[i].price)) << msg;
+        EXPECT_TRUE(same_double(fast.levels[i].size, json.levels[i].size)) << msg;
+    }
+
+    ASSERT_EQ(fast.changes.size(), json.changes.size()) << msg;
+    for (size_t i = 0; i < fast.changes.size(); ++i) {
+        EXPECT_EQ(fast.changes[i].token, json.changes[i].token) << msg;
+        EXPECT_EQ(fast.changes[i].level, json.changes[i].level) << msg;
+        EXPECT_EQ(fast.changes[i].has_level, json.changes[i].has_level) << msg;
+        EXPECT_EQ(fast.changes[i].has_top, json.changes[i].has_top) << msg;
+        EXPECT_TRUE(same_double(fast.changes[i].best_bid, json.changes[i].best_bid)) << msg;
+        EXPECT_TRUE(same_double(fast.changes[i].best_ask, json.changes[i].best_ask)) << msg;
+    }
+}
+
+std::string random_price(std::mt19937_64& gen) {
+    std::uniform_int_distribution<int> ticks(0, 1000);
+    std::uniform_int_distribution<int> extra(0, 3);
+    std::string s = "0." + std::to_string(1000 + ticks(gen)).substr(1);
+    if (extra(gen) == 0) s += "5";  // Off the 3-decimal grid
+    return s;
+}
+
+std::string random_size(std::mt19937_64& gen) {
+    std::uniform_int_distribution<int> whole(0, 50000);
+    std::uniform_int_distribution<int> frac(0, 999999);
+    std::uniform_int_distribution<int> shape(0, 3);
+    switch (shape(gen)) {
+        case 0: return "0";
+        case 1: return std::to_string(whole(gen));
+        default: return std::to_string(whole(gen)) + "." + std::to_string(frac(gen));
+    }
+}
+
+// Object text from key/value pairs, optionally in shuffled order
+std::string object(std::vector<std::pair<std::string, std::string>> fields,
+                   std::mt19937_64& gen, bool shuffle) {
+    if (shuffle) std::shuffle(fields.begin(), fields.end(), gen);
+    std::string s = "{";
+    for (size_t i = 0; i < fields.size(); ++i) {
+        if (i > 0) s += ",";
+        s += "\"" + fields[i].first + "\":" + fields[i].second;
+    }
+    return s + "}";
+}
+
+std::string quoted(const std::string& s) { return "\"" + s + "\""; }
+
+}
+
+class PolymarketParserTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto& registry = SymbolRegistry::instance();
+        yes_ = registry.intern_token("pm-parser-yes");
+        no_ = registry.intern_token("pm-parser-no");
+    }
+
+    TokenHandle yes_{NO_SYMBOL};
+    TokenHandle no_{NO_SYMBOL};
+};
+
+TEST_F(PolymarketParserTest, ParsesBookIntoLevels) {
+    std::string msg = R"({"event_type":"book","asset_id":"pm-parser-yes","market":"0xabc",)"
+                      R"("bids":[{"price":"0.48","size":"30"},{"price":"0.47","size":"0"}],)"
+                      R"("asks":[{"price":"0.52","size":"25.5"},{"price":"0","size":"9"}],)"
+                      R"("timestamp":"1700000000123","hash":"0x1f"})";
+    PolymarketMessage out;
+    ASSERT_TRUE(parse_polymarket_message(msg, nullptr, nullptr, out));
+    EXPECT_EQ(out.kind, PolymarketMessage::Kind::BOOK);
+    EXPECT_EQ(out.token, yes_);
+    EXPECT_EQ(out.asset_id, "pm-parser-yes");
+    EXPECT_EQ(out.timestamp_ms, 1700000000123);
+
+    // Zero sizes survive (the snapshot drops them); non-positive prices don't
+    ASSERT_EQ(out.levels.size(), 3u);
+    EXPECT_EQ(out.levels[0].side, Side::BUY);
+    EXPECT_DOUBLE_EQ(out.levels[0].price, 0.48);
+    EXPECT_DOUBLE_EQ(out.levels[1].size, 0.0);
+    EXPECT_EQ(out.levels[2].side, Side::SELL);
+    EXPECT_DOUBLE_EQ(out.levels[2].size, 25.5);
+}
+
+TEST_F(PolymarketParserTest, AsksBeforeBidsStillYieldBidsFirst) {
+    std::string msg = R"({"asks":[{"price":"0.52","size":"1"},{"price":"0.53","size":"2"}],)"
+                      R"("bids":[{"price":"0.48","size":"3"}],"event_type":"book","asset_id":"pm-parser-no"})";
+    PolymarketMessage fast;
+    PolymarketMessage json;
+    ASSERT_TRUE(parse_polymarket_message(msg, nullptr, nullptr, fast));
+    ASSERT_TRUE(parse_polymarket_message_json(msg, nullptr, nullptr, json));
+    ASSERT_EQ(fast.levels.size(), 3u);
+    EXPECT_EQ(fast.levels[0].side, Side::BUY);
+    expect_same(fast, json, msg);
+}
+
+TEST_F(PolymarketParserTest, PriceChangesBatchByToken) {
+    std::string msg = R"({"event_type":"price_change","market":"0xabc","price_changes":[)"
+                      R"({"asset_id":"pm-parser-yes","price":"0.5","size":"10","side":"BUY","best_bid":"0.5","best_ask":"0.52"},)"
+                      R"({"asset_id":"pm-parser-yes","price":"0.51","size":"5","side":"HOLD"},)"
+                      R"({"asset_id":"pm-parser-yes","price":"0.52","size":"0","side":"SELL"},)"
+                      R"({"asset_id":"pm-parser-no","price":"0.49","size":"7","side":"sell","best_bid":"0.47","best_ask":"0.49"},)"
+                      R"({"asset_id":"pm-parser-unknown","price":"0.1","size":"1","side":"BUY"}],)"
+                      R"("timestamp":"1700000000456"})";
+    PolymarketMessage out;
+    ASSERT_TRUE(parse_polymarket_message(msg, nullptr, nullptr, out));
+    EXPECT_EQ(out.kind, PolymarketMessage::Kind::PRICE_CHANGE);
+    EXPECT_TRUE(out.has_price_changes);
+    EXPECT_EQ(out.timestamp_ms, 1700000000456);
+    ASSERT_EQ(out.changes.size(), 5u);
+    EXPECT_EQ(out.changes[0].token, yes_);
+    EXPECT_TRUE(out.changes[0].has_top);
+    EXPECT_DOUBLE_EQ(out.changes[0].best_ask, 0.52);
+    EXPECT_FALSE(out.changes[1].has_level);  // Unknown side
+    EXPECT_EQ(out.changes[3].token, no_);
+    EXPECT_EQ(out.changes[4].token, NO_SYMBOL);
+
+    // The yes batch is entries [0, 3): two usable deltas
+    auto yes_levels = out.change_levels(0, 3);
+    ASSERT_EQ(yes_levels.size(), 2u);
+    EXPECT_EQ(yes_levels[1].side, Side::SELL);
+    EXPECT_DOUBLE_EQ(yes_levels[1].price, 0.52);
+    auto no_levels = out.change_levels(3, 4);
+    ASSERT_EQ(no_levels.size(), 1u);
+    EXPECT_DOUBLE_EQ(no_levels[0].size, 7.0);
+}
+
+TEST_F(PolymarketParserTest, LegacyChangesAndTrade) {
+    PolymarketMessage out;
+    ASSERT_TRUE(parse_polymarket_message(
+        R"({"event_type":"price_change","asset_id":"pm-parser-no","timestamp":1700000000001,)"
+        R"("changes":[{"price":"0.4","size":"3","side":"BUY"},{"price":"0.6","size":"0","side":"SELL"}]})",
+        nullptr, nullptr, out));
+    EXPECT_FALSE(out.has_price_changes);
+    EXPECT_EQ(out.token, no_);
+    EXPECT_EQ(out.timestamp_ms, 1700000000001);
+    ASSERT_EQ(out.levels.size(), 2u);
+    EXPECT_EQ(out.levels[1].side, Side::SELL);
+
+    ASSERT_TRUE(parse_polymarket_message(
+        R"({"event_type":"last_trade_price","asset_id":"pm-parser-yes","price":"0.456",)"
+        R"("size":"219.217767","side":"BUY","fee_rate_bps":"0","timestamp":"1700000000789"})",
+        nullptr, nullptr, out));
+    EXPECT_EQ(out.kind, PolymarketMessage::Kind::TRADE);
+    EXPECT_TRUE(out.levels.empty());  // Nothing left over from the previous message
+    EXPECT_EQ(out.asset_id, "pm-parser-yes");
+    EXPECT_DOUBLE_EQ(out.price, 0.456);
+    EXPECT_DOUBLE_EQ(out.size, 219.217767);
+    EXPECT_EQ(out.side, Side::BUY);
+    EXPECT_EQ(out.timestamp_ms, 1700000000789);
+}
+
+TEST_F(PolymarketParserTest, SkipsUnknownNestedFields) {
+    std::string msg = R"({"event_type":"book","meta":{"tags":[1,{"note":"say \"hi\""}],"x":null},)"
+                      R"("asset_id":"pm-parser-yes","bids":[{"price":"0.3","size":"1","extra":[true,false]}],"asks":[]})";
+    PolymarketMessage out;
+    ASSERT_TRUE(parse_polymarket_message(msg, nullptr, nullptr, out));
+    EXPECT_EQ(out.token, yes_);
+    ASSERT_EQ(out.levels.size(), 1u);
+    EXPECT_DOUBLE_EQ(out.levels[0].price, 0.3);
+}
+
+TEST_F(PolymarketParserTest, DeclinesWhatOnlyTheDomPathHandles) {
+    PolymarketMessage out;
+    // Escaped id, exponent, top-level array, mixed shapes, truncated frame
+    EXPECT_FALSE(parse_polymarket_message(R"({"event_type":"book","asset_id":"pm\u002dparser-yes"})", nullptr, nullptr, out));
+    EXPECT_FALSE(parse_polymarket_message(R"({"event_type":"book","bids":[{"price":"5e-1","size":"1"}]})", nullptr, nullptr, out));
+    EXPECT_FALSE(parse_polymarket_message(R"([{"event_type":"book"}])", nullptr, nullptr, out));
+    EXPECT_FALSE(parse_polymarket_message(R"({"event_type":"price_change","changes":[],"price_changes":[]})", nullptr, nullptr, out));
+    EXPECT_FALSE(parse_polymarket_message(R"({"event_type":"book","bids":[)", nullptr, nullptr, out));
+
+    ASSERT_TRUE(parse_polymarket_message_json(
+        R"({"event_type":"book","asset_id":"pm\u002dparser-yes","bids":[{"price":"5e-1","size":"1"}]})",
+        nullptr, nullptr, out));
+    EXPECT_EQ(out.token, yes_);
+    ASSERT_EQ(out.levels.size(), 1u);
+    EXPECT_DOUBLE_EQ(out.levels[0].price, 0.5);
+}
+
+TEST_F(PolymarketParserTest, RestBookBodyParsesAsBook) {
+    // GET /book has no event_type; as a WebSocket message it would be ignored
+    std::string body = R"({"market":"0xabc","asset_id":"pm-parser-no","timestamp":"1700000000999",)"
+                       R"("hash":"0x2e","bids":[{"price":"0.47","size":"12"}],)"
+                       R"("asks":[{"price":"0.53","size":"8"},{"price":"0.54","size":"4"}]})";
+    PolymarketMessage out;
+    ASSERT_TRUE(parse_polymarket_message(body, nullptr, nullptr, out));
+    EXPECT_EQ(out.kind, PolymarketMessage::Kind::NONE);
+    EXPECT_TRUE(out.levels.empty());
+
+    ASSERT_TRUE(parse_polymarket_book(body, &POLYMARKET_PRICE_SCALE, &POLYMARKET_SIZE_SCALE, out));
+    EXPECT_EQ(out.kind, PolymarketMessage::Kind::BOOK);
+    EXPECT_EQ(out.token, no_);
+    EXPECT_EQ(out.timestamp_ms, 1700000000999);
+    ASSERT_EQ(out.levels.size(), 3u);
+    EXPECT_EQ(out.levels[0].side, Side::BUY);
+    EXPECT_DOUBLE_EQ(out.levels[2].price, 0.54);
+
+    // Bodies only the DOM path accepts still parse
+    ASSERT_TRUE(parse_polymarket_book(R"({"asset_id":"pm-parser-no","bids":[{"price":"4.7e-1","size":"1"}]})",
+                                      nullptr, nullptr, out));
+    EXPECT_EQ(out.kind, PolymarketMessage::Kind::BOOK);
+    ASSERT_EQ(out.levels.size(), 1u);
+    EXPECT_DOUBLE_EQ(out.levels[0].price, 0.47);
+}
+
+TEST_F(PolymarketParserTest, FuzzMatchesNlohmannPath) {
+    std::mt19937_64 gen(20240612);
+    std::uniform_int_distribution<int> coin(0, 1);
+    std::uniform_int_distribution<int> kind(0, 3);
+    std::uniform_int_distribution<int> count(0, 12);
+    const char* tokens[] = {"\"pm-parser-yes\"", "\"pm-parser-no\"", "\"pm-parser-unregistered\""};
+    const char* sides[] = {"\"BUY\"", "\"SELL\"", "\"buy\"", "\"sell\""};
+    std::uniform_int_distribution<int> pick_token(0, 2);
+    std::uniform_int_distribution<int> pick_side(0, 3);
+    FixedScale price_scale = FixedScale::from_decimals(3);
+    FixedScale size_scale = FixedScale::from_decimals(2);
+
+    auto levels = [&](bool with_side) {
+        std::string s = "[";
+        for (int i = 0, n = count(gen); i < n; ++i) {
+            if (i > 0) s += ",";
+            std::vector<std::pair<std::string, std::string>> f = {
+                {"price", quoted(random_price(gen))}, {"size", quoted(random_size(gen))}};
+            if (with_side) f.push_back({"side", sides[pick_side(gen)]});
+            s += object(f, gen, coin(gen));
+        }
+        return s + "]";
+    };
+
+    for (int i = 0; i < 5'000; ++i) {
+        bool shuffle = coin(gen);
+        std::vector<std::pair<std::string, std::string>> fields = {
+            {"market", "\"0x5f65177b394277fd294cd75650044e32ba009a95022d88a0c1d565897d72f8f1\""},
+            {"timestamp", quoted(std::to_string(1700000000000LL + i))}};
+
+        switch (kind(gen)) {
+            case 0:
+                fields.push_back({"event_type", "\"book\""});
+                fields.push_back({"asset_id", tokens[pick_token(gen)]});
+                fields.push_back({"bids", levels(false)});
+                fields.push_back({"asks", levels(false)});
+                fields.push_back({"hash", "\"0xabc\""});
+                break;
+            case 1: {
+                fields.push_back({"event_type", "\"price_change\""});
+                std::string arr = "[";
+                for (int k = 0, n = count(gen); k < n; ++k) {
+                    if (k > 0) arr += ",";
+                    std::vector<std::pair<std::string, std::string>> f = {
+                        {"asset_id", tokens[pick_token(gen)]},
+                        {"price", quoted(random_price(gen))}, {"size", quoted(random_size(gen))},
+                        {"side", sides[pick_side(gen)]}, {"hash", "\"0x1\""}};
+                    if (coin(gen)) {
+                        f.push_back({"best_bid", quoted(random_price(gen))});
+                        f.push_back({"best_ask", quoted(random_price(gen))});
+                    }
+                    arr += object(f, gen, coin(gen));
+                }
+                fields.push_back({"price_changes", arr + "]"});
+                break;
+            }
+            case 2:
+                fields.push_back({"event_type", "\"price_change\""});
+                fields.push_back({"asset_id", tokens[pick_token(gen)]});
+                fields.push_back({"changes", levels(true)});
+                break;
+            default:
+                fields.push_back({"event_type", "\"last_trade_price\""});
+                fields.push_back({"asset_id", tokens[pick_token(gen)]});
+                fields.push_back({"price", quoted(random_price(gen))});
+                fields.push_back({"size", quoted(random_size(gen))});
+                fields.push_back({"side", sides[pick_side(gen)]});
+                fields.push_back({"fee_rate_bps", "\"0\""});
+                break;
+        }
+
+        std::string msg = object(fields, gen, shuffle);
+        if (coin(gen)) {
+            for (size_t pos = msg.find(','); pos != std::string::npos; pos = msg.find(',', pos + 3)) {
+                msg.replace(pos, 1, " , ");
+            }
+        }
+
+        bool fixed = coin(gen);
+        PolymarketMessage fast;
+        PolymarketMessage json;
+        ASSERT_TRUE(parse_polymarket_message(msg, fixed ? &price_scale : nullptr,
+                                             fixed ? &size_scale : nullptr, fast)) << msg;
+        ASSERT_TRUE(parse_polymarket_message_json(msg, fixed ? &price_scale : nullptr,
+                                                  fixed ? &size_scale : nullptr, json)) << msg;
+        expect_same(fast, json, msg);
+    }
+}
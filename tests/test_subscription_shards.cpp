@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "market_data/subscription_shards.hpp"
+
+using namespace arb;
+
+namespace {
+    using Batch = SubscriptionShards::Batch;
+
+    void add_market(SubscriptionShards& shards, int n) {
+        std::string market = "m" + std::to_string(n);
+        shards.add(market + "-yes", market);
+        shards.add(market + "-no", market);
+    }
+
+    size_t tokens_in(const std::vector<Batch>& batches, bool subscribe) {
+        size_t tokens = 0;
+        for (const auto& batch : batches) {
+            if (batch.subscribe == subscribe) tokens += batch.token_ids.size();
+        }
+        return tokens;
+    }
+}
+
+TEST(SubscriptionShardsTest, MarketsStayTogetherAndSpreadEvenly) {
+    SubscriptionShards shards(3, SubscriptionShards::Key::MARKET, 500, 2);
+    for (int n = 0; n < 6; ++n) add_market(shards, n);
+
+    std::vector<Batch> batches = shards.commit();
+    ASSERT_EQ(batches.size(), 3u);  // One subscribe per shard
+    for (size_t shard = 0; shard < 3; ++shard) {
+        EXPECT_EQ(shards.load(shard), 4u);
+    }
+    for (int n = 0; n < 6; ++n) {
+        std::string market = "m" + std::to_string(n);
+        EXPECT_EQ(shards.shard_of(market + "-yes"), shards.shard_of(market + "-no"));
+    }
+    EXPECT_TRUE(shards.commit().empty());
+}
+
+TEST(SubscriptionShardsTest, BatchesRespectTheMessageLimit) {
+    SubscriptionShards shards(1, SubscriptionShards::Key::TOKEN, 4, 0);
+    for (int n = 0; n < 5; ++n) add_market(shards, n);
+
+    std::vector<Batch> batches = shards.commit();
+    ASSERT_EQ(batches.size(), 3u);
+    EXPECT_EQ(batches[0].token_ids.size(), 4u);
+    EXPECT_EQ(batches[2].token_ids.size(), 2u);
+    EXPECT_EQ(shards.resubscribe(0).size(), 3u);
+}
+
+TEST(SubscriptionShardsTest, UncommittedChangesCancelOut) {
+    SubscriptionShards shards(2, SubscriptionShards::Key::MARKET, 500, 2);
+    add_market(shards, 0);
+    shards.remove("m0-yes");
+    shards.remove("m0-no");
+
+    EXPECT_TRUE(shards.commit().empty());
+    EXPECT_EQ(shards.token_count(), 0u);
+    EXPECT_FALSE(shards.shard_of("m0-yes").has_value());
+}
+
+TEST(SubscriptionShardsTest, RemovalsTriggerRebalance) {
+    SubscriptionShards shards(2, SubscriptionShards::Key::MARKET, 500, 2);
+    for (int n = 0; n < 8; ++n) add_market(shards, n);
+    shards.commit();
+
+    // Every market on one shard ends
+    size_t drained = *shards.shard_of("m0-yes");
+    std::vector<std::string> removed;
+    for (int n = 0; n < 8; ++n) {
+        std::string market = "m" + std::to_string(n);
+        if (shards.shard_of(market + "-yes") == drained) {
+            shards.remove(market + "-yes");
+            shards.remove(market + "-no");
+            removed.push_back(market);
+        }
+    }
+
+    std::vector<Batch> batches = shards.commit();
+    EXPECT_GT(shards.groups_moved(), 0);
+    size_t gap = shards.load(0) > shards.load(1) ? shards.load(0) - shards.load(1) : shards.load(1) - shards.load(0);
+    EXPECT_LE(gap, 2u);
+
+    // Moved tokens are subscribed on their new shard before the old one drops them
+    ASSERT_FALSE(batches.empty());
+    EXPECT_TRUE(batches.front().subscribe);
+    EXPECT_EQ(tokens_in(batches, false), removed.size() * 2 + tokens_in(batches, true));
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "common/symbol_registry.hpp"
+#include "market_data/order_book.hpp"
+#include "risk/risk_manager.hpp"
+
+using namespace arb;
+
+TEST(SymbolRegistryTest, InternIsIdempotent) {
+    auto& registry = SymbolRegistry::instance();
+
+    MarketHandle a = registry.intern_market("registry-market-a");
+    MarketHandle b = registry.intern_market("registry-market-b");
+
+    EXPECT_NE(a, NO_SYMBOL);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(registry.intern_market("registry-market-a"), a);
+    EXPECT_EQ(registry.find_market("registry-market-b"), b);
+    EXPECT_EQ(registry.market_name(a), "registry-market-a");
+}
+
+TEST(SymbolRegistryTest, UnknownAndEmptyIds) {
+    auto& registry = SymbolRegistry::instance();
+
+    EXPECT_EQ(registry.find_token("registry-never-interned"), NO_SYMBOL);
+    EXPECT_EQ(registry.intern_token(""), NO_SYMBOL);
+    EXPECT_TRUE(registry.token_name(NO_SYMBOL).empty());
+}
+
+TEST(SymbolRegistryTest, MarketsAndTokensAreSeparateNamespaces) {
+    auto& registry = SymbolRegistry::instance();
+
+    MarketHandle market = registry.intern_market("registry-shared-id");
+    EXPECT_EQ(registry.find_token("registry-shared-id"), NO_SYMBOL);
+
+    TokenHandle token = registry.intern_token("registry-shared-id");
+    EXPECT_EQ(registry.token_name(token), "registry-shared-id");
+    EXPECT_EQ(registry.market_name(market), "registry-shared-id");
+}
+
+TEST(SymbolRegistryTest, BinaryBookCarriesTokenHandles) {
+    auto& registry = SymbolRegistry::instance();
+    BinaryMarketBook book("registry-book-market");
+
+    EXPECT_EQ(book.market_handle(), registry.find_market("registry-book-market"));
+
+    // Unregistered legs fall back to the book symbols
+    EXPECT_EQ(book.yes_token(), NO_SYMBOL);
+    EXPECT_EQ(book.yes_token_id(), book.yes_book().symbol());
+
+    TokenHandle yes = registry.intern_token("registry-book-yes");
+    TokenHandle no = registry.intern_token("registry-book-no");
+    book.set_tokens(yes, no);
+
+    EXPECT_EQ(book.yes_token(), yes);
+    EXPECT_EQ(book.yes_token_id(), "registry-book-yes");
+    EXPECT_EQ(book.no_token_id(), "registry-book-no");
+}
+
+TEST(SymbolRegistryTest, RiskExposureKeyedByHandle) {
+    RiskConfig config;
+    config.max_exposure_per_market = 3.0;
+    RiskManager risk(config, 50.0);
+
+    Fill fill;
+    fill.market_id = "registry-risk-market";
+    fill.side = Side::BUY;
+    fill.price = 0.50;
+    fill.size = 8.0;
+    risk.record_fill(fill);
+
+    MarketHandle market = SymbolRegistry::instance().find_market("registry-risk-market");
+    EXPECT_NEAR(risk.exposure_for_market(market), 4.0, 1e-9);
+    EXPECT_NEAR(risk.exposure_for_market("registry-risk-market"), 4.0, 1e-9);
+    EXPECT_FALSE(risk.check_position_limit(market).allowed);
+}
@@ -163,3 +163,44 @@ TEST_F(UnderpricingStrategyTest, SignalSizeMatchesAvailableLiquidity) {
         EXPECT_LE(signals[1].target_size, 5.0);
     }
 }
+
+TEST_F(UnderpricingStrategyTest, SignalSize_SweepsDeeperProfitableLevels) {
+    // Pairs: (0.40, 0.45) edge ~12c for 5, (0.45, 0.45) edge ~6.9c for 10,
+    // then (0.55, 0.45) sums to 1.00 and stops the walk
+    std::vector<PriceLevel> yes_bids = {{0.38, 10.0}};
+    std::vector<PriceLevel> yes_asks = {{0.40, 5.0}, {0.45, 10.0}, {0.55, 10.0}};
+    std::vector<PriceLevel> no_bids = {{0.43, 10.0}};
+    std::vector<PriceLevel> no_asks = {{0.45, 20.0}, {0.50, 20.0}};
+
+    book_->yes_book().apply_snapshot(yes_bids, yes_asks);
+    book_->no_book().apply_snapshot(no_bids, no_asks);
+
+    auto signals = strategy_->evaluate(*book_, btc_price_, now());
+
+    ASSERT_EQ(signals.size(), 2);
+    EXPECT_DOUBLE_EQ(signals[0].target_size, 15.0);
+    EXPECT_DOUBLE_EQ(signals[1].target_size, 15.0);
+    EXPECT_DOUBLE_EQ(signals[0].target_price, 0.45);  // Limit reaches the second YES level
+    EXPECT_DOUBLE_EQ(signals[1].target_price, 0.45);
+    EXPECT_GE(signals[0].expected_edge, config_.min_edge_cents);
+}
+
+TEST_F(UnderpricingStrategyTest, Prefilter_ScreensMarketTableByEdge) {
+    MarketTable table;
+    TopOfBook yes, no;
+    yes.best_ask = PriceLevel{0.40, 10.0};
+    no.best_ask = PriceLevel{0.45, 10.0};
+    table.update(book_->market_handle(), true, yes);
+    table.update(book_->market_handle(), false, no);
+
+    std::vector<MarketHandle> candidates;
+    ASSERT_TRUE(strategy_->prefilter(table, candidates));
+    EXPECT_EQ(candidates, (std::vector<MarketHandle>{book_->market_handle()}));
+
+    // Same screen the strategy applies: fair prices never reach evaluate()
+    no.best_ask = PriceLevel{0.61, 10.0};
+    table.update(book_->market_handle(), false, no);
+    candidates.clear();
+    strategy_->prefilter(table, candidates);
+    EXPECT_TRUE(candidates.empty());
+}
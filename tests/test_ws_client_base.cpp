@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "market_data/ws_client_base.hpp"
+
+using namespace std::chrono_literals;
+
+namespace arb {
+
+// Two redundant connections on one shard; nothing listens, so status changes
+// and messages are fed in the way the connections would report them
+class WebSocketClientBaseTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        client_.set_status_callback([this](ConnectionStatus s) { statuses_.push_back(s); });
+        client_.set_feed_gap_callback([this](Duration gap) { gaps_.push_back(gap); });
+        client_.wanted_ = true;  // As after connect()
+    }
+
+    void path_status(size_t path, ConnectionStatus s) { client_.on_path_status(path, s); }
+    void message(size_t path, const std::string& msg, Timestamp recv_time) {
+        client_.dispatch(path, msg, recv_time);
+    }
+
+    WebSocketClientBase client_{"wss://127.0.0.1:9/ws", "test", 2};
+    std::vector<ConnectionStatus> statuses_;
+    std::vector<Duration> gaps_;
+};
+
+TEST_F(WebSocketClientBaseTest, StaysConnectedWhileOnePathIsUp) {
+    path_status(0, ConnectionStatus::CONNECTED);
+    path_status(1, ConnectionStatus::CONNECTED);
+    EXPECT_EQ(client_.status(), ConnectionStatus::CONNECTED);
+
+    path_status(0, ConnectionStatus::RECONNECTING);
+    EXPECT_EQ(client_.status(), ConnectionStatus::CONNECTED);
+    message(1, R"({"u":1})", now());
+    path_status(0, ConnectionStatus::CONNECTED);
+
+    EXPECT_EQ(statuses_, std::vector<ConnectionStatus>{ConnectionStatus::CONNECTED});
+    EXPECT_EQ(client_.feed_gaps(), 0);
+    EXPECT_EQ(client_.messages_received(), 1);
+}
+
+TEST_F(WebSocketClientBaseTest, GapCountsOnlyWhenBothPathsDropAndEndsOnFirstMessage) {
+    path_status(0, ConnectionStatus::CONNECTED);
+    path_status(1, ConnectionStatus::CONNECTED);
+
+    Timestamp before = now();
+    path_status(0, ConnectionStatus::RECONNECTING);
+    path_status(1, ConnectionStatus::RECONNECTING);
+    EXPECT_EQ(client_.status(), ConnectionStatus::RECONNECTING);
+
+    // Reconnected, but the gap lasts until data flows again
+    path_status(1, ConnectionStatus::CONNECTED);
+    EXPECT_EQ(client_.status(), ConnectionStatus::CONNECTED);
+    EXPECT_EQ(client_.feed_gaps(), 0);
+    EXPECT_TRUE(gaps_.empty());
+
+    Timestamp resumed = now() + 5ms;
+    message(1, R"({"u":2})", resumed);
+    ASSERT_EQ(client_.feed_gaps(), 1);
+    ASSERT_EQ(gaps_.size(), 1u);
+    EXPECT_GE(gaps_[0], 5ms);
+    EXPECT_LE(gaps_[0], resumed - before);
+    EXPECT_EQ(client_.last_feed_gap_us(), std::chrono::duration_cast<std::chrono::microseconds>(gaps_[0]).count());
+    EXPECT_EQ(client_.shard_stats(0).feed_gaps, 1);
+
+    // Later messages are not gaps
+    message(0, R"({"u":3})", resumed + 1ms);
+    EXPECT_EQ(client_.feed_gaps(), 1);
+    EXPECT_EQ(client_.messages_received(), 2);
+}
+
+} // namespace arb
@@ -0,0 +1,309 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "market_data/ws_frame_decoder.hpp"
+#include "market_data/ws_frame_encoder.hpp"
+
+using namespace arb;
+
+namespace {
+
+// Server-style frame; masked when key is non-null
+std::string make_frame(const std::string& payload, uint8_t opcode = 0x01, bool fin = true,
+                       const uint8_t* key = nullptr) {
+    std::string frame;
+    frame += static_cast<char>((fin ? 0x80 : 0x00) | opcode);
+    uint8_t mask_bit = key ? 0x80 : 0x00;
+    size_t len = payload.size();
+    if (len < 126) {
+        frame += static_cast<char>(mask_bit | len);
+    } else if (len < 65536) {
+        frame += static_cast<char>(mask_bit | 126);
+        frame += static_cast<char>((len >> 8) & 0xFF);
+        frame += static_cast<char>(len & 0xFF);
+    } else {
+        frame += static_cast<char>(mask_bit | 127);
+        for (int i = 7; i >= 0; i--) {
+            frame += static_cast<char>((len >> (8 * i)) & 0xFF);
+        }
+    }
+    if (key) {
+        frame.append(reinterpret_cast<const char*>(key), 4);
+        for (size_t i = 0; i < len; i++) {
+            frame += static_cast<char>(payload[i] ^ key[i % 4]);
+        }
+    } else {
+        frame += payload;
+    }
+    return frame;
+}
+
+}
+
+TEST(WsFrameDecoderTest, DecodesEveryBufferedFrame) {
+    WsFrameDecoder decoder;
+    decoder.append(make_frame("first") + make_frame("second") + make_frame("", 0x09));
+
+    WsFrame frame;
+    ASSERT_EQ(decoder.next(frame), WsFrameDecoder::Result::FRAME);
+    EXPECT_EQ(frame.payload, "first");
+    EXPECT_EQ(frame.opcode, 0x01);
+    EXPECT_TRUE(frame.fin);
+    ASSERT_EQ(decoder.next(frame), WsFrameDecoder::Result::FRAME);
+    EXPECT_EQ(frame.payload, "second");
+    ASSERT_EQ(decoder.next(frame), WsFrameDecoder::Result::FRAME);
+    EXPECT_EQ(frame.opcode, 0x09);
+    EXPECT_TRUE(frame.payload.empty());
+    EXPECT_EQ(decoder.next(frame), WsFrameDecoder::Result::NEED_MORE);
+    EXPECT_EQ(decoder.buffered(), 0u);
+}
+
+TEST(WsFrameDecoderTest, WaitsForPartialHeaderAndPayload) {
+    WsFrameDecoder decoder;
+    std::string payload(300, 'x');  // 16-bit extended length
+    std::string wire = make_frame(payload);
+
+    WsFrame frame;
+    decoder.append(wire.substr(0, 1));
+    EXPECT_EQ(decoder.next(frame), WsFrameDecoder::Result::NEED_MORE);
+    decoder.append(wire.substr(1, 2));
+    EXPECT_EQ(decoder.next(frame), WsFrameDecoder::Result::NEED_MORE);
+    decoder.append(wire.substr(3, 100));
+    EXPECT_EQ(decoder.next(frame), WsFrameDecoder::Result::NEED_MORE);
+    decoder.append(wire.substr(103));
+    ASSERT_EQ(decoder.next(frame), WsFrameDecoder::Result::FRAME);
+    EXPECT_EQ(frame.payload, payload);
+}
+
+TEST(WsFrameDecoderTest, UnmasksMaskedPayload) {
+    const uint8_t key[4] = {0x12, 0x34, 0x56, 0x78};
+    WsFrameDecoder decoder;
+    decoder.append(make_frame("{\"b\":\"42000.00\"}", 0x01, true, key));
+
+    WsFrame frame;
+    ASSERT_EQ(decoder.next(frame), WsFrameDecoder::Result::FRAME);
+    EXPECT_EQ(frame.payload, "{\"b\":\"42000.00\"}");
+}
+
+TEST(WsFrameDecoderTest, CopiesOnlyFramesThatStraddleTheWrap) {
+    WsFrameDecoder decoder(64);
+    ASSERT_EQ(decoder.capacity(), 64u);
+
+    WsFrame frame;
+    // Fully consumed: the ring rewinds to the front
+    decoder.append(make_frame(std::string(40, 'a')));
+    ASSERT_EQ(decoder.next(frame), WsFrameDecoder::Result::FRAME);
+    decoder.append(make_frame(std::string(10, 'b')));
+    decoder.append(make_frame(std::string(30, 'c')));
+
+    // b occupies [0, 12), c [12, 44)
+    ASSERT_EQ(decoder.next(frame), WsFrameDecoder::Result::FRAME);
+    EXPECT_EQ(frame.payload, std::string(10, 'b'));
+    EXPECT_EQ(decoder.wrapped_frames(), 0);
+
+    // Fill the tail so the next frame's payload crosses the end of the ring
+    decoder.append(make_frame(std::string(30, 'd')));
+    ASSERT_EQ(decoder.next(frame), WsFrameDecoder::Result::FRAME);
+    EXPECT_EQ(frame.payload, std::string(30, 'c'));
+    ASSERT_EQ(decoder.next(frame), WsFrameDecoder::Result::FRAME);
+    EXPECT_EQ(frame.payload, std::string(30, 'd'));
+    EXPECT_EQ(decoder.wrapped_frames(), 1);
+    EXPECT_EQ(decoder.capacity(), 64u);
+}
+
+TEST(WsFrameDecoderTest, GrowsForFramesLargerThanTheRing) {
+    WsFrameDecoder decoder(64);
+    std::string payload(70000, 'z');  // 64-bit extended length
+    std::string wire = make_frame(payload);
+
+    WsFrame frame;
+    size_t offset = 0;
+    WsFrameDecoder::Result result = WsFrameDecoder::Result::NEED_MORE;
+    while (result == WsFrameDecoder::Result::NEED_MORE && offset < wire.size()) {
+        WsFrameDecoder::Space space = decoder.write_space();
+        size_t n = std::min(space.size, wire.size() - offset);
+        std::copy_n(wire.data() + offset, n, space.data);
+        decoder.commit(n);
+        offset += n;
+        result = decoder.next(frame);
+    }
+    ASSERT_EQ(result, WsFrameDecoder::Result::FRAME);
+    EXPECT_EQ(frame.payload.size(), payload.size());
+    EXPECT_EQ(frame.payload, payload);
+    EXPECT_GE(decoder.capacity(), wire.size());
+}
+
+TEST(WsFrameDecoderTest, RejectsOversizedFrames) {
+    WsFrameDecoder decoder(64, 100);
+    decoder.append(make_frame(std::string(200, 'x')));
+
+    WsFrame frame;
+    EXPECT_EQ(decoder.next(frame), WsFrameDecoder::Result::ERROR);
+    EXPECT_EQ(decoder.error(), "frame too large: 200");
+    EXPECT_EQ(decoder.next(frame), WsFrameDecoder::Result::ERROR);
+
+    decoder.clear();
+    decoder.append(make_frame("ok"));
+    ASSERT_EQ(decoder.next(frame), WsFrameDecoder::Result::FRAME);
+    EXPECT_EQ(frame.payload, "ok");
+}
+
+TEST(WsFrameEncoderTest, MasksWordAtATimeLikeBytewise) {
+    const uint8_t key[4] = {0xA1, 0x02, 0xFF, 0x5C};
+    std::string src;
+    for (int i = 0; i < 77; i++) src += static_cast<char>(i * 7);
+
+    std::string dst(src.size(), '\0');
+    ws_mask(src.data(), dst.data(), src.size(), key);
+    for (size_t i = 0; i < src.size(); i++) {
+        ASSERT_EQ(static_cast<uint8_t>(dst[i]), static_cast<uint8_t>(src[i] ^ key[i % 4])) << i;
+    }
+
+    // In place, and masking twice restores the input
+    ws_mask(dst.data(), dst.data(), dst.size(), key);
+    EXPECT_EQ(dst, src);
+}
+
+TEST(WsFrameEncoderTest, RoundTripsThroughDecoder) {
+    WsFrameEncoder encoder(42);
+    std::string wire;
+    wire.reserve(128 * 1024);
+    encoder.encode("{\"type\":\"subscribe\"}", 0x01, wire);
+    encoder.encode(std::string(300, 'm'), 0x01, wire);
+    encoder.encode(std::string(70000, 'L'), 0x02, wire);
+    encoder.encode("", 0x0A, wire);
+
+    // Client frames always carry the mask bit
+    EXPECT_EQ(static_cast<uint8_t>(wire[1]) & 0x80, 0x80);
+
+    WsFrameDecoder decoder;
+    decoder.append(wire);
+    WsFrame frame;
+    ASSERT_EQ(decoder.next(frame), WsFrameDecoder::Result::FRAME);
+    EXPECT_EQ(frame.payload, "{\"type\":\"subscribe\"}");
+    ASSERT_EQ(decoder.next(frame), WsFrameDecoder::Result::FRAME);
+    EXPECT_EQ(frame.payload, std::string(300, 'm'));
+    ASSERT_EQ(decoder.next(frame), WsFrameDecoder::Result::FRAME);
+    EXPECT_EQ(frame.opcode, 0x02);
+    EXPECT_EQ(frame.payload, std::string(70000, 'L'));
+    ASSERT_EQ(decoder.next(frame), WsFrameDecoder::Result::FRAME);
+    EXPECT_EQ(frame.opcode, 0x0A);
+    EXPECT_TRUE(frame.payload.empty());
+    EXPECT_EQ(decoder.next(frame), WsFrameDecoder::Result::NEED_MORE);
+}
+
+TEST(WsFrameEncoderTest, MaskKeysVaryPerFrame) {
+    WsFrameEncoder encoder(7);
+    uint32_t first = encoder.next_mask_key();
+    uint32_t second = encoder.next_mask_key();
+    EXPECT_NE(first, second);
+
+    // Same seed, same stream
+    WsFrameEncoder replay(7);
+    EXPECT_EQ(replay.next_mask_key(), first);
+}
+
+namespace {
+
+std::string close_payload(uint16_t code, const std::string& reason = "") {
+    std::string payload;
+    payload += static_cast<char>(code >> 8);
+    payload += static_cast<char>(code & 0xFF);
+    return payload + reason;
+}
+
+// Runs wire bytes through a decoder and an assembler, one action per frame
+class WsMessageAssemblerTest : public ::testing::Test {
+protected:
+    using Action = WsMessageAssembler::Action;
+
+    std::vector<Action> feed(const std::string& wire) {
+        decoder_.append(wire);
+        std::vector<Action> actions;
+        WsFrame frame;
+        while (decoder_.next(frame) == WsFrameDecoder::Result::FRAME) {
+            Action action = messages_.on_frame(frame);
+            actions.push_back(action);
+            if (action != Action::NONE) payloads_.emplace_back(messages_.payload());
+        }
+        return actions;
+    }
+
+    WsFrameDecoder decoder_{64};
+    WsMessageAssembler messages_{32};
+    std::vector<std::string> payloads_;
+};
+
+}
+
+TEST_F(WsMessageAssemblerTest, ReassemblesFragmentsAroundInterleavedPings) {
+    auto actions = feed(make_frame("{\"a\":", 0x01, false) + make_frame("p1", 0x09) +
+                        make_frame("1,", 0x00, false) + make_frame("", 0x0A) +
+                        make_frame("\"b\":2}", 0x00, true));
+    EXPECT_EQ(actions, (std::vector<Action>{Action::NONE, Action::PING, Action::NONE, Action::NONE,
+                                            Action::MESSAGE}));
+    EXPECT_EQ(payloads_, (std::vector<std::string>{"p1", "{\"a\":1,\"b\":2}"}));
+    EXPECT_TRUE(messages_.fragmented());
+
+    // The next message starts clean
+    EXPECT_EQ(feed(make_frame("solo")), std::vector<Action>{Action::MESSAGE});
+    EXPECT_EQ(messages_.payload(), "solo");
+    EXPECT_FALSE(messages_.fragmented());
+}
+
+TEST_F(WsMessageAssemblerTest, BadOpcodesAndFramingCloseWith1002) {
+    const std::vector<std::string> violations = {
+        make_frame("x", 0x03),                                  // Reserved data opcode
+        make_frame("x", 0x0B),                                  // Reserved control opcode
+        make_frame("x", 0x00),                                  // Continuation with nothing open
+        make_frame("a", 0x01, false) + make_frame("b", 0x01),  // New message mid-fragment
+        make_frame("p", 0x09, false),                           // Fragmented ping
+        make_frame(std::string(126, 'p'), 0x09),                // Control payload over 125
+        make_frame("x", 0x08),                                  // One-byte close payload
+        make_frame("x", 0x40 | 0x01),                           // RSV1 on a text frame
+        make_frame("p", 0x20 | 0x09),                           // RSV2 on a ping
+        make_frame("a", 0x01, false) + make_frame("b", 0x10),  // RSV3 on a continuation
+    };
+    for (const auto& wire : violations) {
+        WsFrameDecoder decoder(256);
+        WsMessageAssembler messages;
+        decoder.append(wire);
+        WsFrame frame;
+        WsMessageAssembler::Action last = Action::NONE;
+        while (decoder.next(frame) == WsFrameDecoder::Result::FRAME) last = messages.on_frame(frame);
+        EXPECT_EQ(last, Action::ERROR) << messages.error();
+        EXPECT_EQ(messages.close_code(), WS_CLOSE_PROTOCOL_ERROR) << messages.error();
+    }
+}
+
+TEST_F(WsMessageAssemblerTest, OversizedMessagesCloseWith1009) {
+    // Each fragment fits; the message does not
+    auto actions = feed(make_frame(std::string(20, 'a'), 0x01, false) +
+                        make_frame(std::string(20, 'b'), 0x00, true));
+    EXPECT_EQ(actions, (std::vector<Action>{Action::NONE, Action::ERROR}));
+    EXPECT_EQ(messages_.close_code(), WS_CLOSE_TOO_BIG);
+
+    messages_.clear();
+    EXPECT_EQ(feed(make_frame(std::string(40, 'c'))), std::vector<Action>{Action::ERROR});
+    EXPECT_EQ(messages_.close_code(), WS_CLOSE_TOO_BIG);
+}
+
+TEST_F(WsMessageAssemblerTest, CloseEchoesValidCodesOnly) {
+    EXPECT_EQ(feed(make_frame(close_payload(1001, "going away"), 0x08)), std::vector<Action>{Action::CLOSE});
+    EXPECT_EQ(messages_.close_code(), 1001);
+    EXPECT_EQ(messages_.payload(), "going away");
+
+    EXPECT_EQ(feed(make_frame("", 0x08)), std::vector<Action>{Action::CLOSE});
+    EXPECT_EQ(messages_.close_code(), 0);  // Empty close, empty reply
+
+    for (uint16_t code : {1000, 1003, 1007, 1011, 3000, 4999}) {
+        feed(make_frame(close_payload(code), 0x08));
+        EXPECT_EQ(messages_.close_code(), code);
+    }
+    // Reserved for local use, unassigned, or out of range: answered with 1002
+    for (uint16_t code : {0, 999, 1004, 1005, 1006, 1015, 1016, 2000, 2999, 5000}) {
+        feed(make_frame(close_payload(code), 0x08));
+        EXPECT_EQ(messages_.close_code(), WS_CLOSE_PROTOCOL_ERROR) << code;
+    }
+}